@@ -1,5 +1,8 @@
 #include "AIActionParser.h"
 #include "Engine/Engine.h"
+#include "AIRequestTrace.h"
+#include "AIDMLog.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
 UAIActionParser::UAIActionParser()
 {
@@ -20,35 +23,31 @@ void UAIActionParser::PostInitProperties()
     {
         InitializeActionKeywords();
         
-        UE_LOG(LogTemp, Log, TEXT("AI Action Parser initialized"));
+        UE_LOG(LogAIDM, Log, TEXT("AI Action Parser initialized"));
         
-        if (bDebugMode && GEngine)
+        if (bDebugMode)
         {
-            GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, TEXT("AI Action Parser Ready"));
+            AIDM_SCREEN_MESSAGE(5.0f, FColor::Green, TEXT("AI Action Parser Ready"));
         }
     }
 }
 
 TArray<FParsedAction> UAIActionParser::ParseAIResponse(const FString& AIResponse)
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_ParseAIResponse, AIDMChannel);
+
     TArray<FParsedAction> ParsedActions;
     
     if (AIResponse.IsEmpty())
     {
-        if (bDebugMode)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("빈 AI 응답"));
-        }
+        UE_LOG(LogAIDM, Warning, TEXT("빈 AI 응답"));
         return ParsedActions;
     }
     
     // AI 응답에서 명령어들 추출
     TArray<FString> Commands = ExtractCommands(AIResponse);
     
-    if (bDebugMode)
-    {
-        UE_LOG(LogTemp, Log, TEXT("AI 응답에서 %d개의 명령어 추출"), Commands.Num());
-    }
+    AIDM_EVENT(Verbose, "CommandsExtracted", AIDM_FIELD("count", Commands.Num()));
     
     // 각 명령어 파싱
     for (const FString& Command : Commands)
@@ -65,11 +64,8 @@ TArray<FParsedAction> UAIActionParser::ParseAIResponse(const FString& AIResponse
         // 이벤트 브로드캐스트
         OnActionParsed.Broadcast(Action);
         
-        if (bDebugMode)
-        {
-            UE_LOG(LogTemp, Log, TEXT("파싱된 액션 - 타입: %s, 명령어: %s, 대상: %s"), 
-                *UEnum::GetValueAsString(Action.ActionType), *Action.Command, *Action.Target);
-        }
+        AIDM_EVENT(Verbose, "ActionParsed", AIDM_FIELD("type", UEnum::GetValueAsString(Action.ActionType)),
+            AIDM_FIELD("command", Action.Command), AIDM_FIELD("target", Action.Target));
     }
     
     return ParsedActions;
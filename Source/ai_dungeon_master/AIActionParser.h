@@ -104,7 +104,7 @@ private:
     // 명령어 추출을 위한 정규식 패턴들
     TArray<FString> CommandPatterns;
     
-    // 디버그 모드
+    // 디버그 모드 (화면 메시지, 로그는 LogAIDM 상세도로 조절)
     UPROPERTY(EditAnywhere, Category = "Debug")
-    bool bDebugMode = true;
+    bool bDebugMode = false;
 };
\ No newline at end of file
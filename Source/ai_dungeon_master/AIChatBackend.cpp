@@ -0,0 +1,293 @@
+#include "AIChatBackend.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+namespace AIChatBackendPrivate
+{
+    // 스트리밍 요청 하나의 상태 (HTTP 스레드에서 쓰고 게임 스레드에서 읽음)
+    struct FStreamState
+    {
+        FCriticalSection Critical;
+        TArray<uint8> PendingBytes;     // 아직 줄바꿈이 오지 않은 바이트
+        FString Content;
+        TArray<FAIChatChunk> Chunks;
+        FString FinishReason;
+    };
+
+    static float MsSince(uint64 StartCycles)
+    {
+        return static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+    }
+}
+
+FAIOpenAIBackend::FAIOpenAIBackend(const FString& InURL)
+    : URL(InURL)
+{
+}
+
+void FAIOpenAIBackend::SetEndpoint(const FString& InURL, float InTimeoutSeconds)
+{
+    // 다른 호스트면 기존 연결은 쓸 수 없음
+    if (InURL != URL)
+    {
+        LastActivityTime = 0.0;
+    }
+    URL = InURL;
+    TimeoutSeconds = InTimeoutSeconds;
+}
+
+bool FAIOpenAIBackend::IsConnectionWarm() const
+{
+    return LastActivityTime > 0.0 && FPlatformTime::Seconds() - LastActivityTime < AssumedIdleTimeoutSeconds;
+}
+
+void FAIOpenAIBackend::WarmConnection(float InKeepAliveInterval)
+{
+    KeepAliveInterval = InKeepAliveInterval;
+    LastRequestTime = FPlatformTime::Seconds();
+
+    if (!IsConnectionWarm() && !bPingInFlight)
+    {
+        SendPing(true);
+    }
+
+    if (KeepAliveInterval > 0.0f && !KeepAliveHandle.IsValid())
+    {
+        KeepAliveHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FAIOpenAIBackend::TickKeepAlive), KeepAliveInterval);
+    }
+}
+
+bool FAIOpenAIBackend::TickKeepAlive(float DeltaTime)
+{
+    if (KeepAliveInterval <= 0.0f)
+    {
+        KeepAliveHandle.Reset();
+        return false;
+    }
+
+    // 요청 중이면 연결이 쓰이고 있고, 오래 쉬는 중이면 유지할 이유가 없음
+    const double Now = FPlatformTime::Seconds();
+    if (InFlightCount == 0 && !bPingInFlight && Now - LastActivityTime >= KeepAliveInterval && Now - LastRequestTime < KeepAliveMaxIdleSeconds)
+    {
+        SendPing(false);
+    }
+    return true;
+}
+
+void FAIOpenAIBackend::SendPing(bool bPrewarm)
+{
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+    HttpRequest->SetURL(URL);
+    HttpRequest->SetVerb(TEXT("HEAD"));
+    HttpRequest->SetTimeout(10.0f);
+
+    bPingInFlight = true;
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    TWeakPtr<FAIOpenAIBackend> WeakThis = AsShared();
+    HttpRequest->OnProcessRequestComplete().BindLambda([WeakThis, bPrewarm, StartCycles](FHttpRequestPtr, FHttpResponsePtr Response, bool bSuccess)
+    {
+        TSharedPtr<FAIOpenAIBackend> This = WeakThis.Pin();
+        if (!This)
+        {
+            return;
+        }
+
+        This->bPingInFlight = false;
+
+        // 상태 코드와 관계없이 응답이 오면 연결은 열려 있음 (HEAD는 405여도 됨)
+        if (bSuccess && Response.IsValid())
+        {
+            This->LastActivityTime = FPlatformTime::Seconds();
+            (bPrewarm ? This->Stats.Prewarms : This->Stats.KeepAlivePings)++;
+            (bPrewarm ? This->Stats.PrewarmPingMsSum : This->Stats.KeepAlivePingMsSum) += AIChatBackendPrivate::MsSince(StartCycles);
+        }
+    });
+
+    HttpRequest->ProcessRequest();
+}
+
+void FAIOpenAIBackend::SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete)
+{
+    using namespace AIChatBackendPrivate;
+
+    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+    HttpRequest->SetURL(URL);
+    HttpRequest->SetVerb(TEXT("POST"));
+    HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+    HttpRequest->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *APIKey));
+    HttpRequest->SetContentAsString(Request.Body);
+    if (TimeoutSeconds > 0.0f)
+    {
+        HttpRequest->SetTimeout(TimeoutSeconds);
+    }
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    // 연결 유지 지표 (유휴 창 안/밖으로 첫 바이트 시간을 나눠 관찰)
+    const bool bWarm = IsConnectionWarm();
+    Stats.Requests++;
+    if (bWarm)
+    {
+        Stats.IdleWindowRequests++;
+    }
+    LastRequestTime = FPlatformTime::Seconds();
+    InFlightCount++;
+
+    TSharedRef<float> FirstByteMs = MakeShared<float>(-1.0f);
+    HttpRequest->OnHeaderReceived().BindLambda([FirstByteMs, StartCycles](FHttpRequestPtr, const FString&, const FString&)
+    {
+        if (*FirstByteMs < 0.0f)
+        {
+            *FirstByteMs = MsSince(StartCycles);
+        }
+    });
+
+    // 스트리밍: SSE 줄 단위로 delta를 모아 게임 스레드로 전달
+    TSharedPtr<FStreamState, ESPMode::ThreadSafe> Stream;
+    if (Request.bStream)
+    {
+        Stream = MakeShared<FStreamState, ESPMode::ThreadSafe>();
+        HttpRequest->SetResponseBodyReceiveStreamDelegateV2(FHttpRequestStreamDelegateV2::CreateLambda(
+            [Stream, StartCycles, OnChunk](void* Ptr, int64& Length)
+        {
+            TArray<FString> Deltas;
+            {
+                FScopeLock Lock(&Stream->Critical);
+                Stream->PendingBytes.Append(static_cast<const uint8*>(Ptr), static_cast<int32>(Length));
+
+                int32 LineStart = 0;
+                for (int32 i = 0; i < Stream->PendingBytes.Num(); i++)
+                {
+                    if (Stream->PendingBytes[i] != '\n')
+                    {
+                        continue;
+                    }
+
+                    FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Stream->PendingBytes.GetData() + LineStart), i - LineStart);
+                    const FString Line = FString(Converted.Length(), Converted.Get()).TrimStartAndEnd();
+                    LineStart = i + 1;
+
+                    FString Delta;
+                    if (ParseStreamLine(Line, Delta, &Stream->FinishReason) && !Delta.IsEmpty())
+                    {
+                        Stream->Content += Delta;
+                        Stream->Chunks.Add({ MsSince(StartCycles), Delta });
+                        Deltas.Add(MoveTemp(Delta));
+                    }
+                }
+                Stream->PendingBytes.RemoveAt(0, LineStart, EAllowShrinking::No);
+            }
+
+            if (Deltas.Num() > 0 && OnChunk.IsBound())
+            {
+                AsyncTask(ENamedThreads::GameThread, [OnChunk, Deltas = MoveTemp(Deltas)]()
+                {
+                    for (const FString& Delta : Deltas)
+                    {
+                        OnChunk.ExecuteIfBound(Delta);
+                    }
+                });
+            }
+        }));
+    }
+
+    if (Request.Cancellation)
+    {
+        TWeakPtr<IHttpRequest, ESPMode::ThreadSafe> WeakHttpRequest = HttpRequest;
+        Request.Cancellation->OnCancel = [WeakHttpRequest]()
+        {
+            if (TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> PinnedRequest = WeakHttpRequest.Pin())
+            {
+                PinnedRequest->CancelRequest();
+            }
+        };
+    }
+
+    TWeakPtr<FAIOpenAIBackend> WeakThis = AsShared();
+    HttpRequest->OnProcessRequestComplete().BindLambda(
+        [Stream, StartCycles, OnComplete, WeakThis, bWarm, FirstByteMs](FHttpRequestPtr, FHttpResponsePtr Response, bool bSuccess)
+    {
+        if (TSharedPtr<FAIOpenAIBackend> This = WeakThis.Pin())
+        {
+            This->InFlightCount--;
+            if (bSuccess && Response.IsValid())
+            {
+                This->LastActivityTime = FPlatformTime::Seconds();
+                if (*FirstByteMs >= 0.0f)
+                {
+                    (bWarm ? This->Stats.WarmFirstByteMsSum : This->Stats.ColdFirstByteMsSum) += *FirstByteMs;
+                    (bWarm ? This->Stats.WarmSamples : This->Stats.ColdSamples)++;
+                }
+            }
+        }
+
+        FAIChatResult Result;
+        Result.bSuccess = bSuccess && Response.IsValid();
+        Result.ResponseCode = Response.IsValid() ? Response->GetResponseCode() : 0;
+        Result.TotalMs = MsSince(StartCycles);
+
+        if (Stream)
+        {
+            FScopeLock Lock(&Stream->Critical);
+            Result.Content = Stream->Content;
+            Result.Chunks = Stream->Chunks;
+            Result.FinishReason = Stream->FinishReason;
+            Result.bHasContent = Result.ResponseCode == 200;
+        }
+        else if (Response.IsValid())
+        {
+            Result.ResponseBody = Response->GetContentAsString();
+        }
+
+        OnComplete.ExecuteIfBound(Result);
+    });
+
+    HttpRequest->ProcessRequest();
+}
+
+bool FAIOpenAIBackend::ParseStreamLine(const FString& Line, FString& OutDelta, FString* OutFinishReason)
+{
+    OutDelta.Reset();
+
+    if (!Line.StartsWith(TEXT("data:")))
+    {
+        return false;
+    }
+
+    const FString Data = Line.Mid(5).TrimStartAndEnd();
+    if (Data == TEXT("[DONE]"))
+    {
+        return false;
+    }
+
+    TSharedPtr<FJsonObject> JsonObject;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Data);
+    if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+    {
+        return false;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Choices;
+    if (JsonObject->TryGetArrayField(TEXT("choices"), Choices) && Choices->Num() > 0)
+    {
+        const TSharedPtr<FJsonObject> Choice = (*Choices)[0]->AsObject();
+        const TSharedPtr<FJsonObject>* Delta;
+        if (Choice->TryGetObjectField(TEXT("delta"), Delta))
+        {
+            (*Delta)->TryGetStringField(TEXT("content"), OutDelta);
+        }
+
+        // 마지막 조각에만 들어 있음 (나머지는 null)
+        FString FinishReason;
+        if (OutFinishReason && Choice->TryGetStringField(TEXT("finish_reason"), FinishReason))
+        {
+            *OutFinishReason = FinishReason;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+// 스트리밍 응답 조각 (요청 전송 시점 기준 도착 시각)
+struct FAIChatChunk
+{
+    float OffsetMs = 0.0f;
+    FString Text;
+};
+
+// 요청 취소 (게임 스레드 전용, 백엔드가 지원하면 전송 중인 요청을 끊음)
+// 취소 후에도 완료 콜백은 실패로 올 수 있으므로 호출한 쪽에서 결과를 버린다.
+struct FAIChatCancellation
+{
+    bool bCancelled = false;
+    TFunction<void()> OnCancel;     // 백엔드가 설정
+
+    void Cancel()
+    {
+        if (!bCancelled)
+        {
+            bCancelled = true;
+            if (OnCancel)
+            {
+                OnCancel();
+            }
+        }
+    }
+};
+
+// 채팅 완성 요청
+struct FAIChatRequest
+{
+    FString Body;           // 요청 JSON
+    bool bStream = false;   // 본문에 "stream": true가 들어 있음 (SSE 응답)
+    TSharedPtr<FAIChatCancellation> Cancellation;   // 없으면 취소 불가
+    bool bLatencyCritical = true;   // 플레이어가 기다리는 요청 (헤지와 응답 마감 시간 적용)
+};
+
+// 채팅 완성 결과
+struct FAIChatResult
+{
+    bool bSuccess = false;          // 전송 성공 여부 (HTTP 오류 코드는 ResponseCode로 판단)
+    int32 ResponseCode = 0;
+    FString ResponseBody;           // 원본 응답 본문 (스트리밍이면 비어 있음)
+    FString Content;                // 백엔드가 이미 조립한 응답 텍스트
+    bool bHasContent = false;       // Content가 채워졌는지 (아니면 ResponseBody를 파싱)
+    float TotalMs = 0.0f;           // 요청 전송부터 완료까지
+    TArray<FAIChatChunk> Chunks;    // 스트리밍 조각과 도착 시각
+    bool bDeadlineFallback = false; // 마감 시간까지 완료되지 않아 부분/대체 응답으로 완료됨
+    FString FinishReason;           // 스트리밍 finish_reason ("stop", "length", 모르면 비어 있음)
+};
+
+// 연결 유지 지표 (게임 스레드에서만 갱신)
+// HTTP 모듈은 요청이 기존 연결을 썼는지 알려 주지 않으므로 재사용 여부는 직접 관찰할 수 없다.
+// 대신 직전 통신 후 가정한 서버 유휴 시간 안에 보낸 요청 비율(시간 기준)과,
+// 실제로 관찰한 지연 차이(새 연결 HEAD와 유지 HEAD, 유휴 창 밖/안 요청의 첫 바이트)를 따로 보고한다.
+struct FAIConnectionStats
+{
+    int32 Requests = 0;
+    int32 IdleWindowRequests = 0;   // 직전 통신 후 가정한 유휴 시간 안에 보낸 요청
+    int32 Prewarms = 0;
+    int32 KeepAlivePings = 0;
+
+    // 첫 바이트(응답 헤더)까지 시간 (유휴 창 안 = Warm, 밖 = Cold)
+    double ColdFirstByteMsSum = 0.0;
+    double WarmFirstByteMsSum = 0.0;
+    int32 ColdSamples = 0;
+    int32 WarmSamples = 0;
+
+    // HEAD 왕복 시간 (서버 처리 시간이 거의 없어 연결 수립 비용이 그대로 드러남)
+    double PrewarmPingMsSum = 0.0;
+    double KeepAlivePingMsSum = 0.0;
+
+    float GetIdleWindowRate() const { return Requests > 0 ? static_cast<float>(IdleWindowRequests) / Requests : 0.0f; }
+    float GetAvgFirstByteMs(bool bWarm) const
+    {
+        const int32 Samples = bWarm ? WarmSamples : ColdSamples;
+        return Samples > 0 ? static_cast<float>((bWarm ? WarmFirstByteMsSum : ColdFirstByteMsSum) / Samples) : 0.0f;
+    }
+    float GetAvgPingMs(bool bKeepAlive) const
+    {
+        const int32 Samples = bKeepAlive ? KeepAlivePings : Prewarms;
+        return Samples > 0 ? static_cast<float>((bKeepAlive ? KeepAlivePingMsSum : PrewarmPingMsSum) / Samples) : 0.0f;
+    }
+
+    // 관찰한 연결 수립 비용 (HEAD 왕복 차이 우선, 없으면 첫 바이트 차이, 비교할 표본이 없으면 0)
+    float GetObservedHandshakeMs() const
+    {
+        if (Prewarms > 0 && KeepAlivePings > 0)
+        {
+            return FMath::Max(0.0f, GetAvgPingMs(false) - GetAvgPingMs(true));
+        }
+        if (ColdSamples > 0 && WarmSamples > 0)
+        {
+            return FMath::Max(0.0f, GetAvgFirstByteMs(false) - GetAvgFirstByteMs(true));
+        }
+        return 0.0f;
+    }
+};
+
+DECLARE_DELEGATE_OneParam(FOnAIChatChunk, const FString& /*ChunkText*/);
+DECLARE_DELEGATE_OneParam(FOnAIChatComplete, const FAIChatResult& /*Result*/);
+
+/**
+ * 채팅 완성 백엔드
+ * 콜백은 모두 게임 스레드에서 호출된다.
+ */
+class AI_DUNGEON_MASTER_API IAIChatBackend
+{
+public:
+    virtual ~IAIChatBackend() = default;
+
+    virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) = 0;
+
+    // API 키가 있어야 요청할 수 있는지
+    virtual bool RequiresAPIKey() const { return true; }
+    virtual void SetAPIKey(const FString& InAPIKey) {}
+
+    // 요청 주소와 타임아웃 (HTTP 백엔드만 사용)
+    virtual void SetEndpoint(const FString& InURL, float InTimeoutSeconds) {}
+
+    // 연결을 미리 맺고, 유휴 중에도 KeepAliveInterval초마다 유지 (0 = 유지 안 함)
+    virtual void WarmConnection(float KeepAliveInterval) {}
+
+    virtual FAIConnectionStats GetConnectionStats() const { return FAIConnectionStats(); }
+
+    virtual const TCHAR* GetName() const = 0;
+};
+
+/**
+ * OpenAI 채팅 완성 HTTP 백엔드 (SSE 스트리밍 지원)
+ * HTTP 모듈의 연결 캐시가 같은 호스트 연결을 재사용하므로,
+ * 로딩 중 HEAD 요청으로 DNS/TCP/TLS를 미리 끝내고 유휴 중에는 주기적으로 유지한다.
+ */
+class AI_DUNGEON_MASTER_API FAIOpenAIBackend : public IAIChatBackend, public TSharedFromThis<FAIOpenAIBackend>
+{
+public:
+    explicit FAIOpenAIBackend(const FString& InURL = TEXT("https://api.openai.com/v1/chat/completions"));
+
+    virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) override;
+    virtual void SetAPIKey(const FString& InAPIKey) override { APIKey = InAPIKey; }
+    virtual void SetEndpoint(const FString& InURL, float InTimeoutSeconds) override;
+    virtual void WarmConnection(float KeepAliveInterval) override;
+    virtual FAIConnectionStats GetConnectionStats() const override { return Stats; }
+    virtual const TCHAR* GetName() const override { return TEXT("OpenAI"); }
+
+    // SSE 데이터 줄 하나에서 delta content와 finish_reason 추출 ("data: [DONE]"이면 false)
+    static bool ParseStreamLine(const FString& Line, FString& OutDelta, FString* OutFinishReason = nullptr);
+
+private:
+    // 서버가 유휴 연결을 닫기 전이라고 가정하는 시간 (초, 관찰값이 아님)
+    static constexpr double AssumedIdleTimeoutSeconds = 50.0;
+
+    // 실제 요청 없이 이 시간(초)이 지나면 연결 유지를 멈춤
+    static constexpr double KeepAliveMaxIdleSeconds = 600.0;
+
+    // 마지막 통신 후 가정한 유휴 시간 안인지 (연결이 실제로 살아 있는지는 알 수 없음)
+    bool IsConnectionWarm() const;
+
+    // 본문 없는 HEAD 요청으로 연결만 맺음
+    void SendPing(bool bPrewarm);
+
+    bool TickKeepAlive(float DeltaTime);
+
+    FString URL;
+    FString APIKey;
+    float TimeoutSeconds = 0.0f;    // 0 = HTTP 모듈 기본값
+
+    FAIConnectionStats Stats;
+    double LastActivityTime = 0.0;  // 마지막으로 서버 응답을 받은 시각
+    double LastRequestTime = 0.0;   // 마지막 실제 요청 (또는 미리 연결) 시각
+    float KeepAliveInterval = 0.0f;
+    int32 InFlightCount = 0;
+    bool bPingInFlight = false;
+    FTSTicker::FDelegateHandle KeepAliveHandle;
+};
@@ -0,0 +1,271 @@
+#include "AIConversationSession.h"
+#include "AIManager.h"
+#include "AIIntentRouter.h"
+#include "AIDMLog.h"
+#include "Async/Async.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+void UAIConversationSession::Initialize(AAIManager* InManager, FName InSessionId, bool bInPersist)
+{
+    Manager = InManager;
+    SessionId = InSessionId;
+    bPersist = bInPersist;
+    MaxPendingRequests = InManager->MaxPendingRequestsPerSession;
+    MaxSessionTokens = InManager->SessionTokenBudget;
+
+    // 대화 기록 검색 인덱스
+    SearchIndex = NewObject<UAISearchIndex>(this);
+
+    // 장기 기억
+    RetrievalMemory = NewObject<UAIRetrievalMemory>(this);
+
+    // 캠페인 요약 단계 (캐시된 요약 로드)
+    Summarizer = NewObject<UAIConversationSummarizer>(this);
+    if (bPersist)
+    {
+        Summarizer->LoadCache(GetSummaryCachePath(SessionId));
+    }
+
+    PromptAssembler = NewObject<UAIPromptAssembler>(this);
+    PromptAssembler->SetStaticRules(Manager->StaticRulesPrompt, Manager->StaticRulesVersion);
+    PromptAssembler->SetTokenizer(Manager->Tokenizer);
+    WorldState.SetTokenizer(Manager->Tokenizer);
+
+    // 이전 세션 복원
+    if (bPersist)
+    {
+        RestoreSession();
+    }
+}
+
+void UAIConversationSession::Shutdown()
+{
+    if (Manager && Manager->GetWorld())
+    {
+        Manager->GetWorldTimerManager().ClearTimer(SummaryTimerHandle);
+        Manager->GetWorldTimerManager().ClearTimer(SpeculationTimerHandle);
+    }
+    if (Manager)
+    {
+        Manager->CancelSpeculations(this, [](const FString&) { return true; });
+    }
+
+    // 대기 중인 레코드를 기록하고 세션 로그 닫기
+    if (SessionLog)
+    {
+        SessionLog->Close();
+        SessionLog.Reset();
+    }
+
+    // 늦게 도착한 응답은 더 이상 전달하지 않음
+    Manager = nullptr;
+}
+
+void UAIConversationSession::SendMessage(const FString& Message)
+{
+    SendTracedMessage(Message, FAIRequestTrace());
+}
+
+void UAIConversationSession::SendTracedMessage(const FString& Message, FAIRequestTrace Trace)
+{
+    if (Manager)
+    {
+        Manager->SendSessionMessage(this, Message, Trace);
+    }
+}
+
+void UAIConversationSession::NotifyTyping(const FString& PartialInput)
+{
+    const FString Prefix = UAIIntentRouter::MakeMatchKey(PartialInput);
+    if (Manager && !Prefix.IsEmpty())
+    {
+        Manager->CancelSpeculations(this, [&Prefix](const FString& Key) { return !Key.StartsWith(Prefix, ESearchCase::CaseSensitive); });
+    }
+}
+
+void UAIConversationSession::SetSceneState(const FString& InSceneState)
+{
+    if (!SceneState.Equals(InSceneState, ESearchCase::CaseSensitive))
+    {
+        SceneState = InSceneState;
+        SceneVersion++;
+    }
+}
+
+FString UAIConversationSession::GetLogPath(FName InSessionId)
+{
+    if (InSessionId == AAIManager::DefaultSessionId)
+    {
+        return FAISessionLog::GetDefaultLogPath();
+    }
+    return FPaths::ProjectSavedDir() / TEXT("AIDM") / TEXT("Sessions") / InSessionId.ToString() + TEXT(".aidmlog");
+}
+
+FString UAIConversationSession::GetSummaryCachePath(FName InSessionId)
+{
+    if (InSessionId == AAIManager::DefaultSessionId)
+    {
+        return UAIConversationSummarizer::GetDefaultCachePath();
+    }
+    return FPaths::ProjectSavedDir() / TEXT("AIDM") / TEXT("Sessions") / InSessionId.ToString() + TEXT(".summary.json");
+}
+
+void UAIConversationSession::RestoreSession()
+{
+    const FString LogPath = GetLogPath(SessionId);
+    const double StartTime = FPlatformTime::Seconds();
+
+    // 메모리 매핑으로 최근 턴 읽기
+    if (FAISessionLog::ReadRecentTurns(LogPath, Manager->RestoreTurnCount, RestoredRecords))
+    {
+        for (const FAISessionRecord& Record : RestoredRecords)
+        {
+            if (Record.RecordType == EAISessionRecordType::UserMessage || Record.RecordType == EAISessionRecordType::AIResponse)
+            {
+                ConversationHistory.Add(Record);
+            }
+            if (Record.RecordType == EAISessionRecordType::AIResponse)
+            {
+                LastModelNarration = Record.Text;
+                LastModelNarrationSceneVersion = SceneVersion;
+            }
+        }
+
+        UE_LOG(LogAIDM, Log, TEXT("세션 복원 완료 (%s): 레코드 %d개, 대화 %d개 (%.2f ms)"), *SessionId.ToString(),
+            RestoredRecords.Num(), ConversationHistory.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    }
+
+    // 지금까지 기록된 로그 전체를 백그라운드에서 색인 (이후 메시지는 점진적으로 추가)
+    const int64 LogSize = FPlatformFileManager::Get().GetPlatformFile().FileSize(*LogPath);
+    if (LogSize > 0)
+    {
+        LoadSessionHistoryAsync(LogPath, LogSize);
+    }
+
+    SessionLog = MakeUnique<FAISessionLog>();
+    if (!SessionLog->Open(LogPath))
+    {
+        SessionLog.Reset();
+    }
+}
+
+TArray<FAISearchHit> UAIConversationSession::SearchHistory(const FString& Query, int32 MaxResults) const
+{
+    if (!SearchIndex)
+    {
+        return TArray<FAISearchHit>();
+    }
+
+    return SearchIndex->Search(Query, MaxResults);
+}
+
+void UAIConversationSession::LoadSessionHistoryAsync(const FString& LogPath, int64 MaxBytes)
+{
+    if (!SearchIndex || !RetrievalMemory)
+    {
+        return;
+    }
+
+    SearchIndex->BeginBackgroundBuild();
+    RetrievalMemory->BeginBackgroundBuild();
+
+    TWeakObjectPtr<UAIConversationSession> WeakThis(this);
+    Async(EAsyncExecution::ThreadPool, [WeakThis, LogPath, MaxBytes]()
+    {
+        const double StartTime = FPlatformTime::Seconds();
+
+        TArray<FAISessionRecord> Records;
+        FAISessionLog::ReadAllRecords(LogPath, MaxBytes, Records);
+
+        TSharedPtr<FAISearchIndexCore> SearchCore = MakeShared<FAISearchIndexCore>();
+        TSharedPtr<FAIRetrievalMemoryCore> MemoryCore = MakeShared<FAIRetrievalMemoryCore>();
+        FString PendingUserText;
+
+        for (const FAISessionRecord& Record : Records)
+        {
+            if (Record.RecordType == EAISessionRecordType::UserMessage)
+            {
+                SearchCore->AddDocument(Record.Text, Record.RecordType, Record.Timestamp);
+                PendingUserText = Record.Text;
+            }
+            else if (Record.RecordType == EAISessionRecordType::AIResponse)
+            {
+                SearchCore->AddDocument(Record.Text, Record.RecordType, Record.Timestamp);
+                MemoryCore->AddTurn(PendingUserText, Record.Text);
+                PendingUserText.Reset();
+            }
+        }
+
+        UE_LOG(LogAIDM, Log, TEXT("세션 기록 색인 완료: 메시지 %d개, 기억 %d턴 (%.1f ms)"),
+            SearchCore->Num(), MemoryCore->Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, SearchCore, MemoryCore]()
+        {
+            UAIConversationSession* Session = WeakThis.Get();
+            if (Session && Session->SearchIndex && Session->RetrievalMemory)
+            {
+                Session->SearchIndex->CompleteBackgroundBuild(SearchCore);
+                Session->RetrievalMemory->CompleteBackgroundBuild(MemoryCore);
+            }
+        });
+    });
+}
+
+void UAIConversationSession::AppendSessionRecord(EAISessionRecordType RecordType, const FString& Text, float DurationMs)
+{
+    FAISessionRecord Record;
+    Record.RecordType = RecordType;
+    Record.Timestamp = FDateTime::UtcNow();
+    Record.DurationMs = DurationMs;
+    Record.Text = Text;
+
+    if (RecordType == EAISessionRecordType::UserMessage || RecordType == EAISessionRecordType::AIResponse)
+    {
+        ConversationHistory.Add(Record);
+        TurnVersion++;
+
+        // 컨텍스트에 필요한 만큼만 메모리에 유지 (요약에 아직 들어가지 않은 턴은 요약이 끝날 때까지 남김)
+        const int32 MaxHistory = FMath::Max(Manager->MaxContextTurns + Manager->ContextWindowStep, Manager->RestoreTurnCount) * 2;
+        if (ConversationHistory.Num() > MaxHistory)
+        {
+            int32 RemoveCount = ConversationHistory.Num() - MaxHistory;
+            if (Summarizer)
+            {
+                const FDateTime CoveredThrough = Summarizer->GetSummary().CoveredThrough;
+                int32 Covered = 0;
+                while (Covered < RemoveCount && ConversationHistory[Covered].Timestamp <= CoveredThrough)
+                {
+                    Covered++;
+                }
+                RemoveCount = Covered;
+            }
+            if (RemoveCount > 0)
+            {
+                ConversationHistory.RemoveAt(0, RemoveCount);
+            }
+        }
+
+        if (SearchIndex)
+        {
+            SearchIndex->AddMessage(Text, RecordType, Record.Timestamp);
+        }
+
+        // 플레이어 입력 + AI 응답을 하나의 기억 턴으로 저장
+        if (RecordType == EAISessionRecordType::UserMessage)
+        {
+            LastUserMessage = Text;
+            LastPlayerInput = Text;
+        }
+        else if (RetrievalMemory)
+        {
+            RetrievalMemory->AddTurn(LastUserMessage, Text);
+            LastUserMessage.Reset();
+        }
+    }
+
+    if (SessionLog)
+    {
+        SessionLog->Append(Record);
+    }
+}
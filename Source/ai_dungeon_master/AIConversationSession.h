@@ -0,0 +1,194 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Engine/TimerHandle.h"
+#include "AISessionLog.h"
+#include "AISearchIndex.h"
+#include "AIRetrievalMemory.h"
+#include "AIConversationSummarizer.h"
+#include "AIPromptAssembler.h"
+#include "AIRequestTrace.h"
+#include "AIActionParser.h"
+#include "AIWorldState.h"
+#include "AIConversationSession.generated.h"
+
+class AActor;
+class AAIManager;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAIResponse, bool, bSuccess, const FString&, Response);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAIResponseChunk, const FString&, Chunk);
+
+/**
+ * 플레이어(또는 파티) 한 명의 대화 상태
+ * 대화 기록, 장기 기억, 요약, 세션 로그와 응답 델리게이트를 가진다.
+ * 요청 전송, 응답 파싱, 백엔드는 AAIManager가 모든 세션에 공유로 제공한다.
+ */
+UCLASS(BlueprintType)
+class AI_DUNGEON_MASTER_API UAIConversationSession : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // AAIManager::GetOrCreateSession에서 호출
+    void Initialize(AAIManager* InManager, FName InSessionId, bool bInPersist);
+
+    // 세션 로그를 닫고 예약된 요약 취소
+    void Shutdown();
+
+    // 이 세션의 대화로 메시지 전송 (응답은 이 세션의 델리게이트로만 전달)
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    void SendMessage(const FString& Message);
+
+    void SendTracedMessage(const FString& Message, FAIRequestTrace Trace);
+
+    UPROPERTY(BlueprintAssignable, Category = "AI|Session")
+    FOnAIResponse OnAIResponse;
+
+    UPROPERTY(BlueprintAssignable, Category = "AI|Session")
+    FOnAIResponseChunk OnAIResponseChunk;
+
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    FName GetSessionId() const { return SessionId; }
+
+    // 플레이어가 입력 중인 텍스트 (맞지 않는 예측 요청은 바로 취소)
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    void NotifyTyping(const FString& PartialInput);
+
+    // 게임이 아는 현재 장면 (위치, 전투 여부 등 짧은 문자열, 바뀌면 장면 버전 증가)
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    void SetSceneState(const FString& InSceneState);
+
+    // 장면이 바뀔 때마다 증가 (의미 캐시는 같은 버전의 응답만 재사용)
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    int32 GetSceneVersion() const { return SceneVersion; }
+
+    // 주변 상태를 볼 기준 액터 (보통 플레이어 폰, 없으면 주변 상태를 프롬프트에 넣지 않음)
+    UFUNCTION(BlueprintCallable, Category = "AI|World")
+    void SetWorldObserver(AActor* Observer) { WorldObserver = Observer; }
+
+    UFUNCTION(BlueprintPure, Category = "AI|World")
+    AActor* GetWorldObserver() const { return WorldObserver.Get(); }
+
+    UFUNCTION(BlueprintPure, Category = "AI|World")
+    FAIWorldStateStats GetWorldStateStats() const { return WorldState.GetStats(); }
+
+    // 동시에 기다릴 수 있는 요청 수 (0 = 무제한, 넘으면 거절)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Session")
+    int32 MaxPendingRequests = 0;
+
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    int32 GetPendingRequestCount() const { return PendingRequestCount; }
+
+    // 쓸 수 있는 토큰 (프롬프트 + 응답, 0 = 무제한, 다 쓰면 거절)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Session")
+    int32 MaxSessionTokens = 0;
+
+    // 지금까지 쓴 토큰 (예측, 요약 요청 포함)
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    int64 GetTokensUsed() const { return TokensUsed; }
+
+    // 마지막 성공 응답에서 파싱된 액션 (OnAIResponse 안에서 유효)
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    TArray<FParsedAction> GetLastParsedActions() const { return LastParsedActions; }
+
+    // 세션 로그에서 복원된 레코드 (채팅 화면 복원용)
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    TArray<FAISessionRecord> GetRestoredRecords() const { return RestoredRecords; }
+
+    // 지난 세션 포함 전체 대화 기록 검색
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    TArray<FAISearchHit> SearchHistory(const FString& Query, int32 MaxResults = 10) const;
+
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    UAISearchIndex* GetSearchIndex() const { return SearchIndex; }
+
+    UFUNCTION(BlueprintPure, Category = "AI|Summary")
+    UAIConversationSummarizer* GetSummarizer() const { return Summarizer; }
+
+    UFUNCTION(BlueprintPure, Category = "AI|Prompt")
+    FAIPromptCacheStats GetPromptCacheStats() const { return PromptAssembler ? PromptAssembler->GetCacheStats() : FAIPromptCacheStats(); }
+
+    // 세션별 로그/요약 캐시 경로 (기본 세션은 기존 경로 유지)
+    static FString GetLogPath(FName InSessionId);
+    static FString GetSummaryCachePath(FName InSessionId);
+
+private:
+    // 요청 조립, 응답 반영, 요약 예약은 매니저가 직접 처리
+    friend class AAIManager;
+    friend class UAIDMSubsystem;
+    friend class UAIDMBenchmarkCommandlet;
+
+    // 세션 로그 복원 및 열기
+    void RestoreSession();
+
+    // 세션 로그 전체를 백그라운드에서 읽어 검색 인덱스와 장기 기억 생성
+    void LoadSessionHistoryAsync(const FString& LogPath, int64 MaxBytes);
+
+    // 세션 로그에 레코드 추가
+    void AppendSessionRecord(EAISessionRecordType RecordType, const FString& Text, float DurationMs = 0.0f);
+
+    UPROPERTY()
+    AAIManager* Manager;
+
+    FName SessionId;
+    bool bPersist = true;
+
+    UPROPERTY()
+    UAISearchIndex* SearchIndex;
+
+    UPROPERTY()
+    UAIRetrievalMemory* RetrievalMemory;
+
+    UPROPERTY()
+    UAIConversationSummarizer* Summarizer;
+
+    // 세션마다 따로 두어 프롬프트 앞부분 캐시가 다른 세션 요청에 깨지지 않게 함
+    UPROPERTY()
+    UAIPromptAssembler* PromptAssembler;
+
+    // 추가 전용 세션 로그 (백그라운드 기록)
+    TUniquePtr<FAISessionLog> SessionLog;
+
+    // 복원된 레코드 (플레이어 입력, AI 응답, 액션, 시간)
+    TArray<FAISessionRecord> RestoredRecords;
+
+    // 요청 컨텍스트로 사용하는 대화 기록 (플레이어 입력, AI 응답만)
+    TArray<FAISessionRecord> ConversationHistory;
+
+    // 장기 기억 턴 구성을 위한 마지막 플레이어 입력
+    FString LastUserMessage;
+
+    // 마지막 모델 응답 (로컬 "둘러보기" 응답에 재사용)
+    FString LastModelNarration;
+
+    // 마지막 모델 응답 때의 장면 버전 (그 뒤 장면이 바뀌었으면 둘러보기에 쓰지 않음)
+    int32 LastModelNarrationSceneVersion = 0;
+
+    // 마지막 플레이어 입력 (다음 입력 예측용, 장기 기억용 LastUserMessage와 달리 유지)
+    FString LastPlayerInput;
+
+    // 대화 턴이 추가될 때마다 증가 (예측 응답이 만들어진 문맥과 같은지 확인)
+    int32 TurnVersion = 0;
+
+    // 장면 상태와 버전 (상태가 바뀌거나 장면을 바꾸는 턴이 끝나면 증가)
+    FString SceneState;
+    int32 SceneVersion = 0;
+
+    // 주변 상태 스냅샷/변경분 (매니저가 요청마다 갱신)
+    TWeakObjectPtr<AActor> WorldObserver;
+    FAIWorldStateEncoder WorldState;
+
+    // 응답을 기다리는 요청 수
+    int32 PendingRequestCount = 0;
+
+    int64 TokensUsed = 0;
+
+    TArray<FParsedAction> LastParsedActions;
+
+    // 요약 예약 타이머
+    FTimerHandle SummaryTimerHandle;
+
+    // 다음 입력 예측 예약 타이머
+    FTimerHandle SpeculationTimerHandle;
+};
@@ -0,0 +1,159 @@
+#include "AIConversationSummarizer.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "AIDMLog.h"
+
+FString UAIConversationSummarizer::GetDefaultCachePath()
+{
+    return FPaths::ProjectSavedDir() / TEXT("AIDM") / TEXT("CampaignSummary.json");
+}
+
+void UAIConversationSummarizer::LoadCache(const FString& InCachePath)
+{
+    CachePath = InCachePath;
+
+    FString JsonString;
+    if (!FFileHelper::LoadFileToString(JsonString, *CachePath))
+    {
+        return;
+    }
+
+    FAICampaignSummary Loaded;
+    if (FJsonObjectConverter::JsonObjectStringToUStruct(JsonString, &Loaded, 0, 0))
+    {
+        Summary = Loaded;
+        UE_LOG(LogAIDM, Log, TEXT("캠페인 요약 캐시 로드: 버전 %d, 턴 %d"), Summary.Version, Summary.FoldedTurnCount);
+    }
+}
+
+void UAIConversationSummarizer::SaveCache() const
+{
+    if (CachePath.IsEmpty())
+    {
+        return;
+    }
+
+    FString JsonString;
+    if (FJsonObjectConverter::UStructToJsonObjectString(Summary, JsonString))
+    {
+        FFileHelper::SaveStringToFile(JsonString, *CachePath);
+    }
+}
+
+bool UAIConversationSummarizer::CollectTurnsToFold(const TArray<FAISessionRecord>& History, int32 RecentRecordCount, TArray<FAISessionRecord>& OutTurns) const
+{
+    OutTurns.Reset();
+
+    // 창 밖의 레코드 중 아직 요약되지 않은 것만
+    const int32 WindowStart = History.Num() - FMath::Max(0, RecentRecordCount);
+    int32 TurnCount = 0;
+    for (int32 i = 0; i < WindowStart; i++)
+    {
+        const FAISessionRecord& Record = History[i];
+        if (Record.Timestamp <= Summary.CoveredThrough)
+        {
+            continue;
+        }
+
+        OutTurns.Add(Record);
+        if (Record.RecordType == EAISessionRecordType::AIResponse)
+        {
+            TurnCount++;
+        }
+    }
+
+    // 응답이 없는 마지막 플레이어 입력은 다음 번에
+    while (OutTurns.Num() > 0 && OutTurns.Last().RecordType != EAISessionRecordType::AIResponse)
+    {
+        OutTurns.Pop();
+    }
+
+    return TurnCount >= FoldBatchTurns;
+}
+
+FString UAIConversationSummarizer::CreateFoldRequestBody(const TArray<FAISessionRecord>& Turns, const FString& Model, int32 MaxTokens, float Temperature) const
+{
+    FString Events;
+    for (const FAISessionRecord& Turn : Turns)
+    {
+        Events += Turn.RecordType == EAISessionRecordType::UserMessage ? TEXT("Player: ") : TEXT("DM: ");
+        Events += Turn.Text;
+        Events += TEXT("\n");
+    }
+
+    FString Prompt;
+    if (!Summary.Text.IsEmpty())
+    {
+        Prompt = FString::Printf(TEXT("Campaign so far:\n%s\n\n"), *Summary.Text);
+    }
+    Prompt += FString::Printf(TEXT("New events:\n%s"), *Events);
+
+    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
+    JsonObject->SetStringField(TEXT("model"), Model);
+    JsonObject->SetNumberField(TEXT("max_tokens"), MaxTokens > 0 ? MaxTokens : MaxSummaryTokens);
+    JsonObject->SetNumberField(TEXT("temperature"), Temperature >= 0.0f ? Temperature : 0.2f);
+
+    TArray<TSharedPtr<FJsonValue>> Messages;
+
+    TSharedPtr<FJsonObject> SystemMsg = MakeShareable(new FJsonObject);
+    SystemMsg->SetStringField(TEXT("role"), TEXT("system"));
+    SystemMsg->SetStringField(TEXT("content"), TEXT("You maintain the running summary of a text adventure campaign. Merge the new events into the campaign summary. Keep names, places, items, quests and unresolved threads. Reply with the updated summary only, under 150 words."));
+    Messages.Add(MakeShareable(new FJsonValueObject(SystemMsg)));
+
+    TSharedPtr<FJsonObject> UserMsg = MakeShareable(new FJsonObject);
+    UserMsg->SetStringField(TEXT("role"), TEXT("user"));
+    UserMsg->SetStringField(TEXT("content"), Prompt);
+    Messages.Add(MakeShareable(new FJsonValueObject(UserMsg)));
+
+    JsonObject->SetArrayField(TEXT("messages"), Messages);
+
+    FString OutputString;
+    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
+    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+
+    return OutputString;
+}
+
+void UAIConversationSummarizer::BeginFold(const TArray<FAISessionRecord>& Turns)
+{
+    bFoldInFlight = true;
+    InFlightCoveredThrough = Turns.Num() > 0 ? Turns.Last().Timestamp : Summary.CoveredThrough;
+    InFlightTurnCount = 0;
+    for (const FAISessionRecord& Turn : Turns)
+    {
+        if (Turn.RecordType == EAISessionRecordType::AIResponse)
+        {
+            InFlightTurnCount++;
+        }
+    }
+}
+
+void UAIConversationSummarizer::AbortFold()
+{
+    bFoldInFlight = false;
+    InFlightTurnCount = 0;
+}
+
+void UAIConversationSummarizer::CompleteFold(bool bSuccess, const FString& NewSummaryText)
+{
+    bFoldInFlight = false;
+
+    const FString CleanedSummary = NewSummaryText.TrimStartAndEnd();
+    if (!bSuccess || CleanedSummary.IsEmpty())
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("캠페인 요약 갱신 실패 - 다음 유휴 시간에 다시 시도"));
+        return;
+    }
+
+    Summary.Text = CleanedSummary;
+    Summary.Version++;
+    Summary.FoldedTurnCount += InFlightTurnCount;
+    Summary.CoveredThrough = InFlightCoveredThrough;
+    SaveCache();
+
+    UE_LOG(LogAIDM, Log, TEXT("캠페인 요약 갱신: 버전 %d, 누적 턴 %d"), Summary.Version, Summary.FoldedTurnCount);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AISessionLog.h"
+#include "AIConversationSummarizer.generated.h"
+
+// 캠페인 요약 (버전 관리, 디스크에 캐시)
+USTRUCT(BlueprintType)
+struct FAICampaignSummary
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Text;                   // "지금까지의 캠페인" 요약문
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 Version = 0;              // 요약이 갱신될 때마다 증가
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 FoldedTurnCount = 0;      // 요약에 포함된 누적 턴 수
+
+    UPROPERTY(BlueprintReadOnly)
+    FDateTime CoveredThrough;       // 요약에 포함된 마지막 AI 응답 시각
+};
+
+/**
+ * 오래된 턴을 "지금까지의 캠페인" 요약으로 접는 백그라운드 요약 단계
+ * 요청 본문 생성과 결과 반영만 담당하고, 실제 요청은 AAIManager가 대기열이 비었을 때만 보낸다.
+ */
+UCLASS()
+class AI_DUNGEON_MASTER_API UAIConversationSummarizer : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // 캐시된 요약 읽기/저장
+    void LoadCache(const FString& InCachePath);
+    void SaveCache() const;
+
+    // 최근 RecentRecordCount개 레코드(그대로 보내는 창)보다 오래되고 아직 요약되지 않은 턴 수집
+    bool CollectTurnsToFold(const TArray<FAISessionRecord>& History, int32 RecentRecordCount, TArray<FAISessionRecord>& OutTurns) const;
+
+    // 요약 요청 본문 생성 (MaxTokens 0 = MaxSummaryTokens, Temperature 음수 = 0.2)
+    FString CreateFoldRequestBody(const TArray<FAISessionRecord>& Turns, const FString& Model, int32 MaxTokens = 0, float Temperature = -1.0f) const;
+
+    // 요약 요청 시작/완료
+    void BeginFold(const TArray<FAISessionRecord>& Turns);
+    void CompleteFold(bool bSuccess, const FString& NewSummaryText);
+
+    // 응답을 받지 못할 요청 포기 (요약은 그대로, 다음 유휴 시간에 같은 턴을 다시 접음)
+    void AbortFold();
+
+    bool IsFoldInFlight() const { return bFoldInFlight; }
+
+    UFUNCTION(BlueprintPure, Category = "AI|Summary")
+    FAICampaignSummary GetSummary() const { return Summary; }
+
+    // 한 번에 접을 최소 턴 수
+    UPROPERTY(EditAnywhere, Category = "AI|Summary")
+    int32 FoldBatchTurns = 4;
+
+    // 요약 응답 최대 토큰
+    UPROPERTY(EditAnywhere, Category = "AI|Summary")
+    int32 MaxSummaryTokens = 200;
+
+    // 기본 캐시 경로
+    static FString GetDefaultCachePath();
+
+private:
+    FAICampaignSummary Summary;
+    FString CachePath;
+
+    // 진행 중인 요약 요청 정보
+    bool bFoldInFlight = false;
+    FDateTime InFlightCoveredThrough;
+    int32 InFlightTurnCount = 0;
+};
@@ -0,0 +1,443 @@
+#include "AIDMBenchmarkCommandlet.h"
+#include "AIManager.h"
+#include "AIActionParser.h"
+#include "AIIntentRouter.h"
+#include "AIDMPlayerController.h"
+#include "AISessionLog.h"
+#include "AIRetrievalMemory.h"
+#include "AITokenizer.h"
+#include "AIDMLog.h"
+#include "Engine/World.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformFileManager.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include <atomic>
+
+namespace AIDMBenchmark
+{
+    // GMalloc을 감싸 측정 구간 동안만 할당 횟수/바이트를 센다
+    // (다른 스레드의 할당도 섞이므로 커맨드렛처럼 조용한 프로세스에서만 의미 있음)
+    // 다른 스레드가 GMalloc 포인터를 읽어 둔 뒤 호출할 수 있으므로 한 번 설치하면 프로세스 끝까지 유지하고 세기만 켜고 끈다.
+    class FCountingMalloc final : public FMalloc
+    {
+    public:
+        explicit FCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            AddAllocation(Count);
+            return Inner->Malloc(Count, Alignment);
+        }
+
+        virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+        {
+            AddAllocation(Count);
+            return Inner->TryMalloc(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                AddAllocation(Count);
+            }
+            return Inner->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                AddAllocation(Count);
+            }
+            return Inner->TryRealloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override { Inner->Free(Original); }
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+        virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual const TCHAR* GetDescriptiveName() override { return TEXT("AIDMBenchmarkCounting"); }
+
+        // 처음 호출할 때 GMalloc 자리에 설치 (해제하지 않음)
+        static FCountingMalloc& Get()
+        {
+            static FCountingMalloc* Instance = [&]()
+            {
+                FCountingMalloc* Counting = new FCountingMalloc(GMalloc);
+                GMalloc = Counting;
+                return Counting;
+            }();
+            return *Instance;
+        }
+
+        void Start()
+        {
+            Allocs.store(0, std::memory_order_relaxed);
+            Bytes.store(0, std::memory_order_relaxed);
+            bCounting.store(true, std::memory_order_release);
+        }
+
+        void Stop() { bCounting.store(false, std::memory_order_release); }
+
+        std::atomic<int64> Allocs{ 0 };
+        std::atomic<int64> Bytes{ 0 };
+
+    private:
+        void AddAllocation(SIZE_T Count)
+        {
+            if (!bCounting.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            Allocs.fetch_add(1, std::memory_order_relaxed);
+            Bytes.fetch_add(static_cast<int64>(Count), std::memory_order_relaxed);
+        }
+
+        FMalloc* Inner;
+        std::atomic<bool> bCounting{ false };
+    };
+
+    // 최적화로 결과가 사라지지 않도록 누적
+    static volatile int64 Sink = 0;
+
+    // Body(Index)를 Iterations * NumOps번 호출하고 호출당 시간과 할당을 측정
+    static FAIDMBenchmarkResult Run(const TCHAR* Name, int32 Iterations, int32 NumOps, TFunctionRef<void(int32)> Body)
+    {
+        // 준비 실행 (지연 초기화, 캐시 예열)
+        for (int32 i = 0; i < NumOps; i++)
+        {
+            Body(i);
+        }
+
+        FCountingMalloc& CountingMalloc = FCountingMalloc::Get();
+        CountingMalloc.Start();
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+        {
+            for (int32 i = 0; i < NumOps; i++)
+            {
+                Body(i);
+            }
+        }
+        const uint64 EndCycles = FPlatformTime::Cycles64();
+
+        CountingMalloc.Stop();
+
+        FAIDMBenchmarkResult Result;
+        Result.Name = Name;
+        Result.Ops = static_cast<int64>(Iterations) * NumOps;
+        if (Result.Ops > 0)
+        {
+            Result.NsPerOp = FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1.0e9 / Result.Ops;
+            Result.AllocsPerOp = static_cast<double>(CountingMalloc.Allocs.load()) / Result.Ops;
+            Result.BytesPerOp = static_cast<double>(CountingMalloc.Bytes.load()) / Result.Ops;
+        }
+
+        UE_LOG(LogAIDM, Display, TEXT("%-28s %10lld ops %12.1f ns/op %8.2f allocs/op %10.1f B/op"),
+            Name, Result.Ops, Result.NsPerOp, Result.AllocsPerOp, Result.BytesPerOp);
+        return Result;
+    }
+}
+
+UAIDMBenchmarkCommandlet::UAIDMBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UAIDMBenchmarkCommandlet::Main(const FString& Params)
+{
+    using namespace AIDMBenchmark;
+
+    FString CorpusPath;
+    FParse::Value(*Params, TEXT("corpus="), CorpusPath);
+
+    int32 SyntheticCount = 2000;
+    FParse::Value(*Params, TEXT("count="), SyntheticCount);
+
+    int32 Iterations = 5;
+    FParse::Value(*Params, TEXT("iterations="), Iterations);
+    Iterations = FMath::Max(1, Iterations);
+
+    FString BaselinePath = FPaths::ProjectSavedDir() / TEXT("AIDM") / TEXT("BenchmarkBaseline.json");
+    FParse::Value(*Params, TEXT("baseline="), BaselinePath);
+
+    double Tolerance = 0.10;
+    FParse::Value(*Params, TEXT("tolerance="), Tolerance);
+
+    FString OutPath;
+    FParse::Value(*Params, TEXT("out="), OutPath);
+
+    const bool bWriteBaseline = FParse::Param(*Params, TEXT("writebaseline"));
+
+    // 코퍼스
+    TArray<FString> Responses;
+    LoadCorpus(CorpusPath, SyntheticCount, Responses);
+    if (Responses.Num() == 0)
+    {
+        UE_LOG(LogAIDM, Error, TEXT("벤치마크 코퍼스가 비어 있습니다"));
+        return 1;
+    }
+
+    // 분류 대상 명령어 (응답에서 추출)
+    UAIActionParser* Parser = NewObject<UAIActionParser>();
+    TArray<FString> Commands;
+    for (const FString& Response : Responses)
+    {
+        Commands.Append(Parser->ExtractCommands(Response));
+    }
+    if (Commands.Num() == 0)
+    {
+        Commands.Add(TEXT("look around"));
+    }
+
+    // 요청 본문 생성용 매니저와 세션 (BeginPlay 없이, 코퍼스로 대화 기록과 장기 기억 채움)
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("AIDMBenchmarkWorld"));
+    AAIManager* Manager = World->SpawnActor<AAIManager>();
+    Manager->bPersistSession = false;
+    UAIConversationSession* Session = Manager->GetOrCreateSession(AAIManager::DefaultSessionId);
+    for (int32 i = 0; i < Responses.Num(); i++)
+    {
+        const FString PlayerText = FString::Printf(TEXT("I search the room for clue number %d"), i);
+
+        FAISessionRecord UserRecord;
+        UserRecord.RecordType = EAISessionRecordType::UserMessage;
+        UserRecord.Timestamp = FDateTime(2025, 1, 1) + FTimespan::FromSeconds(i * 2);
+        UserRecord.Text = PlayerText;
+
+        FAISessionRecord ResponseRecord = UserRecord;
+        ResponseRecord.RecordType = EAISessionRecordType::AIResponse;
+        ResponseRecord.Timestamp += FTimespan::FromSeconds(1);
+        ResponseRecord.Text = Responses[i];
+
+        Session->ConversationHistory.Add(UserRecord);
+        Session->ConversationHistory.Add(ResponseRecord);
+        Session->RetrievalMemory->AddTurn(PlayerText, Responses[i]);
+    }
+    const int32 MaxHistory = FMath::Max(Manager->MaxContextTurns + Manager->ContextWindowStep, Manager->RestoreTurnCount) * 2;
+    if (Session->ConversationHistory.Num() > MaxHistory)
+    {
+        Session->ConversationHistory.RemoveAt(0, Session->ConversationHistory.Num() - MaxHistory);
+    }
+
+    UE_LOG(LogAIDM, Display, TEXT("AIDM 벤치마크: 응답 %d개, 명령어 %d개, 반복 %d회"), Responses.Num(), Commands.Num(), Iterations);
+
+    FAIDMBenchmarkReport Report;
+    Report.CorpusSize = Responses.Num();
+
+    Report.Results.Add(Run(TEXT("ParseAIResponse"), Iterations, Responses.Num(), [&](int32 Index)
+    {
+        Sink += Parser->ParseAIResponse(Responses[Index]).Num();
+    }));
+
+    Report.Results.Add(Run(TEXT("ClassifyActionType"), Iterations, Commands.Num(), [&](int32 Index)
+    {
+        Sink += static_cast<int64>(Parser->ClassifyActionType(Commands[Index]));
+    }));
+
+    Report.Results.Add(Run(TEXT("FormatMessageWithLineBreaks"), Iterations, Responses.Num(), [&](int32 Index)
+    {
+        Sink += AAIDMPlayerController::FormatMessageWithLineBreaks(Responses[Index]).Len();
+    }));
+
+    Report.Results.Add(Run(TEXT("CreateRequestBody"), Iterations, Responses.Num(), [&](int32 Index)
+    {
+        Sink += Manager->CreateRequestBody(Session, Commands[Index % Commands.Num()]).Len();
+    }));
+
+    // 토큰 수 계산 (순위 파일이 없으면 글자 수 추정만 측정됨)
+    FAITokenizer Tokenizer;
+    Tokenizer.LoadFromFile(Manager->TokenizerPath);
+    Report.Results.Add(Run(TEXT("CountTokens"), Iterations, Responses.Num(), [&](int32 Index)
+    {
+        Sink += Tokenizer.CountTokens(Responses[Index]);
+    }));
+
+    // 플레이어 입력 의도 라우팅 (로컬 처리 여부 판단, 대부분은 모델로 감)
+    UAIIntentRouter* IntentRouter = NewObject<UAIIntentRouter>();
+    Commands.Append({ TEXT("inventory"), TEXT("I'll wait."), TEXT("look around") });
+    Report.Results.Add(Run(TEXT("IntentRoute"), Iterations, Commands.Num(), [&](int32 Index)
+    {
+        FParsedAction Action;
+        FString Narration;
+        Sink += IntentRouter->TryRoute(Commands[Index], Parser, Responses[0], Action, Narration) ? Narration.Len() : 0;
+    }));
+
+    World->DestroyWorld(false);
+
+    // 결과 저장
+    FString ReportJson;
+    FJsonObjectConverter::UStructToJsonObjectString(Report, ReportJson);
+    if (!OutPath.IsEmpty())
+    {
+        FFileHelper::SaveStringToFile(ReportJson, *OutPath);
+    }
+
+    if (bWriteBaseline)
+    {
+        FFileHelper::SaveStringToFile(ReportJson, *BaselinePath);
+        UE_LOG(LogAIDM, Display, TEXT("기준선 저장: %s"), *BaselinePath);
+        return 0;
+    }
+
+    // 기준선 비교
+    FString BaselineJson;
+    FAIDMBenchmarkReport Baseline;
+    if (!FFileHelper::LoadFileToString(BaselineJson, *BaselinePath)
+        || !FJsonObjectConverter::JsonObjectStringToUStruct(BaselineJson, &Baseline, 0, 0))
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("기준선 없음 (%s) - 비교 생략, -writebaseline으로 저장"), *BaselinePath);
+        return 0;
+    }
+
+    return CompareWithBaseline(Report, Baseline, Tolerance) ? 0 : 1;
+}
+
+void UAIDMBenchmarkCommandlet::LoadCorpus(const FString& CorpusPath, int32 SyntheticCount, TArray<FString>& OutResponses)
+{
+    OutResponses.Reset();
+
+    if (!CorpusPath.IsEmpty())
+    {
+        if (FPaths::GetExtension(CorpusPath) == TEXT("aidmlog"))
+        {
+            // 세션 로그의 AI 응답 레코드
+            TArray<FAISessionRecord> Records;
+            const int64 Size = FPlatformFileManager::Get().GetPlatformFile().FileSize(*CorpusPath);
+            if (Size > 0 && FAISessionLog::ReadAllRecords(CorpusPath, Size, Records))
+            {
+                for (const FAISessionRecord& Record : Records)
+                {
+                    if (Record.RecordType == EAISessionRecordType::AIResponse)
+                    {
+                        OutResponses.Add(Record.Text);
+                    }
+                }
+            }
+        }
+        else
+        {
+            // 한 줄에 응답 하나 (줄바꿈은 \n으로 이스케이프)
+            TArray<FString> Lines;
+            FFileHelper::LoadFileToStringArray(Lines, *CorpusPath);
+            for (const FString& Line : Lines)
+            {
+                if (!Line.IsEmpty())
+                {
+                    OutResponses.Add(Line.Replace(TEXT("\\n"), TEXT("\n")));
+                }
+            }
+        }
+
+        UE_LOG(LogAIDM, Display, TEXT("코퍼스 로드: %s (응답 %d개)"), *CorpusPath, OutResponses.Num());
+    }
+
+    if (OutResponses.Num() == 0)
+    {
+        GenerateSyntheticCorpus(FMath::Max(1, SyntheticCount), OutResponses);
+    }
+}
+
+void UAIDMBenchmarkCommandlet::GenerateSyntheticCorpus(int32 Count, TArray<FString>& OutResponses)
+{
+    static const TCHAR* Narration[] =
+    {
+        TEXT("The torchlight flickers across the damp stone walls."),
+        TEXT("A low growl echoes from somewhere deeper in the dungeon!"),
+        TEXT("The goblin eyes you warily, its blade trembling in its hand."),
+        TEXT("You notice faint runes carved into the archway above the door."),
+        TEXT("Cold air rushes past as the heavy gate grinds open."),
+        TEXT("What do you do next?"),
+        TEXT("The merchant smiles and gestures toward his wares."),
+        TEXT("Water drips steadily from the cracked ceiling.")
+    };
+
+    static const TCHAR* Actions[] =
+    {
+        TEXT("[attack the orc]"),
+        TEXT("*look around the chamber*"),
+        TEXT("Action: open the wooden chest"),
+        TEXT("You move to the north door."),
+        TEXT("[cast fireball at the skeleton]"),
+        TEXT("*talk to the merchant*"),
+        TEXT("Action: use healing potion"),
+        TEXT("You wait in the shadows."),
+        TEXT("[pick up the silver key]"),
+        TEXT("*check inventory*")
+    };
+
+    // 고정 시드 (실행마다 같은 코퍼스)
+    FRandomStream Random(20250101);
+    OutResponses.Reserve(Count);
+
+    for (int32 i = 0; i < Count; i++)
+    {
+        FString Response;
+        const int32 NumSentences = Random.RandRange(1, 5);
+        for (int32 s = 0; s < NumSentences; s++)
+        {
+            if (!Response.IsEmpty())
+            {
+                Response += TEXT(" ");
+            }
+            Response += Narration[Random.RandHelper(UE_ARRAY_COUNT(Narration))];
+        }
+
+        const int32 NumActions = Random.RandRange(0, 2);
+        for (int32 a = 0; a < NumActions; a++)
+        {
+            Response += TEXT("\n");
+            Response += Actions[Random.RandHelper(UE_ARRAY_COUNT(Actions))];
+        }
+
+        OutResponses.Add(MoveTemp(Response));
+    }
+
+    UE_LOG(LogAIDM, Display, TEXT("합성 코퍼스 생성: 응답 %d개"), Count);
+}
+
+bool UAIDMBenchmarkCommandlet::CompareWithBaseline(const FAIDMBenchmarkReport& Report, const FAIDMBenchmarkReport& Baseline, double Tolerance)
+{
+    bool bPassed = true;
+
+    for (const FAIDMBenchmarkResult& Result : Report.Results)
+    {
+        const FAIDMBenchmarkResult* Base = Baseline.Results.FindByPredicate([&Result](const FAIDMBenchmarkResult& Candidate)
+        {
+            return Candidate.Name == Result.Name;
+        });
+
+        if (!Base)
+        {
+            UE_LOG(LogAIDM, Display, TEXT("%s: 기준선 없음"), *Result.Name);
+            continue;
+        }
+
+        const bool bTimeRegressed = Base->NsPerOp > 0.0 && Result.NsPerOp > Base->NsPerOp * (1.0 + Tolerance);
+        // 할당 횟수는 정수 단위로 흔들리므로 최소 0.5회 여유
+        const bool bAllocsRegressed = Result.AllocsPerOp > Base->AllocsPerOp * (1.0 + Tolerance) + 0.5;
+
+        if (bTimeRegressed || bAllocsRegressed)
+        {
+            bPassed = false;
+            UE_LOG(LogAIDM, Error, TEXT("%s 회귀: %.1f ns/op (기준 %.1f), %.2f allocs/op (기준 %.2f)"),
+                *Result.Name, Result.NsPerOp, Base->NsPerOp, Result.AllocsPerOp, Base->AllocsPerOp);
+        }
+        else
+        {
+            UE_LOG(LogAIDM, Display, TEXT("%s 통과: %.1f ns/op (기준 %.1f), %.2f allocs/op (기준 %.2f)"),
+                *Result.Name, Result.NsPerOp, Base->NsPerOp, Result.AllocsPerOp, Base->AllocsPerOp);
+        }
+    }
+
+    return bPassed;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AIDMBenchmarkCommandlet.generated.h"
+
+// 벤치마크 하나의 결과
+USTRUCT()
+struct FAIDMBenchmarkResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FString Name;
+
+    UPROPERTY()
+    int64 Ops = 0;              // 측정한 호출 수
+
+    UPROPERTY()
+    double NsPerOp = 0.0;       // 호출당 시간 (ns)
+
+    UPROPERTY()
+    double AllocsPerOp = 0.0;   // 호출당 할당 횟수
+
+    UPROPERTY()
+    double BytesPerOp = 0.0;    // 호출당 할당 바이트
+};
+
+// 벤치마크 결과 파일 (기준선 저장/비교에 사용)
+USTRUCT()
+struct FAIDMBenchmarkReport
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 CorpusSize = 0;
+
+    UPROPERTY()
+    TArray<FAIDMBenchmarkResult> Results;
+};
+
+/**
+ * 파서, 줄바꿈 포맷터, 요청 본문 생성 벤치마크 (GPU 없이 실행)
+ *
+ * UnrealEditor-Cmd ai_dungeon_master.uproject -run=AIDMBenchmark -nullrhi [옵션]
+ *   -corpus=<파일>       .aidmlog 세션 로그(AI 응답 레코드) 또는 한 줄에 응답 하나인 텍스트 (\n 이스케이프)
+ *   -count=<N>           코퍼스가 없을 때 만들 합성 응답 수 (기본 2000)
+ *   -iterations=<N>      코퍼스 반복 횟수 (기본 5)
+ *   -baseline=<파일>     기준선 JSON (기본 Saved/AIDM/BenchmarkBaseline.json)
+ *   -writebaseline       이번 결과를 기준선으로 저장
+ *   -tolerance=<비율>    허용 회귀 비율 (기본 0.10)
+ *   -out=<파일>          결과 JSON 저장
+ *
+ * 기준선보다 ns/op 또는 allocs/op가 허용 범위를 넘으면 1을 반환한다.
+ */
+UCLASS()
+class UAIDMBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAIDMBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    // 코퍼스 준비 (파일이 없으면 고정 시드로 합성)
+    static void LoadCorpus(const FString& CorpusPath, int32 SyntheticCount, TArray<FString>& OutResponses);
+    static void GenerateSyntheticCorpus(int32 Count, TArray<FString>& OutResponses);
+
+    // 기준선 비교 (회귀가 있으면 false)
+    static bool CompareWithBaseline(const FAIDMBenchmarkReport& Report, const FAIDMBenchmarkReport& Baseline, double Tolerance);
+};
@@ -0,0 +1,337 @@
+#include "AIDMConfig.h"
+#include "AIDMLog.h"
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace AIDMConfigPrivate
+{
+    static const TCHAR* ConfigSection = TEXT("AIDM");
+
+    static FDateTime GetFileTime(const FString& Path)
+    {
+        // 파일이 없으면 FDateTime::MinValue
+        return FPlatformFileManager::Get().GetPlatformFile().GetTimeStamp(*Path);
+    }
+
+    // 설정 파일에서 읽는 경로 (로컬 경로는 모델이 없음)
+    static const EAIModelRoute ConfigurableRoutes[] = { EAIModelRoute::Narration, EAIModelRoute::Summary };
+
+    // ini 키: <경로>Model, <경로>MaxTokens, <경로>Temperature, <경로>InputCostPer1K, <경로>OutputCostPer1K
+    static void ReadRouteIni(const FString& Prefix, FAIModelRoute& Route)
+    {
+        GConfig->GetString(ConfigSection, *(Prefix + TEXT("Model")), Route.Model, GGameIni);
+        GConfig->GetInt(ConfigSection, *(Prefix + TEXT("MaxTokens")), Route.MaxTokens, GGameIni);
+        GConfig->GetFloat(ConfigSection, *(Prefix + TEXT("Temperature")), Route.Temperature, GGameIni);
+        GConfig->GetFloat(ConfigSection, *(Prefix + TEXT("InputCostPer1K")), Route.InputCostPer1K, GGameIni);
+        GConfig->GetFloat(ConfigSection, *(Prefix + TEXT("OutputCostPer1K")), Route.OutputCostPer1K, GGameIni);
+    }
+
+    static void ReadRouteJson(const FJsonObject& RouteObject, FAIModelRoute& Route)
+    {
+        RouteObject.TryGetStringField(TEXT("model"), Route.Model);
+        RouteObject.TryGetNumberField(TEXT("max_tokens"), Route.MaxTokens);
+
+        double Number = 0.0;
+        if (RouteObject.TryGetNumberField(TEXT("temperature"), Number))
+        {
+            Route.Temperature = static_cast<float>(Number);
+        }
+        if (RouteObject.TryGetNumberField(TEXT("input_cost_per_1k"), Number))
+        {
+            Route.InputCostPer1K = static_cast<float>(Number);
+        }
+        if (RouteObject.TryGetNumberField(TEXT("output_cost_per_1k"), Number))
+        {
+            Route.OutputCostPer1K = static_cast<float>(Number);
+        }
+    }
+
+    static void ReadEnvironment(const TCHAR* Name, FString& OutValue)
+    {
+        const FString Value = FPlatformMisc::GetEnvironmentVariable(Name).TrimStartAndEnd();
+        if (!Value.IsEmpty())
+        {
+            OutValue = Value;
+        }
+    }
+}
+
+FAIModelRoute FAIDMConfig::GetRoute(EAIModelRoute Route) const
+{
+    FAIModelRoute Result = Routes[static_cast<int32>(Route)];
+    if (Result.Model.IsEmpty())
+    {
+        Result.Model = Model;
+    }
+    if (Route == EAIModelRoute::Narration)
+    {
+        if (Result.MaxTokens <= 0)
+        {
+            Result.MaxTokens = MaxTokens;
+        }
+        if (Result.Temperature < 0.0f)
+        {
+            Result.Temperature = Temperature;
+        }
+    }
+    return Result;
+}
+
+FString FAIDMConfigLoader::GetAPIKeyFilePath()
+{
+    return FPaths::ProjectDir() / TEXT("api_key.txt");
+}
+
+FString FAIDMConfigLoader::GetConfigFilePath()
+{
+    return FPaths::ProjectDir() / TEXT("aidm_config.json");
+}
+
+void FAIDMConfigLoader::Start(float PollInterval)
+{
+    using namespace AIDMConfigPrivate;
+    check(IsInGameThread());
+
+    // ini는 이미 메모리에 있으므로 게임 스레드에서 읽어도 디스크 접근 없음
+    if (GConfig)
+    {
+        GConfig->GetString(ConfigSection, TEXT("Endpoint"), Defaults.Endpoint, GGameIni);
+        GConfig->GetString(ConfigSection, TEXT("Model"), Defaults.Model, GGameIni);
+        GConfig->GetInt(ConfigSection, TEXT("MaxTokens"), Defaults.MaxTokens, GGameIni);
+        GConfig->GetFloat(ConfigSection, TEXT("Temperature"), Defaults.Temperature, GGameIni);
+        GConfig->GetFloat(ConfigSection, TEXT("RequestTimeoutSeconds"), Defaults.RequestTimeoutSeconds, GGameIni);
+        GConfig->GetString(ConfigSection, TEXT("HedgeEndpoint"), Defaults.HedgeEndpoint, GGameIni);
+        GConfig->GetString(ConfigSection, TEXT("HedgeModel"), Defaults.HedgeModel, GGameIni);
+
+        for (EAIModelRoute Route : ConfigurableRoutes)
+        {
+            // "narration" -> "Narration"
+            FString Prefix = GetModelRouteName(Route);
+            Prefix[0] = FChar::ToUpper(Prefix[0]);
+            ReadRouteIni(Prefix, Defaults.Routes[static_cast<int32>(Route)]);
+        }
+    }
+
+    Reload();
+
+    if (PollInterval > 0.0f && !PollHandle.IsValid())
+    {
+        PollHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FAIDMConfigLoader::PollFiles), PollInterval);
+    }
+}
+
+void FAIDMConfigLoader::Stop()
+{
+    if (PollHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(PollHandle);
+        PollHandle.Reset();
+    }
+}
+
+void FAIDMConfigLoader::Reload()
+{
+    check(IsInGameThread());
+
+    // 로드 중이면 끝난 뒤 한 번 더
+    if (bLoadInFlight)
+    {
+        bReloadQueued = true;
+        return;
+    }
+    bLoadInFlight = true;
+
+    TWeakPtr<FAIDMConfigLoader> WeakThis = AsShared();
+    const FAIDMConfig LoadDefaults = Defaults;
+    Async(EAsyncExecution::ThreadPool, [WeakThis, LoadDefaults]()
+    {
+        // 읽기 전에 시각을 기록해 읽는 도중 바뀐 파일도 다음 확인에서 다시 로드
+        const FDateTime KeyFileTime = AIDMConfigPrivate::GetFileTime(GetAPIKeyFilePath());
+        const FDateTime ConfigFileTime = AIDMConfigPrivate::GetFileTime(GetConfigFilePath());
+        const TSharedRef<const FAIDMConfig> NewConfig = LoadAndValidate(LoadDefaults);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, NewConfig, KeyFileTime, ConfigFileTime]()
+        {
+            if (TSharedPtr<FAIDMConfigLoader> Loader = WeakThis.Pin())
+            {
+                Loader->Publish(NewConfig, KeyFileTime, ConfigFileTime);
+            }
+        });
+    });
+}
+
+TSharedRef<FAIDMConfig> FAIDMConfigLoader::LoadAndValidate(const FAIDMConfig& Defaults)
+{
+    using namespace AIDMConfigPrivate;
+
+    TSharedRef<FAIDMConfig> Result = MakeShared<FAIDMConfig>(Defaults);
+
+    // api_key.txt (키만)
+    FString FileKey;
+    if (FFileHelper::LoadFileToString(FileKey, *GetAPIKeyFilePath()))
+    {
+        Result->APIKey = FileKey.TrimStartAndEnd();
+    }
+
+    // aidm_config.json
+    FString ConfigJson;
+    if (FFileHelper::LoadFileToString(ConfigJson, *GetConfigFilePath()))
+    {
+        TSharedPtr<FJsonObject> JsonObject;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ConfigJson);
+        if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
+        {
+            JsonObject->TryGetStringField(TEXT("api_key"), Result->APIKey);
+            JsonObject->TryGetStringField(TEXT("endpoint"), Result->Endpoint);
+            JsonObject->TryGetStringField(TEXT("model"), Result->Model);
+            JsonObject->TryGetNumberField(TEXT("max_tokens"), Result->MaxTokens);
+            JsonObject->TryGetStringField(TEXT("hedge_endpoint"), Result->HedgeEndpoint);
+            JsonObject->TryGetStringField(TEXT("hedge_model"), Result->HedgeModel);
+
+            const TSharedPtr<FJsonObject>* RoutesObject = nullptr;
+            if (JsonObject->TryGetObjectField(TEXT("routes"), RoutesObject))
+            {
+                for (EAIModelRoute Route : ConfigurableRoutes)
+                {
+                    const TSharedPtr<FJsonObject>* RouteObject = nullptr;
+                    if ((*RoutesObject)->TryGetObjectField(GetModelRouteName(Route), RouteObject))
+                    {
+                        ReadRouteJson(**RouteObject, Result->Routes[static_cast<int32>(Route)]);
+                    }
+                }
+            }
+
+            double Number = 0.0;
+            if (JsonObject->TryGetNumberField(TEXT("temperature"), Number))
+            {
+                Result->Temperature = static_cast<float>(Number);
+            }
+            if (JsonObject->TryGetNumberField(TEXT("timeout_seconds"), Number))
+            {
+                Result->RequestTimeoutSeconds = static_cast<float>(Number);
+            }
+        }
+        else
+        {
+            Result->Warnings.Add(FString::Printf(TEXT("%s 파싱 실패 - 무시"), *GetConfigFilePath()));
+        }
+    }
+
+    // 환경 변수 (배포 서버용)
+    ReadEnvironment(TEXT("OPENAI_API_KEY"), Result->APIKey);
+    ReadEnvironment(TEXT("AIDM_API_KEY"), Result->APIKey);
+    ReadEnvironment(TEXT("AIDM_ENDPOINT"), Result->Endpoint);
+    ReadEnvironment(TEXT("AIDM_MODEL"), Result->Model);
+
+    // 검증 (잘못된 값은 기본값으로)
+    Result->APIKey.TrimStartAndEndInline();
+    if (!Result->APIKey.IsEmpty() && !(Result->APIKey.StartsWith(TEXT("sk-")) && Result->APIKey.Len() > 20))
+    {
+        Result->Warnings.Add(TEXT("API 키 형식이 잘못됨 ('sk-'로 시작하고 20자보다 길어야 함)"));
+        Result->APIKey.Reset();
+    }
+    else if (Result->APIKey.IsEmpty())
+    {
+        Result->Warnings.Add(FString::Printf(TEXT("API 키 없음 (%s 또는 OPENAI_API_KEY)"), *GetAPIKeyFilePath()));
+    }
+
+    const FAIDMConfig Fallback;
+    auto IsAllowedEndpoint = [](const FString& URL)
+    {
+        return URL.StartsWith(TEXT("https://")) || URL.StartsWith(TEXT("http://localhost")) || URL.StartsWith(TEXT("http://127.0.0.1"));
+    };
+    if (!IsAllowedEndpoint(Result->Endpoint))
+    {
+        Result->Warnings.Add(FString::Printf(TEXT("엔드포인트 %s 사용 불가 - 기본값 사용"), *Result->Endpoint));
+        Result->Endpoint = Fallback.Endpoint;
+    }
+    Result->HedgeEndpoint.TrimStartAndEndInline();
+    if (!Result->HedgeEndpoint.IsEmpty() && !IsAllowedEndpoint(Result->HedgeEndpoint))
+    {
+        Result->Warnings.Add(FString::Printf(TEXT("헤지 엔드포인트 %s 사용 불가 - 주 엔드포인트 사용"), *Result->HedgeEndpoint));
+        Result->HedgeEndpoint.Reset();
+    }
+    Result->HedgeModel.TrimStartAndEndInline();
+
+    // 경로 값 0 / 음수는 기본값 사용
+    for (FAIModelRoute& Route : Result->Routes)
+    {
+        Route.Model.TrimStartAndEndInline();
+        Route.MaxTokens = FMath::Clamp(Route.MaxTokens, 0, 4096);
+        Route.Temperature = FMath::Min(Route.Temperature, 2.0f);
+        Route.InputCostPer1K = FMath::Max(Route.InputCostPer1K, 0.0f);
+        Route.OutputCostPer1K = FMath::Max(Route.OutputCostPer1K, 0.0f);
+    }
+    if (Result->Model.TrimStartAndEnd().IsEmpty())
+    {
+        Result->Model = Fallback.Model;
+    }
+    Result->MaxTokens = FMath::Clamp(Result->MaxTokens, 1, 4096);
+    Result->Temperature = FMath::Clamp(Result->Temperature, 0.0f, 2.0f);
+    Result->RequestTimeoutSeconds = FMath::Max(Result->RequestTimeoutSeconds, 1.0f);
+
+    return Result;
+}
+
+void FAIDMConfigLoader::Publish(const TSharedRef<const FAIDMConfig>& NewConfig, const FDateTime& KeyFileTime, const FDateTime& ConfigFileTime)
+{
+    bLoadInFlight = false;
+    LoadedKeyFileTime = KeyFileTime;
+    LoadedConfigFileTime = ConfigFileTime;
+
+    for (const FString& Warning : NewConfig->Warnings)
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("AI 설정: %s"), *Warning);
+    }
+    UE_LOG(LogAIDM, Log, TEXT("AI 설정 로드: 모델 %s (요약 %s), max_tokens %d, API 키 %s"),
+        *NewConfig->GetRoute(EAIModelRoute::Narration).Model, *NewConfig->GetRoute(EAIModelRoute::Summary).Model,
+        NewConfig->GetRoute(EAIModelRoute::Narration).MaxTokens, NewConfig->APIKey.IsEmpty() ? TEXT("없음") : TEXT("있음"));
+
+    Config = NewConfig;
+    ConfigLoadedEvent.Broadcast(NewConfig);
+
+    if (bReloadQueued)
+    {
+        bReloadQueued = false;
+        Reload();
+    }
+}
+
+bool FAIDMConfigLoader::PollFiles(float DeltaTime)
+{
+    if (bLoadInFlight || bPollInFlight)
+    {
+        return true;
+    }
+    bPollInFlight = true;
+
+    // 파일 시각 확인도 게임 스레드 밖에서
+    TWeakPtr<FAIDMConfigLoader> WeakThis = AsShared();
+    const FDateTime KnownKeyFileTime = LoadedKeyFileTime;
+    const FDateTime KnownConfigFileTime = LoadedConfigFileTime;
+    Async(EAsyncExecution::ThreadPool, [WeakThis, KnownKeyFileTime, KnownConfigFileTime]()
+    {
+        const bool bChanged = AIDMConfigPrivate::GetFileTime(GetAPIKeyFilePath()) != KnownKeyFileTime
+            || AIDMConfigPrivate::GetFileTime(GetConfigFilePath()) != KnownConfigFileTime;
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, bChanged]()
+        {
+            if (TSharedPtr<FAIDMConfigLoader> Loader = WeakThis.Pin())
+            {
+                Loader->bPollInFlight = false;
+                if (bChanged)
+                {
+                    UE_LOG(LogAIDM, Log, TEXT("AI 설정 파일 변경 감지 - 다시 로드"));
+                    Loader->Reload();
+                }
+            }
+        });
+    });
+
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "AIModelRoute.h"
+
+// AI 설정 스냅샷 (로드 후에는 바꾸지 않고 새 스냅샷으로 교체)
+struct AI_DUNGEON_MASTER_API FAIDMConfig
+{
+    FString APIKey;
+    FString Endpoint = TEXT("https://api.openai.com/v1/chat/completions");
+    FString Model = TEXT("gpt-3.5-turbo");
+    int32 MaxTokens = 100;
+    float Temperature = 0.7f;
+    float RequestTimeoutSeconds = 60.0f;
+
+    // 헤지 요청 대상 (비어 있으면 Endpoint/Model)
+    FString HedgeEndpoint;
+    FString HedgeModel;
+
+    // 요청 경로별 모델, 한도, 비용 (ini <경로>Model 등, JSON "routes": { "summary": { "model": ... } })
+    FAIModelRoute Routes[static_cast<int32>(EAIModelRoute::Count)];
+
+    // 빈 값을 기본값으로 채운 경로 설정 (서술 경로의 기본 한도는 MaxTokens/Temperature)
+    FAIModelRoute GetRoute(EAIModelRoute Route) const;
+
+    // 검증 결과 (로드 스레드에서 채움)
+    TArray<FString> Warnings;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnAIDMConfigLoaded, const TSharedRef<const FAIDMConfig>& /*Config*/);
+
+/**
+ * AI 설정을 백그라운드에서 읽고 검증하는 로더
+ * 우선순위: 환경 변수 > aidm_config.json > api_key.txt(키만) > DefaultGame.ini [AIDM]
+ * 파일 수정 시각을 주기적으로(백그라운드에서) 확인해 바뀌면 다시 로드한다.
+ * 스냅샷 교체와 OnConfigLoaded는 게임 스레드에서만 일어난다.
+ */
+class AI_DUNGEON_MASTER_API FAIDMConfigLoader : public TSharedFromThis<FAIDMConfigLoader>
+{
+public:
+    // 첫 로드 시작 (ini 값은 게임 스레드에서 메모리로만 읽음), PollInterval 0 이하면 감시 안 함
+    void Start(float PollInterval = 2.0f);
+    void Stop();
+
+    // 파일 변경과 관계없이 다시 로드
+    void Reload();
+
+    bool IsLoaded() const { return Config.IsValid(); }
+    TSharedPtr<const FAIDMConfig> GetConfig() const { return Config; }
+
+    FOnAIDMConfigLoaded& OnConfigLoaded() { return ConfigLoadedEvent; }
+
+    static FString GetAPIKeyFilePath();
+    static FString GetConfigFilePath();
+
+private:
+    // 백그라운드 스레드: 환경 변수와 파일을 읽어 검증
+    static TSharedRef<FAIDMConfig> LoadAndValidate(const FAIDMConfig& Defaults);
+
+    // 게임 스레드: 새 스냅샷 적용
+    void Publish(const TSharedRef<const FAIDMConfig>& NewConfig, const FDateTime& KeyFileTime, const FDateTime& ConfigFileTime);
+
+    bool PollFiles(float DeltaTime);
+
+    FAIDMConfig Defaults;
+    TSharedPtr<const FAIDMConfig> Config;
+    FOnAIDMConfigLoaded ConfigLoadedEvent;
+
+    // 마지막 로드 시점의 파일 수정 시각 (없으면 MinValue)
+    FDateTime LoadedKeyFileTime;
+    FDateTime LoadedConfigFileTime;
+
+    bool bLoadInFlight = false;
+    bool bPollInFlight = false;
+    bool bReloadQueued = false;
+
+    FTSTicker::FDelegateHandle PollHandle;
+};
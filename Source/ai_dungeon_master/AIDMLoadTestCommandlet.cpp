@@ -0,0 +1,390 @@
+#include "AIDMLoadTestCommandlet.h"
+#include "AIManager.h"
+#include "AIChatBackend.h"
+#include "AIMockBackend.h"
+#include "AIHedgedBackend.h"
+#include "AIDMLog.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "TimerManager.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace AIDMLoadTestPrivate
+{
+    // -endpoint: 설정 파일의 주소와 키가 명령줄 값을 덮어쓰지 않도록 고정
+    class FFixedEndpointBackend : public IAIChatBackend
+    {
+    public:
+        explicit FFixedEndpointBackend(TSharedRef<IAIChatBackend> InInner) : Inner(InInner) {}
+
+        virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) override
+        {
+            Inner->SendRequest(Request, OnChunk, OnComplete);
+        }
+        virtual bool RequiresAPIKey() const override { return false; }
+        virtual void WarmConnection(float KeepAliveInterval) override { Inner->WarmConnection(KeepAliveInterval); }
+        virtual FAIConnectionStats GetConnectionStats() const override { return Inner->GetConnectionStats(); }
+        virtual const TCHAR* GetName() const override { return Inner->GetName(); }
+
+    private:
+        TSharedRef<IAIChatBackend> Inner;
+    };
+}
+
+// ---------------------------------------------------------------------------
+// UAIDMLoadTestSession
+// ---------------------------------------------------------------------------
+
+void UAIDMLoadTestSession::Initialize(UAIConversationSession* InSession, const TArray<FString>* InScript, FAILatencyHistogram* InLatencies, int32 StartLine, double FirstSendTime, float InThinkTime)
+{
+    Session = InSession;
+    Script = InScript;
+    Latencies = InLatencies;
+    ScriptLine = StartLine;
+    NextSendTime = FirstSendTime;
+    ThinkTime = InThinkTime;
+
+    Session->OnAIResponse.AddDynamic(this, &UAIDMLoadTestSession::OnResponse);
+}
+
+void UAIDMLoadTestSession::Tick(double Now)
+{
+    if (bWaiting || Now < NextSendTime || !Session || !Script || Script->Num() == 0)
+    {
+        return;
+    }
+
+    bWaiting = true;
+    SentTime = Now;
+
+    const FString& Line = (*Script)[ScriptLine % Script->Num()];
+    ScriptLine++;
+    Session->SendMessage(Line);
+}
+
+void UAIDMLoadTestSession::OnResponse(bool bSuccess, const FString& Response)
+{
+    const double Now = FPlatformTime::Seconds();
+
+    if (bSuccess)
+    {
+        Responses++;
+        Latencies->Add(static_cast<float>((Now - SentTime) * 1000.0));
+    }
+    else
+    {
+        Errors++;
+    }
+
+    // 생각 시간은 평균의 0.5~1.5배로 흩뜨려 요청이 한 프레임에 몰리지 않게 함
+    bWaiting = false;
+    NextSendTime = Now + ThinkTime * FMath::FRandRange(0.5f, 1.5f);
+}
+
+// ---------------------------------------------------------------------------
+// UAIDMLoadTestCommandlet
+// ---------------------------------------------------------------------------
+
+UAIDMLoadTestCommandlet::UAIDMLoadTestCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UAIDMLoadTestCommandlet::Main(const FString& Params)
+{
+    FString SessionsParam = TEXT("1,10,100,1000");
+    FParse::Value(*Params, TEXT("sessions="), SessionsParam);
+
+    TArray<FString> SessionTokens;
+    SessionsParam.ParseIntoArray(SessionTokens, TEXT(","));
+
+    float Duration = 20.0f;
+    FParse::Value(*Params, TEXT("duration="), Duration);
+
+    int32 FramesPerSecond = 60;
+    FParse::Value(*Params, TEXT("fps="), FramesPerSecond);
+    const float FrameTime = 1.0f / FMath::Max(1, FramesPerSecond);
+
+    float ThinkTime = 2.0f;
+    FParse::Value(*Params, TEXT("thinktime="), ThinkTime);
+
+    FString ScriptPath;
+    FParse::Value(*Params, TEXT("script="), ScriptPath);
+
+    FString OutPath;
+    FParse::Value(*Params, TEXT("out="), OutPath);
+
+    // 모의 백엔드 설정
+    FAIMockBackendSettings MockSettings;
+    FString LatencyModel;
+    if (FParse::Value(*Params, TEXT("latency="), LatencyModel))
+    {
+        if (LatencyModel == TEXT("constant"))
+        {
+            MockSettings.LatencyModel = EAIMockLatencyModel::Constant;
+        }
+        else if (LatencyModel == TEXT("uniform"))
+        {
+            MockSettings.LatencyModel = EAIMockLatencyModel::Uniform;
+        }
+    }
+    FParse::Value(*Params, TEXT("mean="), MockSettings.MeanMs);
+    FParse::Value(*Params, TEXT("spread="), MockSettings.SpreadMs);
+    FParse::Value(*Params, TEXT("maxconcurrent="), MockSettings.MaxConcurrent);
+    FParse::Value(*Params, TEXT("errorrate="), MockSettings.ErrorRate);
+    const bool bStream = FParse::Param(*Params, TEXT("stream"));
+
+    // 헤지: 두 번째 모의 백엔드 (같은 분포, 다른 난수)
+    const bool bHedge = FParse::Param(*Params, TEXT("hedge"));
+    FAIMockBackendSettings SecondaryMockSettings = MockSettings;
+    SecondaryMockSettings.Seed = MockSettings.Seed + 1;
+    FParse::Value(*Params, TEXT("hedgemean="), SecondaryMockSettings.MeanMs);
+    FParse::Value(*Params, TEXT("hedgespread="), SecondaryMockSettings.SpreadMs);
+
+    // 실제 HTTP 경로 (연결 미리 맺기/유지 측정)
+    FString Endpoint;
+    FParse::Value(*Params, TEXT("endpoint="), Endpoint);
+    FString EndpointAPIKey;
+    FParse::Value(*Params, TEXT("apikey="), EndpointAPIKey);
+    float KeepAliveInterval = 25.0f;
+    FParse::Value(*Params, TEXT("keepalive="), KeepAliveInterval);
+
+    FAIHedgeSettings HedgeSettings;
+    FParse::Value(*Params, TEXT("hedgepercentile="), HedgeSettings.HedgePercentile);
+    FParse::Value(*Params, TEXT("deadline="), HedgeSettings.HardDeadlineMs);
+    HedgeSettings.FallbackResponse = TEXT("The dungeon master pauses, lost in thought.");
+
+    TArray<FString> Script;
+    LoadScript(ScriptPath, Script);
+
+    // 요청마다 찍히는 로그가 측정을 흐리지 않도록 경고 이상만 출력
+    if (!FParse::Param(*Params, TEXT("verbose")))
+    {
+        LogAIDM.SetVerbosity(ELogVerbosity::Warning);
+    }
+
+    if (Endpoint.IsEmpty())
+    {
+        UE_LOG(LogAIDM, Display, TEXT("AIDM 부하 테스트: 단계 %s, 단계당 %.0f초, 지연 %.0f±%.0f ms, 동시 처리 %d, 생각 시간 %.1f초"),
+            *SessionsParam, Duration, MockSettings.MeanMs, MockSettings.SpreadMs, MockSettings.MaxConcurrent, ThinkTime);
+    }
+    else
+    {
+        UE_LOG(LogAIDM, Display, TEXT("AIDM 부하 테스트: 단계 %s, 단계당 %.0f초, 엔드포인트 %s, 연결 유지 %.0f초, 생각 시간 %.1f초"),
+            *SessionsParam, Duration, *Endpoint, KeepAliveInterval, ThinkTime);
+    }
+    UE_LOG(LogAIDM, Display, TEXT("%8s %10s %8s %10s %10s %10s %10s %10s %10s %10s %10s %12s"),
+        TEXT("sessions"), TEXT("responses"), TEXT("errors"), TEXT("resp/s"), TEXT("e2e p50"), TEXT("e2e p95"),
+        TEXT("queue p50"), TEXT("queue p95"), TEXT("frame avg"), TEXT("frame p95"), TEXT("frame max"), TEXT("KB/session"));
+
+    FAIDMLoadTestReport Report;
+
+    for (const FString& Token : SessionTokens)
+    {
+        const int32 NumSessions = FCString::Atoi(*Token);
+        if (NumSessions <= 0)
+        {
+            continue;
+        }
+
+        // 단계마다 새 백엔드 (연결과 통계를 단계 사이에 이어 쓰지 않음)
+        TSharedPtr<FAIMockBackend> MockBackend;
+        TSharedPtr<IAIChatBackend> Backend;
+        if (Endpoint.IsEmpty())
+        {
+            MockBackend = MakeShared<FAIMockBackend>(MockSettings);
+            Backend = MockBackend;
+        }
+        else
+        {
+            TSharedRef<FAIOpenAIBackend> HttpBackend = MakeShared<FAIOpenAIBackend>(Endpoint);
+            HttpBackend->SetAPIKey(EndpointAPIKey);
+            Backend = MakeShared<AIDMLoadTestPrivate::FFixedEndpointBackend>(HttpBackend);
+        }
+        TSharedPtr<IAIChatBackend> ManagerBackend = Backend;
+        TSharedPtr<FAIHedgedBackend> HedgedBackend;
+        if (bHedge)
+        {
+            HedgedBackend = MakeShared<FAIHedgedBackend>(Backend, MakeShared<FAIMockBackend>(SecondaryMockSettings), HedgeSettings);
+            ManagerBackend = HedgedBackend;
+        }
+        FAILatencyHistogram Latencies(65536);
+        FAILatencyHistogram FrameTimes(65536);
+
+        const uint64 MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+        // 공유 매니저 하나 (디스크 세션 로그와 자동 테스트는 끔)
+        UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, *FString::Printf(TEXT("AIDMLoadTestWorld_%d"), NumSessions));
+        AAIManager* Manager = World->SpawnActorDeferred<AAIManager>(AAIManager::StaticClass(), FTransform::Identity);
+        Manager->bPersistSession = false;
+        Manager->bRunStartupSelfTest = false;
+        Manager->bEnableLocalIntents = false;   // 스크립트의 "look around"도 모델 경로로 측정
+        Manager->bStreamResponses = bStream;
+        Manager->bPrewarmConnection = true;
+        Manager->KeepAliveInterval = KeepAliveInterval;
+        Manager->SetBackend(ManagerBackend);
+        Manager->FinishSpawning(FTransform::Identity);
+        Manager->DispatchBeginPlay();
+
+        // 플레이어마다 대화 세션 하나
+        TArray<UAIDMLoadTestSession*> Sessions;
+        Sessions.Reserve(NumSessions);
+
+        const double StartTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < NumSessions; i++)
+        {
+            UAIConversationSession* ConversationSession = Manager->GetOrCreateSession(FName(*FString::Printf(TEXT("LoadTest%d"), i)));
+
+            UAIDMLoadTestSession* Session = NewObject<UAIDMLoadTestSession>(GetTransientPackage());
+            Session->AddToRoot();
+            Session->Initialize(ConversationSession, &Script, &Latencies, i, StartTime + FMath::FRandRange(0.0f, ThinkTime), ThinkTime);
+            Sessions.Add(Session);
+        }
+
+        // 고정 프레임 루프: 프레임마다 티커, 타이머, 세션 입력을 처리하고 남는 시간은 대기
+        const double EndTime = StartTime + Duration;
+        double LastFrameTime = StartTime;
+        double FrameTimeSum = 0.0;
+        int32 FrameCount = 0;
+        float FrameTimeMax = 0.0f;
+
+        while (FPlatformTime::Seconds() < EndTime)
+        {
+            const double FrameStart = FPlatformTime::Seconds();
+            const float DeltaTime = static_cast<float>(FrameStart - LastFrameTime);
+            LastFrameTime = FrameStart;
+
+            FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+            FTSTicker::GetCoreTicker().Tick(DeltaTime);
+            World->GetTimerManager().Tick(DeltaTime);
+            for (UAIDMLoadTestSession* Session : Sessions)
+            {
+                Session->Tick(FrameStart);
+            }
+
+            const float WorkMs = static_cast<float>((FPlatformTime::Seconds() - FrameStart) * 1000.0);
+            FrameTimes.Add(WorkMs);
+            FrameTimeSum += WorkMs;
+            FrameTimeMax = FMath::Max(FrameTimeMax, WorkMs);
+            FrameCount++;
+
+            const float Remaining = FrameTime - WorkMs / 1000.0f;
+            if (Remaining > 0.0f)
+            {
+                FPlatformProcess::Sleep(Remaining);
+            }
+        }
+
+        const uint64 MemoryAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+        FAIDMLoadTestStepResult Step;
+        Step.Sessions = NumSessions;
+        for (const UAIDMLoadTestSession* Session : Sessions)
+        {
+            Step.Responses += Session->Responses;
+            Step.Errors += Session->Errors;
+        }
+        Step.ThroughputPerSec = Step.Responses / FMath::Max(Duration, UE_KINDA_SMALL_NUMBER);
+        Step.LatencyP50Ms = Latencies.GetPercentile(50.0f);
+        Step.LatencyP95Ms = Latencies.GetPercentile(95.0f);
+        if (MockBackend)
+        {
+            Step.QueueDelayP50Ms = MockBackend->GetQueueDelayPercentile(50.0f);
+            Step.QueueDelayP95Ms = MockBackend->GetQueueDelayPercentile(95.0f);
+        }
+        const FAIConnectionStats ConnectionStats = Backend->GetConnectionStats();
+        Step.IdleWindowRate = ConnectionStats.GetIdleWindowRate();
+        Step.FirstByteWarmMs = ConnectionStats.GetAvgFirstByteMs(true);
+        Step.FirstByteColdMs = ConnectionStats.GetAvgFirstByteMs(false);
+        Step.HandshakeMs = ConnectionStats.GetObservedHandshakeMs();
+        Step.FrameAvgMs = FrameCount > 0 ? static_cast<float>(FrameTimeSum / FrameCount) : 0.0f;
+        Step.FrameP95Ms = FrameTimes.GetPercentile(95.0f);
+        Step.FrameMaxMs = FrameTimeMax;
+        Step.MemoryPerSessionKB = MemoryAfter > MemoryBefore ? static_cast<double>(MemoryAfter - MemoryBefore) / 1024.0 / NumSessions : 0.0;
+        if (HedgedBackend)
+        {
+            Step.HedgedRequests = HedgedBackend->GetStats().Hedged;
+            Step.SecondaryWins = HedgedBackend->GetStats().SecondaryWins;
+            Step.DeadlineFallbacks = HedgedBackend->GetStats().DeadlineFallbacks;
+        }
+        Report.Steps.Add(Step);
+
+        UE_LOG(LogAIDM, Display, TEXT("%8d %10d %8d %10.1f %10.1f %10.1f %10.1f %10.1f %10.2f %10.2f %10.2f %12.1f"),
+            Step.Sessions, Step.Responses, Step.Errors, Step.ThroughputPerSec, Step.LatencyP50Ms, Step.LatencyP95Ms,
+            Step.QueueDelayP50Ms, Step.QueueDelayP95Ms, Step.FrameAvgMs, Step.FrameP95Ms, Step.FrameMaxMs, Step.MemoryPerSessionKB);
+        if (HedgedBackend)
+        {
+            UE_LOG(LogAIDM, Display, TEXT("%8s hedged %d (%.1f%%), secondary wins %d, deadline fallbacks %d, primary cancelled %d"), TEXT(""),
+                Step.HedgedRequests, HedgedBackend->GetStats().GetHedgeRate() * 100.0f, Step.SecondaryWins, Step.DeadlineFallbacks,
+                MockBackend ? MockBackend->GetCancelledCount() : 0);
+        }
+        if (!MockBackend)
+        {
+            UE_LOG(LogAIDM, Display, TEXT("%8s idle-window %.0f%% (prewarm %d, keep-alive %d), first byte in-window %.0f ms / out %.0f ms, handshake %.0f ms"), TEXT(""),
+                Step.IdleWindowRate * 100.0f, ConnectionStats.Prewarms, ConnectionStats.KeepAlivePings,
+                Step.FirstByteWarmMs, Step.FirstByteColdMs, Step.HandshakeMs);
+        }
+
+        // 정리 (남은 모의 응답은 백엔드가 사라지면 버려짐)
+        for (UAIDMLoadTestSession* Session : Sessions)
+        {
+            Session->RemoveFromRoot();
+        }
+        Sessions.Reset();
+        World->DestroyWorld(false);
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    if (!OutPath.IsEmpty())
+    {
+        FString ReportJson;
+        FJsonObjectConverter::UStructToJsonObjectString(Report, ReportJson);
+        FFileHelper::SaveStringToFile(ReportJson, *OutPath);
+    }
+
+    return 0;
+}
+
+void UAIDMLoadTestCommandlet::LoadScript(const FString& ScriptPath, TArray<FString>& OutLines)
+{
+    OutLines.Reset();
+
+    if (!ScriptPath.IsEmpty())
+    {
+        TArray<FString> Lines;
+        FFileHelper::LoadFileToStringArray(Lines, *ScriptPath);
+        for (const FString& Line : Lines)
+        {
+            if (!Line.TrimStartAndEnd().IsEmpty())
+            {
+                OutLines.Add(Line);
+            }
+        }
+    }
+
+    if (OutLines.Num() == 0)
+    {
+        static const TCHAR* DefaultScript[] =
+        {
+            TEXT("I look around the room"),
+            TEXT("I open the wooden door"),
+            TEXT("I attack the goblin with my sword"),
+            TEXT("I search the body for loot"),
+            TEXT("I talk to the old merchant"),
+            TEXT("I cast a fireball at the skeletons"),
+            TEXT("I drink a healing potion"),
+            TEXT("I sneak past the sleeping troll")
+        };
+        for (const TCHAR* Line : DefaultScript)
+        {
+            OutLines.Add(Line);
+        }
+    }
+}
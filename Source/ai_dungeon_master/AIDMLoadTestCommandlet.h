@@ -0,0 +1,155 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "AIRequestTrace.h"
+#include "AIDMLoadTestCommandlet.generated.h"
+
+class UAIConversationSession;
+
+// 세션 수 한 단계의 결과
+USTRUCT()
+struct FAIDMLoadTestStepResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Sessions = 0;
+
+    UPROPERTY()
+    int32 Responses = 0;            // 성공한 응답 수
+
+    UPROPERTY()
+    int32 Errors = 0;
+
+    UPROPERTY()
+    double ThroughputPerSec = 0.0;  // 초당 성공 응답
+
+    UPROPERTY()
+    float LatencyP50Ms = 0.0f;      // 입력 -> 응답 (대기열 포함)
+
+    UPROPERTY()
+    float LatencyP95Ms = 0.0f;
+
+    UPROPERTY()
+    float QueueDelayP50Ms = 0.0f;   // 모의 백엔드 대기열 (-endpoint면 0)
+
+    UPROPERTY()
+    float QueueDelayP95Ms = 0.0f;
+
+    UPROPERTY()
+    float FrameAvgMs = 0.0f;        // 프레임당 게임 스레드 작업 시간
+
+    UPROPERTY()
+    float FrameP95Ms = 0.0f;
+
+    UPROPERTY()
+    float FrameMaxMs = 0.0f;
+
+    UPROPERTY()
+    double MemoryPerSessionKB = 0.0;
+
+    UPROPERTY()
+    int32 HedgedRequests = 0;       // -hedge: 보조 백엔드에도 보낸 요청
+
+    UPROPERTY()
+    int32 SecondaryWins = 0;
+
+    UPROPERTY()
+    int32 DeadlineFallbacks = 0;
+
+    UPROPERTY()
+    float IdleWindowRate = 0.0f;    // -endpoint: 가정한 유휴 시간 안에 보낸 요청 비율 (시간 기준)
+
+    UPROPERTY()
+    float FirstByteWarmMs = 0.0f;   // -endpoint: 유휴 창 안 요청의 첫 바이트 평균
+
+    UPROPERTY()
+    float FirstByteColdMs = 0.0f;
+
+    UPROPERTY()
+    float HandshakeMs = 0.0f;       // -endpoint: 새 연결 HEAD와 유지 HEAD의 왕복 시간 차이
+};
+
+// 부하 테스트 결과 파일
+USTRUCT()
+struct FAIDMLoadTestReport
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FAIDMLoadTestStepResult> Steps;
+};
+
+/**
+ * 모의 플레이어 한 명: 대본의 입력을 생각 시간 간격으로 보내고 응답을 기다린다 (동시에 한 요청만)
+ */
+UCLASS()
+class UAIDMLoadTestSession : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    void Initialize(UAIConversationSession* InSession, const TArray<FString>* InScript, FAILatencyHistogram* InLatencies, int32 StartLine, double FirstSendTime, float InThinkTime);
+
+    // 보낼 시간이 되었으면 다음 입력 전송
+    void Tick(double Now);
+
+    UFUNCTION()
+    void OnResponse(bool bSuccess, const FString& Response);
+
+    int32 Responses = 0;
+    int32 Errors = 0;
+
+private:
+    UPROPERTY()
+    TObjectPtr<UAIConversationSession> Session;
+
+    // 커맨드렛이 소유 (모든 세션이 공유)
+    const TArray<FString>* Script = nullptr;
+    FAILatencyHistogram* Latencies = nullptr;
+
+    int32 ScriptLine = 0;
+    float ThinkTime = 2.0f;
+    double NextSendTime = 0.0;
+    double SentTime = 0.0;
+    bool bWaiting = false;
+};
+
+/**
+ * AAIManager 하나에 세션 N개를 만들어 모의 LLM 백엔드로 다중 세션 부하를 만들고 확장성을 측정 (GPU 없이 실행)
+ *
+ * UnrealEditor-Cmd ai_dungeon_master.uproject -run=AIDMLoadTest -nullrhi [옵션]
+ *   -sessions=<N,N,...>  단계별 세션 수 (기본 1,10,100,1000)
+ *   -duration=<초>       단계당 측정 시간 (기본 20)
+ *   -fps=<N>             게임 스레드 프레임 속도 (기본 60)
+ *   -thinktime=<초>      응답 후 다음 입력까지 평균 시간 (기본 2)
+ *   -script=<파일>       한 줄에 플레이어 입력 하나 (없으면 기본 대본)
+ *   -latency=<모델>      constant | uniform | lognormal (기본 lognormal)
+ *   -mean=<ms> -spread=<ms>  지연 분포 (기본 800, 400)
+ *   -maxconcurrent=<N>   백엔드 동시 처리 수, 넘으면 대기열 (기본 0 = 무제한)
+ *   -errorrate=<비율>    HTTP 500 응답 비율 (기본 0)
+ *   -stream              스트리밍 응답
+ *   -hedge               지연을 따로 주입한 두 번째 모의 백엔드로 헤지 요청
+ *   -hedgemean=<ms> -hedgespread=<ms>  두 번째 백엔드 지연 분포 (기본 주 백엔드와 같음)
+ *   -hedgepercentile=<N> 헤지 시점 백분위 (기본 95)
+ *   -deadline=<ms>       응답 마감 시간, 넘으면 부분/대체 응답 (기본 15000, 0 = 없음)
+ *   -endpoint=<url>      모의 백엔드 대신 이 주소의 OpenAI 호환 서버로 HTTP 요청 (설정 파일 주소 무시)
+ *                        로컬 HTTPS 서버(예: TLS 프록시 뒤의 로컬 모델 서버)를 가리키면 미리 연결/유지의 효과를 관찰할 수 있음
+ *   -apikey=<키>         -endpoint 요청에 붙일 키 (기본 없음)
+ *   -keepalive=<초>      -endpoint 연결 유지 간격 (기본 25, 0 = 미리 연결만)
+ *   -out=<파일>          결과 JSON 저장
+ */
+UCLASS()
+class UAIDMLoadTestCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UAIDMLoadTestCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    static void LoadScript(const FString& ScriptPath, TArray<FString>& OutLines);
+};
@@ -0,0 +1,213 @@
+#include "AIDMLog.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/OutputDeviceRedirector.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY(LogAIDM);
+
+#if !UE_BUILD_SHIPPING
+TAutoConsoleVariable<bool> CVarAIDMScreenMessages(
+    TEXT("aidm.ScreenMessages"),
+    false,
+    TEXT("AI 던전 마스터 화면 디버그 메시지 표시"),
+    ECVF_Default);
+#endif
+
+FAIDMLogSink& FAIDMLogSink::Get()
+{
+    static FAIDMLogSink Instance;
+    return Instance;
+}
+
+FAIDMLogSink::FAIDMLogSink()
+{
+    Slots = new FSlot[Capacity];
+    for (int32 i = 0; i < Capacity; i++)
+    {
+        Slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+FAIDMLogSink::~FAIDMLogSink()
+{
+    // 정적 소멸 시점에는 GLog가 없을 수 있으므로 기록 없이 스레드만 정리
+    if (Thread)
+    {
+        bStopRequested = true;
+        WakeEvent->Trigger();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+    }
+    delete[] Slots;
+}
+
+void FAIDMLogSink::Start()
+{
+    if (Thread)
+    {
+        return;
+    }
+
+    bStopRequested = false;
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("AIDMLogSink"), 0, TPri_BelowNormal);
+    bRunning = Thread != nullptr;
+}
+
+void FAIDMLogSink::Stop()
+{
+    if (Thread)
+    {
+        bStopRequested = true;
+        WakeEvent->Trigger();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+    }
+    bRunning = false;
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+
+    // 스레드 없이 남은 이벤트 기록
+    Drain();
+}
+
+void FAIDMLogSink::Push(ELogVerbosity::Type Verbosity, const TCHAR* Event, std::initializer_list<FAIDMLogField> Fields)
+{
+    // 빈 슬롯 예약 (Vyukov 방식 bounded 큐)
+    uint64 Pos = EnqueuePos.load(std::memory_order_relaxed);
+    FSlot* Slot = nullptr;
+    for (;;)
+    {
+        Slot = &Slots[Pos & (Capacity - 1)];
+        const uint64 Sequence = Slot->Sequence.load(std::memory_order_acquire);
+        const int64 Diff = static_cast<int64>(Sequence) - static_cast<int64>(Pos);
+        if (Diff == 0)
+        {
+            if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (Diff < 0)
+        {
+            // 가득 참
+            DroppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            Pos = EnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    Slot->Cycles = FPlatformTime::Cycles64();
+    Slot->Verbosity = Verbosity;
+    Slot->Event = Event;
+    Slot->NumFields = 0;
+
+    int32 TextUsed = 0;
+    for (const FAIDMLogField& Field : Fields)
+    {
+        if (Slot->NumFields >= MaxFields)
+        {
+            break;
+        }
+
+        FSlotField& Out = Slot->Fields[Slot->NumFields++];
+        Out.Key = Field.Key;
+        Out.Type = Field.Type;
+        Out.IntValue = Field.IntValue;
+        Out.FloatValue = Field.FloatValue;
+        Out.TextOffset = static_cast<uint16>(TextUsed);
+        Out.TextLength = 0;
+
+        if (Field.Type == FAIDMLogField::EType::Text)
+        {
+            const int32 Length = FMath::Min(Field.TextValue.Len(), TextCapacity - TextUsed);
+            FMemory::Memcpy(Slot->Text + TextUsed, Field.TextValue.GetData(), Length * sizeof(TCHAR));
+            Out.TextLength = static_cast<uint16>(Length);
+            TextUsed += Length;
+        }
+    }
+
+    Slot->Sequence.store(Pos + 1, std::memory_order_release);
+
+    // 스레드가 없으면 (모듈 시작 전/종료 후) 바로 기록
+    if (!bRunning)
+    {
+        Drain();
+    }
+}
+
+uint32 FAIDMLogSink::Run()
+{
+    while (!bStopRequested)
+    {
+        WakeEvent->Wait(100);
+        Drain();
+    }
+    return 0;
+}
+
+void FAIDMLogSink::Drain()
+{
+    // 소비자는 하나만 (스레드가 없을 때 여러 스레드에서 호출될 수 있음)
+    FScopeLock Lock(&DrainCritical);
+
+    for (;;)
+    {
+        FSlot& Slot = Slots[DequeuePos & (Capacity - 1)];
+        if (Slot.Sequence.load(std::memory_order_acquire) != DequeuePos + 1)
+        {
+            break;
+        }
+
+        const FString Line = FormatSlot(Slot);
+        const double Time = FPlatformTime::ToSeconds64(Slot.Cycles) - GStartTime;
+        const ELogVerbosity::Type Verbosity = Slot.Verbosity;
+
+        Slot.Sequence.store(DequeuePos + Capacity, std::memory_order_release);
+        DequeuePos++;
+
+        GLog->Serialize(*Line, Verbosity, LogAIDM.GetCategoryName(), Time);
+    }
+
+    const int32 Dropped = DroppedCount.exchange(0, std::memory_order_relaxed);
+    if (Dropped > 0)
+    {
+        GLog->Serialize(*FString::Printf(TEXT("로그 버퍼 가득 참: 이벤트 %d개 버림"), Dropped), ELogVerbosity::Warning, LogAIDM.GetCategoryName());
+    }
+}
+
+FString FAIDMLogSink::FormatSlot(const FSlot& Slot)
+{
+    TStringBuilder<256> Builder;
+    Builder << Slot.Event;
+
+    for (int32 i = 0; i < Slot.NumFields; i++)
+    {
+        const FSlotField& Field = Slot.Fields[i];
+        Builder << TEXT(' ') << Field.Key << TEXT('=');
+
+        switch (Field.Type)
+        {
+        case FAIDMLogField::EType::Int:
+            Builder << Field.IntValue;
+            break;
+        case FAIDMLogField::EType::Float:
+            Builder.Appendf(TEXT("%.2f"), Field.FloatValue);
+            break;
+        case FAIDMLogField::EType::Text:
+            Builder << TEXT('"') << FStringView(Slot.Text + Field.TextOffset, Field.TextLength) << TEXT('"');
+            break;
+        }
+    }
+
+    return FString(Builder.ToView());
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/IConsoleManager.h"
+#include <atomic>
+#include <initializer_list>
+
+// AI 던전 마스터 전용 로그 카테고리
+// 쉬핑 빌드에서는 Warning보다 상세한 로그가 컴파일 단계에서 제거된다.
+#if UE_BUILD_SHIPPING
+DECLARE_LOG_CATEGORY_EXTERN(LogAIDM, Log, Warning);
+#else
+DECLARE_LOG_CATEGORY_EXTERN(LogAIDM, Log, All);
+#endif
+
+// 구조화된 로그 필드 (키 + 정수/실수/문자열 값)
+// 값은 그대로 링 버퍼에 복사되고 문자열 변환은 백그라운드 스레드에서 한다.
+struct AI_DUNGEON_MASTER_API FAIDMLogField
+{
+    enum class EType : uint8
+    {
+        Int,
+        Float,
+        Text
+    };
+
+    FAIDMLogField(const TCHAR* InKey, int32 Value) : Key(InKey), Type(EType::Int), IntValue(Value) {}
+    FAIDMLogField(const TCHAR* InKey, int64 Value) : Key(InKey), Type(EType::Int), IntValue(Value) {}
+    FAIDMLogField(const TCHAR* InKey, bool Value) : Key(InKey), Type(EType::Int), IntValue(Value ? 1 : 0) {}
+    FAIDMLogField(const TCHAR* InKey, float Value) : Key(InKey), Type(EType::Float), FloatValue(Value) {}
+    FAIDMLogField(const TCHAR* InKey, double Value) : Key(InKey), Type(EType::Float), FloatValue(Value) {}
+    FAIDMLogField(const TCHAR* InKey, const FString& Value) : Key(InKey), Type(EType::Text), TextValue(Value) {}
+    FAIDMLogField(const TCHAR* InKey, const TCHAR* Value) : Key(InKey), Type(EType::Text), TextValue(Value) {}
+
+    const TCHAR* Key;       // 정적 문자열만 사용 (포인터만 보관)
+    EType Type;
+    int64 IntValue = 0;
+    double FloatValue = 0.0;
+    FStringView TextValue;  // Push 중에만 유효
+};
+
+/**
+ * 구조화된 로그 이벤트를 잠금 없는 링 버퍼에 쌓고 백그라운드 스레드가 GLog로 내보내는 싱크
+ * 게임 스레드는 고정 크기 슬롯에 값을 복사만 하고, 문자열 포맷은 기록 스레드에서 한다.
+ * 버퍼가 가득 차면 이벤트를 버리고 개수만 센다 (게임 스레드는 절대 기다리지 않음).
+ */
+class AI_DUNGEON_MASTER_API FAIDMLogSink : public FRunnable
+{
+public:
+    static FAIDMLogSink& Get();
+
+    // 기록 스레드 시작/정지 (모듈 시작/종료 시)
+    void Start();
+    void Stop();
+
+    // 이벤트 추가 (여러 스레드에서 호출 가능)
+    void Push(ELogVerbosity::Type Verbosity, const TCHAR* Event, std::initializer_list<FAIDMLogField> Fields);
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Exit() override {}
+
+private:
+    FAIDMLogSink();
+    virtual ~FAIDMLogSink() override;
+
+    static constexpr int32 Capacity = 1024;     // 2의 거듭제곱
+    static constexpr int32 MaxFields = 6;
+    static constexpr int32 TextCapacity = 160;  // 슬롯당 문자열 필드 합계 (넘치면 잘림)
+
+    struct FSlotField
+    {
+        const TCHAR* Key;
+        FAIDMLogField::EType Type;
+        int64 IntValue;
+        double FloatValue;
+        uint16 TextOffset;
+        uint16 TextLength;
+    };
+
+    struct FSlot
+    {
+        std::atomic<uint64> Sequence;
+        uint64 Cycles;
+        ELogVerbosity::Type Verbosity;
+        const TCHAR* Event;
+        int32 NumFields;
+        FSlotField Fields[MaxFields];
+        TCHAR Text[TextCapacity];
+    };
+
+    // 링 버퍼 비우기 (기록 스레드)
+    void Drain();
+    static FString FormatSlot(const FSlot& Slot);
+
+    FSlot* Slots;
+    std::atomic<uint64> EnqueuePos{ 0 };
+    uint64 DequeuePos = 0;
+    FCriticalSection DrainCritical;
+    std::atomic<int32> DroppedCount{ 0 };
+
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bRunning{ false };
+    std::atomic<bool> bStopRequested{ false };
+};
+
+// 구조화된 이벤트 로그
+// 카테고리가 꺼져 있으면 필드 식도 평가하지 않는다.
+// 예: AIDM_EVENT(Log, "ResponseReceived", AIDM_FIELD("ms", ResponseMs), AIDM_FIELD("chars", Content.Len()));
+#define AIDM_FIELD(Key, Value) FAIDMLogField(TEXT(Key), Value)
+#define AIDM_EVENT(Verbosity, Event, ...) \
+    do \
+    { \
+        if (UE_LOG_ACTIVE(LogAIDM, Verbosity)) \
+        { \
+            FAIDMLogSink::Get().Push(ELogVerbosity::Verbosity, TEXT(Event), { __VA_ARGS__ }); \
+        } \
+    } while (0)
+
+// 화면 디버그 메시지 (쉬핑 빌드에서는 제거, aidm.ScreenMessages 0이면 메시지 식도 평가하지 않음)
+#if UE_BUILD_SHIPPING
+#define AIDM_SCREEN_MESSAGE(Duration, Color, Message)
+#else
+extern AI_DUNGEON_MASTER_API TAutoConsoleVariable<bool> CVarAIDMScreenMessages;
+#define AIDM_SCREEN_MESSAGE(Duration, Color, Message) \
+    do \
+    { \
+        if (GEngine && CVarAIDMScreenMessages.GetValueOnGameThread()) \
+        { \
+            GEngine->AddOnScreenDebugMessage(-1, Duration, Color, Message); \
+        } \
+    } while (0)
+#endif
@@ -0,0 +1,32 @@
+#include "AIDMNetTypes.h"
+
+TArray<FAIDMNetAction> FAIDMNetAction::FromParsed(const TArray<FParsedAction>& Actions)
+{
+    TArray<FAIDMNetAction> NetActions;
+    NetActions.Reserve(Actions.Num());
+    for (const FParsedAction& Action : Actions)
+    {
+        FAIDMNetAction& NetAction = NetActions.AddDefaulted_GetRef();
+        NetAction.ActionType = Action.ActionType;
+        NetAction.Command = Action.Command;
+        NetAction.Target = Action.Target;
+        NetAction.Parameters = Action.Parameters;
+    }
+    return NetActions;
+}
+
+TArray<FParsedAction> FAIDMNetAction::ToParsed(const TArray<FAIDMNetAction>& Actions, const FString& Response)
+{
+    TArray<FParsedAction> ParsedActions;
+    ParsedActions.Reserve(Actions.Num());
+    for (const FAIDMNetAction& NetAction : Actions)
+    {
+        FParsedAction& Action = ParsedActions.AddDefaulted_GetRef();
+        Action.ActionType = NetAction.ActionType;
+        Action.Command = NetAction.Command;
+        Action.Target = NetAction.Target;
+        Action.Parameters = NetAction.Parameters;
+        Action.Description = Response;
+    }
+    return ParsedActions;
+}
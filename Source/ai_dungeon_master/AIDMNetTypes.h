@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIActionParser.h"
+#include "AIDMNetTypes.generated.h"
+
+// 클라이언트로 보내는 파싱된 액션 (Description은 응답 전문이라 보내지 않고 클라이언트에서 채움)
+USTRUCT(BlueprintType)
+struct FAIDMNetAction
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    EActionType ActionType = EActionType::Unknown;
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Command;
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Target;
+
+    UPROPERTY(BlueprintReadOnly)
+    TArray<FString> Parameters;
+
+    static TArray<FAIDMNetAction> FromParsed(const TArray<FParsedAction>& Actions);
+    static TArray<FParsedAction> ToParsed(const TArray<FAIDMNetAction>& Actions, const FString& Response);
+};
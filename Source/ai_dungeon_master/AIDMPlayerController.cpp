@@ -7,9 +7,12 @@
 #include "InputAction.h"
 #include "ChatWidget.h"
 #include "AIManager.h"
+#include "AIDMSubsystem.h"
 #include "Blueprint/UserWidget.h"
 #include "Engine/World.h"
-#include "EngineUtils.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/Paths.h"
+#include "TimerManager.h"
 
 void AAIDMPlayerController::BeginPlay()
 {
@@ -19,6 +22,20 @@ void AAIDMPlayerController::BeginPlay()
 	SetupAIManager();
 }
 
+void AAIDMPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorldTimerManager().ClearTimer(ChunkFlushTimerHandle);
+
+	if (AISession)
+	{
+		AISession->OnAIResponse.RemoveDynamic(this, &AAIDMPlayerController::OnSessionResponse);
+		AISession->OnAIResponseChunk.RemoveDynamic(this, &AAIDMPlayerController::OnSessionChunk);
+		AISession = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AAIDMPlayerController::SetupInputComponent()
 {
 	Super::SetupInputComponent();
@@ -62,10 +79,14 @@ void AAIDMPlayerController::ShowChatWidget()
 
 			// ޽  ̺Ʈ ε
 			ChatWidget->OnMessageSent.AddDynamic(this, &AAIDMPlayerController::OnUserMessageSent);
+			ChatWidget->OnMessageTyping.AddDynamic(this, &AAIDMPlayerController::OnUserTyping);
 
 			// ȯ ޽ ǥ
 			ChatWidget->AddSystemMessage(TEXT("Welcome to AI Dungeon Master!"));
 			ChatWidget->AddSystemMessage(TEXT("Press T to open chat and start your adventure."));
+
+			//   ȭ 
+			RestoreChatHistory();
 		}
 	}
 
@@ -145,37 +166,231 @@ void AAIDMPlayerController::ToggleChat()
 
 void AAIDMPlayerController::SetupAIManager()
 {
-	// 忡 AIManager ã
-	if (UWorld* World = GetWorld())
+	// AI û  ó (Ŭ̾Ʈ ServerSubmitChat Է¸ )
+	if (!HasAuthority())
 	{
-		for (TActorIterator<AAIManager> ActorItr(World); ActorItr; ++ActorItr)
-		{
-			AIManager = *ActorItr;
-			break;
-		}
+		return;
+	}
+
+	//  νϽ ý  ε ߿  AIManager  (  )
+	if (UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this))
+	{
+		AIManager = Subsystem->GetOrSpawnManager(GetWorld());
+	}
+
+	//  ÷̾ ٷ   ( ÷̾ ID   ù Է¿)
+	if (IsLocalController())
+	{
+		GetOrBindAISession();
+	}
+}
+
+FName AAIDMPlayerController::GetAISessionId() const
+{
+	if (!AIPartyId.IsNone())
+	{
+		return AIPartyId;
+	}
+
+	if (IsLocalController())
+	{
+		return AAIManager::DefaultSessionId;
+	}
+
+	//  α  ̸ε ̹Ƿ Ͽ    ڴ ٲ
+	FString PlayerKey;
+	if (PlayerState)
+	{
+		const FUniqueNetIdRepl& UniqueId = PlayerState->GetUniqueId();
+		PlayerKey = UniqueId.IsValid() ? UniqueId->ToString() : FString::FromInt(PlayerState->GetPlayerId());
+	}
+	else
+	{
+		PlayerKey = GetName();
+	}
+	return FName(*FPaths::MakeValidFileName(TEXT("Player_") + PlayerKey, TEXT('_')));
+}
+
+UAIConversationSession* AAIDMPlayerController::GetOrBindAISession()
+{
+	if (AISession || !AIManager)
+	{
+		return AISession;
+	}
+
+	AISession = AIManager->GetOrCreateSession(GetAISessionId());
+	if (AISession)
+	{
+		//   ÷̾(Ƽ)   
+		AISession->OnAIResponse.AddDynamic(this, &AAIDMPlayerController::OnSessionResponse);
+		AISession->OnAIResponseChunk.AddDynamic(this, &AAIDMPlayerController::OnSessionChunk);
+		UpdateWorldObserver(nullptr);
+	}
+	return AISession;
+}
+
+void AAIDMPlayerController::OnPossess(APawn* InPawn)
+{
+	APawn* PreviousPawn = GetPawn();
+	Super::OnPossess(InPawn);
+	UpdateWorldObserver(PreviousPawn);
+}
+
+void AAIDMPlayerController::UpdateWorldObserver(APawn* PreviousPawn)
+{
+	if (!AISession || !GetPawn())
+	{
+		return;
+	}
+
+	// û  ٲ Ÿ   ٲ    ٽ  
+	const AActor* CurrentObserver = AISession->GetWorldObserver();
+	if (!CurrentObserver || CurrentObserver == PreviousPawn)
+	{
+		AISession->SetWorldObserver(GetPawn());
+	}
+}
+
+void AAIDMPlayerController::OnSessionChunk(const FString& Chunk)
+{
+	//  RPC  ʰ Ƽ 
+	PendingDelta += Chunk;
+	if (PendingDelta.Len() >= ChunkFlushChars)
+	{
+		FlushChunks();
+	}
+	else if (!GetWorldTimerManager().IsTimerActive(ChunkFlushTimerHandle))
+	{
+		GetWorldTimerManager().SetTimer(ChunkFlushTimerHandle, this, &AAIDMPlayerController::FlushChunks, ChunkFlushInterval, false);
+	}
+}
+
+void AAIDMPlayerController::FlushChunks()
+{
+	GetWorldTimerManager().ClearTimer(ChunkFlushTimerHandle);
+
+	if (!PendingDelta.IsEmpty())
+	{
+		SentStreamText += PendingDelta;
+		ClientReceiveAIChunk(PendingDelta);
+		PendingDelta.Reset();
+	}
+}
+
+void AAIDMPlayerController::OnSessionResponse(bool bSuccess, const FString& Response)
+{
+	//      
+	FlushChunks();
+
+	// Ʈ ̹  ؽƮ    (߰ շ û ü )
+	const bool bTextStreamed = bSuccess && !SentStreamText.IsEmpty() && SentStreamText.Equals(Response, ESearchCase::CaseSensitive);
+	SentStreamText.Reset();
+
+	TArray<FAIDMNetAction> Actions;
+	if (bSuccess && AISession)
+	{
+		Actions = FAIDMNetAction::FromParsed(AISession->GetLastParsedActions());
+	}
 
-		if (!AIManager)
+	ClientReceiveAIResponse(bSuccess, bTextStreamed, bTextStreamed ? FString() : Response, Actions);
+}
+
+bool AAIDMPlayerController::ServerSubmitChat_Validate(const FString& Message)
+{
+	return Message.Len() <= MaxChatMessageLength;
+}
+
+void AAIDMPlayerController::ServerSubmitChat_Implementation(const FString& Message)
+{
+	if (UAIConversationSession* Session = GetOrBindAISession())
+	{
+		Session->SendMessage(Message);
+	}
+	else
+	{
+		ClientReceiveAIResponse(false, false, TEXT("AI Manager not found"), TArray<FAIDMNetAction>());
+	}
+}
+
+bool AAIDMPlayerController::ServerNotifyTyping_Validate(const FString& PartialText)
+{
+	return PartialText.Len() <= MaxChatMessageLength;
+}
+
+void AAIDMPlayerController::ServerNotifyTyping_Implementation(const FString& PartialText)
+{
+	if (UAIConversationSession* Session = GetOrBindAISession())
+	{
+		Session->NotifyTyping(PartialText);
+	}
+}
+
+void AAIDMPlayerController::ClientReceiveAIChunk_Implementation(const FString& Delta)
+{
+	StreamedText += Delta;
+	OnAIResponseChunkReceived.Broadcast(Delta);
+}
+
+void AAIDMPlayerController::ClientReceiveAIResponse_Implementation(bool bSuccess, bool bTextStreamed, const FString& Text, const TArray<FAIDMNetAction>& Actions)
+{
+	const FString Response = bTextStreamed ? StreamedText : Text;
+	StreamedText.Reset();
+
+	OnAIResponseReceived(bSuccess, Response);
+
+	if (bSuccess && Actions.Num() > 0)
+	{
+		OnAIActionsReceived.Broadcast(FAIDMNetAction::ToParsed(Actions, Response));
+	}
+}
+
+void AAIDMPlayerController::RestoreChatHistory()
+{
+	//    Ƿ  Ŭ̾Ʈ  
+	if (!ChatWidget || !AISession)
+	{
+		return;
+	}
+
+	const TArray<FAISessionRecord> Records = AISession->GetRestoredRecords();
+	if (Records.Num() == 0)
+	{
+		return;
+	}
+
+	for (const FAISessionRecord& Record : Records)
+	{
+		if (Record.RecordType == EAISessionRecordType::UserMessage)
 		{
-			// AIManager   
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.Name = TEXT("AIManager");
-			AIManager = World->SpawnActor<AAIManager>(AAIManager::StaticClass(), SpawnParams);
+			ChatWidget->AddUserMessage(Record.Text);
 		}
-
-		if (AIManager)
+		else if (Record.RecordType == EAISessionRecordType::AIResponse)
 		{
-			// AI  ̺Ʈ ε
-			AIManager->OnAIResponse.AddDynamic(this, &AAIDMPlayerController::OnAIResponseReceived);
+			ChatWidget->AddAIMessage(FormatMessageWithLineBreaks(Record.Text));
 		}
 	}
+
+	ChatWidget->AddSystemMessage(TEXT("Previous session restored."));
 }
 
 void AAIDMPlayerController::OnUserMessageSent(const FString& Message)
 {
 	//  ޽ ChatWidget ̹ ǥõǹǷ ⼭ 
 
-	// AI Manager ޽ 
-	if (AIManager)
+	// ä Է   ð  ( Ŭ̾Ʈ   )
+	const FAIRequestTrace Trace = ChatWidget ? ChatWidget->ConsumePendingTrace() : FAIRequestTrace();
+
+	if (!HasAuthority())
+	{
+		//  Է¸   ClientReceiveAIResponse 
+		if (ChatWidget)
+		{
+			ChatWidget->AddSystemMessage(TEXT("AI is preparing response..."));
+		}
+
+		ServerSubmitChat(Message.Left(MaxChatMessageLength));
+	}
+	else if (UAIConversationSession* Session = GetOrBindAISession())
 	{
 		// ε ޽ ǥ
 		if (ChatWidget)
@@ -183,7 +398,8 @@ void AAIDMPlayerController::OnUserMessageSent(const FString& Message)
 			ChatWidget->AddSystemMessage(TEXT("AI is preparing response..."));
 		}
 
-		AIManager->SendMessage(Message);
+		// AI Manager ޽ 
+		Session->SendTracedMessage(Message, Trace);
 	}
 	else
 	{
@@ -195,6 +411,28 @@ void AAIDMPlayerController::OnUserMessageSent(const FString& Message)
 	}
 }
 
+void AAIDMPlayerController::OnUserTyping(const FString& PartialText)
+{
+	if (HasAuthority())
+	{
+		if (UAIConversationSession* Session = GetOrBindAISession())
+		{
+			Session->NotifyTyping(PartialText);
+		}
+		return;
+	}
+
+	// Ű Է¸ RPC  ʵ  
+	const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0f;
+	if (LastTypingSendTime >= 0.0f && Now - LastTypingSendTime < TypingSendInterval)
+	{
+		return;
+	}
+	LastTypingSendTime = Now;
+
+	ServerNotifyTyping(PartialText.Left(MaxChatMessageLength));
+}
+
 void AAIDMPlayerController::OnAIResponseReceived(bool bSuccess, const FString& Response)
 {
 	if (ChatWidget)
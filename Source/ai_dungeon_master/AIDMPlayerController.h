@@ -4,6 +4,8 @@
 #include "GameFramework/PlayerController.h"
 #include "Blueprint/UserWidget.h"
 #include "InputActionValue.h"
+#include "AIConversationSession.h"
+#include "AIDMNetTypes.h"
 #include "AIDMPlayerController.generated.h"
 
 class UInputMappingContext;
@@ -11,6 +13,8 @@ class UInputAction;
 class UChatWidget;
 class AAIManager;
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnAIActionsReceived, const TArray<FParsedAction>&, Actions);
+
 /**
  * AI Dungeon Master Player Controller
  * Manages UI and chat system
@@ -36,14 +40,61 @@ protected:
 	/** Chat Widget Visibility State */
 	bool bIsChatVisible = false;
 
-	/** AI Manager Reference */
+	/** AI Manager Reference ( ) */
 	UPROPERTY()
 	AAIManager* AIManager;
 
+	/**  ÷̾(Ǵ Ƽ) ȭ  ( ) */
+	UPROPERTY()
+	UAIConversationSession* AISession;
+
+	// : Ŭ̾Ʈ     Ʈ 
+	FString PendingDelta;
+
+	// : ̹ 信 ̹  Ʈ ؽƮ (    ٽ  )
+	FString SentStreamText;
+
+	// Ŭ̾Ʈ:  Ʈ ؽƮ
+	FString StreamedText;
+
+	FTimerHandle ChunkFlushTimerHandle;
+
+	// Ŭ̾Ʈ:   Է  ؽƮ  ð
+	float LastTypingSendTime = -1.0f;
+
 public:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void SetupInputComponent() override;
 
+	/**    ÷̾ ȭ   (  ÷̾ ) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Multiplayer")
+	FName AIPartyId;
+
+	/** Ʈ    ִ  () */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Multiplayer")
+	float ChunkFlushInterval = 0.1f;
+
+	/** ̸ŭ ̸  ٸ ʰ  ( ) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Multiplayer")
+	int32 ChunkFlushChars = 256;
+
+	/** Է  ؽƮ   ּ  (,  ʴ  û ҿ) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Multiplayer")
+	float TypingSendInterval = 0.25f;
+
+	/**  Ľ̵ ׼ (ÿ  丶 ȣ) */
+	UPROPERTY(BlueprintAssignable, Category = "AI|Multiplayer")
+	FOnAIActionsReceived OnAIActionsReceived;
+
+	/** Ʈ   */
+	UPROPERTY(BlueprintAssignable, Category = "AI|Multiplayer")
+	FOnAIResponseChunk OnAIResponseChunkReceived;
+
+	/**  ÷̾  ȭ  ID (Ƽ ID,  ÷̾ ⺻ ,   ÷̾) */
+	UFUNCTION(BlueprintPure, Category = "AI|Multiplayer")
+	FName GetAISessionId() const;
+
 	/** Enhanced Input - AI Dungeon Master Context */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Enhanced Input")
 	UInputMappingContext* AIDungeonMasterMappingContext;
@@ -84,12 +135,57 @@ protected:
 	// AI Integration
 	void SetupAIManager();
 
+	//  α׿  ȭ ä ȭ鿡 ǥ
+	void RestoreChatHistory();
+
 	UFUNCTION()
 	void OnUserMessageSent(const FString& Message);
 
 	UFUNCTION()
 	void OnAIResponseReceived(bool bSuccess, const FString& Response);
 
-	//  ٹٲ ߰
-	FString FormatMessageWithLineBreaks(const FString& Message);
+	UFUNCTION()
+	void OnUserTyping(const FString& PartialText);
+
+	// :  ã  Ʈ  (÷̾ ID   ó ʿ )
+	UAIConversationSession* GetOrBindAISession();
+
+	// :  ٲ  ֺ  ص ٲ
+	virtual void OnPossess(APawn* InPawn) override;
+
+	// :  ֺ    ÷̾  (Ƽ  ٸ ÷̾ ̹ ̸ )
+	void UpdateWorldObserver(APawn* PreviousPawn);
+
+	// :    Ŭ̾Ʈ 
+	UFUNCTION()
+	void OnSessionResponse(bool bSuccess, const FString& Response);
+
+	UFUNCTION()
+	void OnSessionChunk(const FString& Chunk);
+
+	// :   Ʈ  
+	void FlushChunks();
+
+	// Ŭ̾Ʈ Է (LLM û Ľ   )
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerSubmitChat(const FString& Message);
+
+	// Է  ؽƮ (ĵ     ϹǷ Unreliable)
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerNotifyTyping(const FString& PartialText);
+
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveAIChunk(const FString& Delta);
+
+	// bTextStreamed   ְ  Ʈ ؽƮ 
+	UFUNCTION(Client, Reliable)
+	void ClientReceiveAIResponse(bool bSuccess, bool bTextStreamed, const FString& Text, const TArray<FAIDMNetAction>& Actions);
+
+	// ä Է ִ  ( RPC  )
+	static constexpr int32 MaxChatMessageLength = 2000;
+
+	//  ٹٲ ߰ (  Ƿ ġũ ȣ)
+	static FString FormatMessageWithLineBreaks(const FString& Message);
+
+	friend class UAIDMBenchmarkCommandlet;
 };
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include "AIDMSubsystem.h"
+#include "AIManager.h"
+#include "AIDMLog.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+void UAIDMSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // 첫 요청 전에 설정 로드가 끝나도록 가장 먼저 시작
+    ConfigLoader = MakeShared<FAIDMConfigLoader>();
+    ConfigLoader->Start();
+
+    WorldInitializedActorsHandle = FWorldDelegates::OnWorldInitializedActors.AddUObject(this, &UAIDMSubsystem::OnWorldInitializedActors);
+}
+
+void UAIDMSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldInitializedActors.Remove(WorldInitializedActorsHandle);
+
+    // 보관 중인 세션 로그 닫기
+    for (const TPair<FName, UAIConversationSession*>& Pair : StashedSessions)
+    {
+        if (Pair.Value)
+        {
+            Pair.Value->Shutdown();
+        }
+    }
+    StashedSessions.Reset();
+    StashedActionParser = nullptr;
+    StashedBackend.Reset();
+    StashedHedgedBackend.Reset();
+    StashedTokenizer.Reset();
+    bHasStashedState = false;
+
+    if (ConfigLoader)
+    {
+        ConfigLoader->Stop();
+        ConfigLoader.Reset();
+    }
+
+    Super::Deinitialize();
+}
+
+UAIDMSubsystem* UAIDMSubsystem::Get(const UObject* WorldContextObject)
+{
+    UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+    UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+    return GameInstance ? GameInstance->GetSubsystem<UAIDMSubsystem>() : nullptr;
+}
+
+AAIManager* UAIDMSubsystem::GetAIManager(const UObject* WorldContextObject)
+{
+    UAIDMSubsystem* Subsystem = Get(WorldContextObject);
+    return Subsystem ? Subsystem->GetManager() : nullptr;
+}
+
+void UAIDMSubsystem::OnWorldInitializedActors(const FActorsInitializedParams& Params)
+{
+    // 이 게임 인스턴스의 게임 월드만 (에디터 월드, 다른 PIE 인스턴스 제외)
+    UWorld* World = Params.World;
+    if (World && World->IsGameWorld() && World->GetGameInstance() == GetGameInstance() && World->GetNetMode() != NM_Client)
+    {
+        GetOrSpawnManager(World);
+    }
+}
+
+AAIManager* UAIDMSubsystem::GetOrSpawnManager(UWorld* World)
+{
+    if (Manager.IsValid() && Manager->GetWorld() == World)
+    {
+        return Manager.Get();
+    }
+
+    // LLM 요청은 서버에서만 (클라이언트는 플레이어 컨트롤러 RPC로 요청)
+    if (!World || World->GetNetMode() == NM_Client)
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Name = TEXT("AIManager");
+    SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+    SpawnParams.ObjectFlags |= RF_Transient;
+    AAIManager* NewManager = World->SpawnActor<AAIManager>(AAIManager::StaticClass(), SpawnParams);
+    if (!NewManager || !RegisterManager(NewManager))
+    {
+        return Manager.Get();
+    }
+
+    // 로딩 중에 파서, 백엔드, API 키, 기본 세션 준비 (BeginPlay 전에)
+    const double StartTime = FPlatformTime::Seconds();
+    NewManager->WarmUp();
+    UE_LOG(LogAIDM, Log, TEXT("AI 매니저 준비 완료 (%s, %.1f ms)"), *World->GetMapName(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    return NewManager;
+}
+
+bool UAIDMSubsystem::RegisterManager(AAIManager* InManager)
+{
+    if (Manager.Get() == InManager)
+    {
+        return true;
+    }
+
+    if (Manager.IsValid() && Manager->GetWorld() == InManager->GetWorld())
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("AI 매니저가 이미 있습니다 (%s) - %s 무시"), *Manager->GetName(), *InManager->GetName());
+        return false;
+    }
+
+    Manager = InManager;
+
+    // 이전 레벨에서 보관한 상태 넘기기
+    if (bHasStashedState)
+    {
+        for (const TPair<FName, UAIConversationSession*>& Pair : StashedSessions)
+        {
+            Pair.Value->Manager = InManager;
+        }
+        InManager->Sessions = MoveTemp(StashedSessions);
+        InManager->ActionParser = StashedActionParser;
+        if (!InManager->Backend)
+        {
+            InManager->Backend = StashedBackend;
+            InManager->HedgedBackend = StashedHedgedBackend;
+        }
+        InManager->LatencyTracker = StashedLatencyTracker;
+        InManager->RouteTracker = StashedRouteTracker;
+        InManager->ResponseLength = StashedResponseLength;
+        InManager->TokenRate = StashedTokenRate;
+        InManager->SemanticCache = StashedSemanticCache;
+        InManager->Tokenizer = StashedTokenizer;
+
+        StashedSessions.Reset();
+        StashedActionParser = nullptr;
+        StashedBackend.Reset();
+        StashedHedgedBackend.Reset();
+        bHasStashedState = false;
+
+        UE_LOG(LogAIDM, Log, TEXT("레벨 전환 후 AI 세션 %d개 복원"), InManager->Sessions.Num());
+    }
+
+    return true;
+}
+
+bool UAIDMSubsystem::UnregisterManager(AAIManager* InManager, EEndPlayReason::Type EndPlayReason)
+{
+    if (Manager.Get() != InManager)
+    {
+        return false;
+    }
+    Manager.Reset();
+
+    if (EndPlayReason != EEndPlayReason::LevelTransition)
+    {
+        return false;
+    }
+
+    // 세션은 게임 인스턴스에 있으므로 이전 월드 참조만 끊어 보관 (진행 중인 응답은 버려짐)
+    for (const TPair<FName, UAIConversationSession*>& Pair : InManager->Sessions)
+    {
+        UAIConversationSession* Session = Pair.Value;
+        InManager->GetWorldTimerManager().ClearTimer(Session->SummaryTimerHandle);
+        InManager->GetWorldTimerManager().ClearTimer(Session->SpeculationTimerHandle);
+        Session->PendingRequestCount = 0;
+        Session->Manager = nullptr;
+
+        // 진행 중인 요약 응답은 이전 매니저로 가므로 받지 못함
+        if (Session->Summarizer)
+        {
+            Session->Summarizer->AbortFold();
+        }
+    }
+    StashedSessions = MoveTemp(InManager->Sessions);
+    StashedActionParser = InManager->ActionParser;
+    StashedBackend = InManager->Backend;
+    StashedHedgedBackend = InManager->HedgedBackend;
+    StashedLatencyTracker = InManager->LatencyTracker;
+    StashedRouteTracker = InManager->RouteTracker;
+    StashedResponseLength = InManager->ResponseLength;
+    StashedTokenRate = InManager->TokenRate;
+    StashedSemanticCache = InManager->SemanticCache;
+    StashedTokenizer = InManager->Tokenizer;
+    bHasStashedState = true;
+
+    InManager->Sessions.Reset();
+    InManager->ActionParser = nullptr;
+    InManager->Backend.Reset();
+    InManager->HedgedBackend.Reset();
+    return true;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "AIRequestTrace.h"
+#include "AIChatBackend.h"
+#include "AIDMConfig.h"
+#include "AIResponseLength.h"
+#include "AITokenRate.h"
+#include "AISemanticCache.h"
+#include "AIDMSubsystem.generated.h"
+
+class AAIManager;
+class UAIActionParser;
+class UAIConversationSession;
+class UAIWorldEntityComponent;
+class FAIHedgedBackend;
+class FAITokenizer;
+
+/**
+ * 게임 인스턴스마다 AI 매니저를 하나만 두는 서브시스템 (서버/단독 실행에서만, 클라이언트에는 없음)
+ * 게임 월드의 액터 초기화 시점(로딩 중)에 매니저를 만들고 미리 준비시키며,
+ * 레벨 전환 동안 세션, 액션 파서, 백엔드를 보관했다가 다음 레벨의 매니저에 넘긴다.
+ * AI 설정(API 키, 엔드포인트, 모델)은 게임 인스턴스 시작 시 백그라운드에서 로드하고 파일 변경을 감시한다.
+ */
+UCLASS()
+class AI_DUNGEON_MASTER_API UAIDMSubsystem : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    static UAIDMSubsystem* Get(const UObject* WorldContextObject);
+
+    // 현재 월드의 AI 매니저 (액터 검색 없음)
+    UFUNCTION(BlueprintPure, Category = "AI", meta = (WorldContext = "WorldContextObject"))
+    static AAIManager* GetAIManager(const UObject* WorldContextObject);
+
+    UFUNCTION(BlueprintPure, Category = "AI")
+    AAIManager* GetManager() const { return Manager.Get(); }
+
+    // 월드에 매니저가 없으면 생성하고 준비
+    AAIManager* GetOrSpawnManager(UWorld* World);
+
+    // AAIManager::BeginPlay에서 호출 (이미 다른 매니저가 있으면 false)
+    bool RegisterManager(AAIManager* InManager);
+
+    // AAIManager::EndPlay에서 호출 (레벨 전환이면 상태를 보관하고 true)
+    bool UnregisterManager(AAIManager* InManager, EEndPlayReason::Type EndPlayReason);
+
+    // 주변 상태에 넣을 액터 (UAIWorldEntityComponent가 BeginPlay/EndPlay에서 호출)
+    void RegisterWorldEntity(UAIWorldEntityComponent* Entity) { WorldEntities.AddUnique(Entity); }
+    void UnregisterWorldEntity(UAIWorldEntityComponent* Entity) { WorldEntities.RemoveSwap(Entity); }
+    const TArray<TWeakObjectPtr<UAIWorldEntityComponent>>& GetWorldEntities() const { return WorldEntities; }
+
+    // 게임 인스턴스 동안 공유하는 AI 설정 로더
+    TSharedPtr<FAIDMConfigLoader> GetConfigLoader() const { return ConfigLoader; }
+
+private:
+    void OnWorldInitializedActors(const FActorsInitializedParams& Params);
+
+    TWeakObjectPtr<AAIManager> Manager;
+
+    // 등록된 주변 상태 대상 (레벨이 바뀌면 각 컴포넌트의 EndPlay에서 빠짐)
+    TArray<TWeakObjectPtr<UAIWorldEntityComponent>> WorldEntities;
+
+    // 레벨 전환 동안 보관하는 매니저 상태
+    UPROPERTY()
+    TMap<FName, UAIConversationSession*> StashedSessions;
+
+    UPROPERTY()
+    UAIActionParser* StashedActionParser = nullptr;
+
+    TSharedPtr<IAIChatBackend> StashedBackend;
+    TSharedPtr<FAIHedgedBackend> StashedHedgedBackend;
+    FAILatencyTracker StashedLatencyTracker;
+    FAIRouteTracker StashedRouteTracker;
+    FAIResponseLengthController StashedResponseLength;
+    FAITokenRateGovernor StashedTokenRate;
+    FAISemanticCache StashedSemanticCache;
+    TSharedPtr<const FAITokenizer> StashedTokenizer;
+    bool bHasStashedState = false;
+
+    FDelegateHandle WorldInitializedActorsHandle;
+
+    TSharedPtr<FAIDMConfigLoader> ConfigLoader;
+};
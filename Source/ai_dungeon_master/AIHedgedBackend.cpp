@@ -0,0 +1,324 @@
+#include "AIHedgedBackend.h"
+#include "AIDMLog.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+FAIHedgedBackend::FAIHedgedBackend(TSharedPtr<IAIChatBackend> InPrimary, TSharedPtr<IAIChatBackend> InSecondary, const FAIHedgeSettings& InSettings)
+    : Primary(InPrimary)
+    , Secondary(InSecondary ? InSecondary : InPrimary)
+    , Settings(InSettings)
+{
+}
+
+void FAIHedgedBackend::SetAPIKey(const FString& InAPIKey)
+{
+    Primary->SetAPIKey(InAPIKey);
+    if (Secondary != Primary)
+    {
+        Secondary->SetAPIKey(InAPIKey);
+    }
+}
+
+void FAIHedgedBackend::WarmConnection(float KeepAliveInterval)
+{
+    // 헤지 요청도 연결을 새로 맺지 않도록 양쪽 모두
+    Primary->WarmConnection(KeepAliveInterval);
+    if (Secondary != Primary)
+    {
+        Secondary->WarmConnection(KeepAliveInterval);
+    }
+}
+
+void FAIHedgedBackend::SetSecondaryEndpoint(const FString& InURL, float InTimeoutSeconds)
+{
+    if (Secondary != Primary)
+    {
+        Secondary->SetEndpoint(InURL, InTimeoutSeconds);
+    }
+}
+
+float FAIHedgedBackend::GetHedgeDelayMs() const
+{
+    if (PrimaryStartLatencies.Num() < Settings.MinSamples)
+    {
+        return Settings.MaxHedgeDelayMs;
+    }
+    return FMath::Clamp(PrimaryStartLatencies.GetPercentile(Settings.HedgePercentile), Settings.MinHedgeDelayMs, Settings.MaxHedgeDelayMs);
+}
+
+FString FAIHedgedBackend::ReplaceModel(const FString& Body, const FString& Model)
+{
+    TSharedPtr<FJsonObject> JsonObject;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Body);
+    if (Model.IsEmpty() || !FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+    {
+        return Body;
+    }
+
+    JsonObject->SetStringField(TEXT("model"), Model);
+
+    FString Result;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Result);
+    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+    return Result;
+}
+
+float FAIHedgedBackend::GetElapsedMs(const FHedgedRequest& State)
+{
+    return static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - State.StartCycles));
+}
+
+void FAIHedgedBackend::SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete)
+{
+    // 요약, 예측 요청은 주 백엔드로만
+    if (!Request.bLatencyCritical)
+    {
+        Primary->SendRequest(Request, OnChunk, OnComplete);
+        return;
+    }
+
+    TSharedRef<FHedgedRequest> State = MakeShared<FHedgedRequest>();
+    State->Request = Request;
+    State->Request.Cancellation.Reset();
+    State->OnChunk = OnChunk;
+    State->OnComplete = OnComplete;
+    State->StartCycles = FPlatformTime::Cycles64();
+    Stats.Requests++;
+
+    TWeakPtr<FAIHedgedBackend> WeakThis = AsShared();
+
+    // 호출한 쪽이 취소하면 두 시도 모두 취소 (완료 콜백 없음)
+    if (Request.Cancellation)
+    {
+        Request.Cancellation->OnCancel = [WeakThis, State]()
+        {
+            if (TSharedPtr<FAIHedgedBackend> This = WeakThis.Pin())
+            {
+                if (!State->bFinished)
+                {
+                    This->Finish(State);
+                }
+            }
+        };
+    }
+
+    StartAttempt(State, 0);
+
+    // 주 백엔드가 바로 완료했을 수 있음
+    if (State->bFinished)
+    {
+        return;
+    }
+
+    State->HedgeHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, State](float)
+    {
+        State->HedgeHandle.Reset();
+        if (TSharedPtr<FAIHedgedBackend> This = WeakThis.Pin())
+        {
+            This->OnHedgeDeadline(State);
+        }
+        return false;
+    }), GetHedgeDelayMs() / 1000.0f);
+
+    if (Settings.HardDeadlineMs > 0.0f)
+    {
+        State->DeadlineHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, State](float)
+        {
+            State->DeadlineHandle.Reset();
+            if (TSharedPtr<FAIHedgedBackend> This = WeakThis.Pin())
+            {
+                This->OnHardDeadline(State);
+            }
+            return false;
+        }), Settings.HardDeadlineMs / 1000.0f);
+    }
+}
+
+void FAIHedgedBackend::StartAttempt(const TSharedRef<FHedgedRequest>& State, int32 Attempt)
+{
+    FAIChatRequest AttemptRequest = State->Request;
+    AttemptRequest.Cancellation = MakeShared<FAIChatCancellation>();
+    if (Attempt == 1)
+    {
+        AttemptRequest.Body = ReplaceModel(AttemptRequest.Body, SecondaryModel);
+    }
+    State->Attempts[Attempt] = AttemptRequest.Cancellation;
+
+    TWeakPtr<FAIHedgedBackend> WeakThis = AsShared();
+    IAIChatBackend* Target = Attempt == 0 ? Primary.Get() : Secondary.Get();
+    Target->SendRequest(AttemptRequest,
+        FOnAIChatChunk::CreateLambda([WeakThis, State, Attempt](const FString& Chunk)
+        {
+            if (TSharedPtr<FAIHedgedBackend> This = WeakThis.Pin())
+            {
+                This->OnAttemptChunk(State, Attempt, Chunk);
+            }
+        }),
+        FOnAIChatComplete::CreateLambda([WeakThis, State, Attempt](const FAIChatResult& Result)
+        {
+            if (TSharedPtr<FAIHedgedBackend> This = WeakThis.Pin())
+            {
+                This->OnAttemptComplete(State, Attempt, Result);
+            }
+        }));
+}
+
+void FAIHedgedBackend::DeclareWinner(const TSharedRef<FHedgedRequest>& State, int32 Attempt)
+{
+    State->Winner = Attempt;
+    if (Attempt == 0)
+    {
+        PrimaryStartLatencies.Add(GetElapsedMs(*State));
+    }
+    else
+    {
+        Stats.SecondaryWins++;
+
+        // 주 요청은 아직 첫 응답이 없으므로 실제 지연은 지금보다 길다 (하한값으로 기록).
+        // 빼면 느린 주 요청이 표본에서 빠져 백분위와 헤지 시점이 점점 낮아진다.
+        if (!State->bAttemptDone[0])
+        {
+            PrimaryStartLatencies.Add(FMath::Max(GetElapsedMs(*State), GetHedgeDelayMs()));
+        }
+    }
+
+    // 더 이상 헤지할 필요 없음
+    if (State->HedgeHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(State->HedgeHandle);
+        State->HedgeHandle.Reset();
+    }
+
+    const int32 Loser = 1 - Attempt;
+    if (State->Attempts[Loser] && !State->bAttemptDone[Loser])
+    {
+        State->Attempts[Loser]->Cancel();
+        AIDM_EVENT(Verbose, "HedgeWinner", AIDM_FIELD("attempt", Attempt), AIDM_FIELD("ms", GetElapsedMs(*State)));
+    }
+}
+
+void FAIHedgedBackend::OnAttemptChunk(const TSharedRef<FHedgedRequest>& State, int32 Attempt, const FString& Chunk)
+{
+    if (State->bFinished || (State->Winner != INDEX_NONE && State->Winner != Attempt))
+    {
+        return;
+    }
+
+    if (State->Winner == INDEX_NONE)
+    {
+        DeclareWinner(State, Attempt);
+    }
+
+    State->PartialText += Chunk;
+    State->OnChunk.ExecuteIfBound(Chunk);
+}
+
+void FAIHedgedBackend::OnAttemptComplete(const TSharedRef<FHedgedRequest>& State, int32 Attempt, const FAIChatResult& Result)
+{
+    State->bAttemptDone[Attempt] = true;
+    if (State->bFinished || (State->Winner != INDEX_NONE && State->Winner != Attempt))
+    {
+        return;
+    }
+
+    const bool bOk = Result.bSuccess && Result.ResponseCode == 200;
+    if (State->Winner == INDEX_NONE && !bOk)
+    {
+        // 주 요청이 헤지 전에 실패하면 기다리지 않고 바로 보조로
+        if (Attempt == 0 && !State->Attempts[1])
+        {
+            if (State->HedgeHandle.IsValid())
+            {
+                FTSTicker::GetCoreTicker().RemoveTicker(State->HedgeHandle);
+                State->HedgeHandle.Reset();
+            }
+            Stats.Hedged++;
+            StartAttempt(State, 1);
+            return;
+        }
+
+        // 다른 시도가 아직 진행 중이면 그 결과를 기다림
+        const int32 Other = 1 - Attempt;
+        if (State->Attempts[Other] && !State->bAttemptDone[Other])
+        {
+            return;
+        }
+
+        Finish(State);
+        State->OnComplete.ExecuteIfBound(Result);
+        return;
+    }
+
+    if (State->Winner == INDEX_NONE)
+    {
+        DeclareWinner(State, Attempt);
+    }
+
+    Finish(State);
+    State->OnComplete.ExecuteIfBound(Result);
+}
+
+void FAIHedgedBackend::OnHedgeDeadline(const TSharedRef<FHedgedRequest>& State)
+{
+    if (State->bFinished || State->Winner != INDEX_NONE || State->Attempts[1])
+    {
+        return;
+    }
+
+    Stats.Hedged++;
+    AIDM_EVENT(Log, "HedgeSent", AIDM_FIELD("ms", GetElapsedMs(*State)), AIDM_FIELD("secondary", Secondary != Primary),
+        AIDM_FIELD("model", SecondaryModel));
+    StartAttempt(State, 1);
+}
+
+void FAIHedgedBackend::OnHardDeadline(const TSharedRef<FHedgedRequest>& State)
+{
+    if (State->bFinished)
+    {
+        return;
+    }
+
+    // 받은 만큼의 응답, 없으면 대체 문구로 완료 (둘 다 없으면 실패)
+    FAIChatResult Result;
+    Result.bDeadlineFallback = true;
+    Result.TotalMs = GetElapsedMs(*State);
+    Result.Content = State->PartialText.IsEmpty() ? Settings.FallbackResponse : State->PartialText;
+    Result.bHasContent = !Result.Content.IsEmpty();
+    Result.bSuccess = Result.bHasContent;
+    Result.ResponseCode = Result.bHasContent ? 200 : 0;
+    Stats.DeadlineFallbacks++;
+
+    UE_LOG(LogAIDM, Warning, TEXT("응답 마감 시간 %.0f ms 초과 - %s 응답으로 완료"), Settings.HardDeadlineMs,
+        State->PartialText.IsEmpty() ? TEXT("대체") : TEXT("부분"));
+
+    Finish(State);
+    State->OnComplete.ExecuteIfBound(Result);
+}
+
+void FAIHedgedBackend::Finish(const TSharedRef<FHedgedRequest>& State)
+{
+    State->bFinished = true;
+
+    if (State->HedgeHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(State->HedgeHandle);
+        State->HedgeHandle.Reset();
+    }
+    if (State->DeadlineHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(State->DeadlineHandle);
+        State->DeadlineHandle.Reset();
+    }
+
+    // 진행 중인 시도 취소
+    for (int32 Attempt = 0; Attempt < 2; Attempt++)
+    {
+        if (State->Attempts[Attempt] && !State->bAttemptDone[Attempt])
+        {
+            State->Attempts[Attempt]->Cancel();
+        }
+    }
+}
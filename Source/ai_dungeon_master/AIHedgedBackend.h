@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIChatBackend.h"
+#include "AIRequestTrace.h"
+
+// 헤지 요청 설정
+struct FAIHedgeSettings
+{
+    // 주 백엔드의 응답 시작 지연이 이 백분위를 넘으면 보조 백엔드에도 같은 요청
+    float HedgePercentile = 95.0f;
+    float MinHedgeDelayMs = 500.0f;
+    float MaxHedgeDelayMs = 4000.0f;    // 샘플이 MinSamples보다 적을 때도 사용
+    int32 MinSamples = 20;
+
+    // 이 시간(ms)까지 완료되지 않으면 받은 부분 응답(없으면 FallbackResponse)으로 완료 (0 = 없음)
+    float HardDeadlineMs = 15000.0f;
+    FString FallbackResponse;
+};
+
+// 헤지 지표 (게임 스레드에서만 갱신)
+struct FAIHedgeStats
+{
+    int32 Requests = 0;
+    int32 Hedged = 0;               // 보조 요청을 보낸 수
+    int32 SecondaryWins = 0;        // 보조 요청이 먼저 응답을 시작한 수
+    int32 DeadlineFallbacks = 0;    // 마감 시간에 부분/대체 응답으로 완료한 수
+
+    float GetHedgeRate() const { return Requests > 0 ? static_cast<float>(Hedged) / Requests : 0.0f; }
+};
+
+/**
+ * 주 백엔드의 응답이 늦으면 같은 요청을 보조 백엔드(또는 다른 모델)에도 보내
+ * 먼저 응답을 시작(스트리밍 첫 조각, 아니면 완료)한 쪽을 쓰고 나머지는 취소하는 백엔드
+ * 헤지 시점은 주 백엔드의 최근 응답 시작 지연 백분위에서 정하고,
+ * 마감 시간이 지나면 받은 만큼의 응답이나 대체 문구로 완료한다 (FAIChatResult::bDeadlineFallback).
+ * bLatencyCritical이 아닌 요청은 주 백엔드로 그대로 보낸다.
+ */
+class AI_DUNGEON_MASTER_API FAIHedgedBackend : public IAIChatBackend, public TSharedFromThis<FAIHedgedBackend>
+{
+public:
+    // InSecondary가 없으면 주 백엔드로 다시 보냄 (SetSecondaryModel로 다른 모델 지정)
+    FAIHedgedBackend(TSharedPtr<IAIChatBackend> InPrimary, TSharedPtr<IAIChatBackend> InSecondary, const FAIHedgeSettings& InSettings);
+
+    virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) override;
+    virtual bool RequiresAPIKey() const override { return Primary->RequiresAPIKey(); }
+    virtual void SetAPIKey(const FString& InAPIKey) override;
+    virtual void SetEndpoint(const FString& InURL, float InTimeoutSeconds) override { Primary->SetEndpoint(InURL, InTimeoutSeconds); }
+    virtual void WarmConnection(float KeepAliveInterval) override;
+    virtual FAIConnectionStats GetConnectionStats() const override { return Primary->GetConnectionStats(); }
+    virtual const TCHAR* GetName() const override { return TEXT("Hedged"); }
+
+    // 보조 백엔드 주소 (보조 백엔드가 따로 있을 때만)
+    void SetSecondaryEndpoint(const FString& InURL, float InTimeoutSeconds);
+
+    // 보조 요청 본문의 "model" 교체 (비어 있으면 같은 본문)
+    void SetSecondaryModel(const FString& InModel) { SecondaryModel = InModel; }
+
+    void SetSettings(const FAIHedgeSettings& InSettings) { Settings = InSettings; }
+
+    // 지금 보내는 요청의 헤지 시점 (ms)
+    float GetHedgeDelayMs() const;
+
+    const FAIHedgeStats& GetStats() const { return Stats; }
+
+    // 본문 JSON의 "model" 값 교체 (실패하면 원래 본문)
+    static FString ReplaceModel(const FString& Body, const FString& Model);
+
+private:
+    // 요청 하나의 상태 (시도 0 = 주, 1 = 보조)
+    struct FHedgedRequest
+    {
+        FAIChatRequest Request;
+        FOnAIChatChunk OnChunk;
+        FOnAIChatComplete OnComplete;
+        uint64 StartCycles = 0;
+
+        TSharedPtr<FAIChatCancellation> Attempts[2];   // 보낸 시도만
+        bool bAttemptDone[2] = { false, false };
+
+        int32 Winner = INDEX_NONE;      // 먼저 응답을 시작한 시도
+        bool bFinished = false;
+        FString PartialText;            // 승자의 스트리밍 텍스트
+
+        FTSTicker::FDelegateHandle HedgeHandle;
+        FTSTicker::FDelegateHandle DeadlineHandle;
+    };
+
+    void StartAttempt(const TSharedRef<FHedgedRequest>& State, int32 Attempt);
+
+    void OnAttemptChunk(const TSharedRef<FHedgedRequest>& State, int32 Attempt, const FString& Chunk);
+    void OnAttemptComplete(const TSharedRef<FHedgedRequest>& State, int32 Attempt, const FAIChatResult& Result);
+
+    // 처음 응답을 시작한 시도를 승자로 정하고 나머지 취소
+    void DeclareWinner(const TSharedRef<FHedgedRequest>& State, int32 Attempt);
+
+    void OnHedgeDeadline(const TSharedRef<FHedgedRequest>& State);
+    void OnHardDeadline(const TSharedRef<FHedgedRequest>& State);
+
+    // 타이머를 정리하고 진행 중인 시도를 취소 (완료 콜백은 호출한 쪽에서)
+    void Finish(const TSharedRef<FHedgedRequest>& State);
+
+    static float GetElapsedMs(const FHedgedRequest& State);
+
+    TSharedPtr<IAIChatBackend> Primary;
+    TSharedPtr<IAIChatBackend> Secondary;
+    FString SecondaryModel;
+    FAIHedgeSettings Settings;
+    FAIHedgeStats Stats;
+
+    // 주 백엔드의 응답 시작 지연 (보조가 이긴 요청은 취소 시점까지만 알 수 있으므로 제외)
+    FAILatencyHistogram PrimaryStartLatencies{ 256 };
+};
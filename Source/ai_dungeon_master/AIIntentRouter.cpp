@@ -0,0 +1,239 @@
+#include "AIIntentRouter.h"
+#include "AIDMLog.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "AIRequestTrace.h"
+
+UAIIntentRouter::UAIIntentRouter()
+{
+    FAILocalIntent& Inventory = Intents.AddDefaulted_GetRef();
+    Inventory.ActionType = EActionType::Inventory;
+    Inventory.Phrases = {
+        TEXT("inventory"), TEXT("inv"), TEXT("i"), TEXT("items"), TEXT("check inventory"), TEXT("check my inventory"),
+        TEXT("open inventory"), TEXT("show inventory"), TEXT("check items"), TEXT("list items"), TEXT("show items"),
+        TEXT("check my bag"), TEXT("open my bag"), TEXT("인벤토리"), TEXT("가방"), TEXT("가방 확인")
+    };
+    Inventory.Narrations = {
+        TEXT("You rummage through your pack and take stock of your belongings."),
+        TEXT("You check your bag. Everything is where you left it.")
+    };
+
+    FAILocalIntent& Wait = Intents.AddDefaulted_GetRef();
+    Wait.ActionType = EActionType::Wait;
+    Wait.Phrases = {
+        TEXT("wait"), TEXT("z"), TEXT("wait a moment"), TEXT("wait a bit"), TEXT("wait here"), TEXT("pause"),
+        TEXT("do nothing"), TEXT("기다린다"), TEXT("대기")
+    };
+    Wait.Narrations = {
+        TEXT("You wait. Time passes quietly."),
+        TEXT("You hold your position and wait. Nothing stirs... for now.")
+    };
+
+    FAILocalIntent& Look = Intents.AddDefaulted_GetRef();
+    Look.ActionType = EActionType::Look;
+    Look.Phrases = {
+        TEXT("look"), TEXT("l"), TEXT("look around"), TEXT("look around the room"), TEXT("where am i"),
+        TEXT("둘러본다"), TEXT("주위를 둘러본다")
+    };
+    Look.Narrations = {
+        TEXT("You look around again. {last}"),
+        TEXT("You take in your surroundings, but nothing new catches your eye.")
+    };
+}
+
+void UAIIntentRouter::PostInitProperties()
+{
+    Super::PostInitProperties();
+
+    if (!HasAnyFlags(RF_ClassDefaultObject))
+    {
+        RebuildIndex();
+    }
+}
+
+void UAIIntentRouter::RebuildIndex()
+{
+    PhraseIndex.Reset();
+    for (int32 i = 0; i < Intents.Num(); i++)
+    {
+        for (const FString& Phrase : Intents[i].Phrases)
+        {
+            PhraseIndex.Add(Normalize(Phrase), i);
+        }
+    }
+}
+
+FString UAIIntentRouter::Normalize(const FString& Input)
+{
+    // 글자, 숫자, 공백만 남기고 공백 하나로 합침
+    FString Normalized;
+    Normalized.Reserve(Input.Len());
+    bool bPendingSpace = false;
+    for (TCHAR Char : Input)
+    {
+        if (FChar::IsAlnum(Char) || Char > 0x7F)
+        {
+            if (bPendingSpace && !Normalized.IsEmpty())
+            {
+                Normalized.AppendChar(TEXT(' '));
+            }
+            Normalized.AppendChar(FChar::ToLower(Char));
+            bPendingSpace = false;
+        }
+        else
+        {
+            // 공백과 구두점은 단어 구분으로 ("I'll" -> "i ll")
+            bPendingSpace = true;
+        }
+    }
+
+    static const TCHAR* Prefixes[] = { TEXT("i ll "), TEXT("i will "), TEXT("let me "), TEXT("please "), TEXT("i ") };
+    for (const TCHAR* Prefix : Prefixes)
+    {
+        if (Normalized.StartsWith(Prefix, ESearchCase::CaseSensitive))
+        {
+            Normalized.RightChopInline(FCString::Strlen(Prefix));
+            break;
+        }
+    }
+    if (Normalized.EndsWith(TEXT(" please"), ESearchCase::CaseSensitive))
+    {
+        Normalized.LeftChopInline(7);
+    }
+
+    return Normalized;
+}
+
+FString UAIIntentRouter::MakeMatchKey(const FString& Input)
+{
+    TArray<FString> Words;
+    Normalize(Input).ParseIntoArray(Words, TEXT(" "), true);
+    Words.RemoveAll([](const FString& Word)
+    {
+        return Word == TEXT("the") || Word == TEXT("a") || Word == TEXT("an") || Word == TEXT("my");
+    });
+    return FString::Join(Words, TEXT(" "));
+}
+
+void UAIIntentRouter::PredictNextInputs(const TArray<FParsedAction>& SceneActions, const FString& LastInput, int32 TopK, TArray<FString>& OutInputs) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_PredictNextInputs, AIDMChannel);
+
+    OutInputs.Reset();
+    if (TopK <= 0)
+    {
+        return;
+    }
+
+    // 키 -> (입력, 점수)
+    TMap<FString, TPair<FString, float>> Candidates;
+    auto AddCandidate = [this, &Candidates](const FString& Input, float Score)
+    {
+        if (PhraseIndex.Contains(Normalize(Input)))
+        {
+            return;
+        }
+        TPair<FString, float>& Existing = Candidates.FindOrAdd(MakeMatchKey(Input), TPair<FString, float>(Input, 0.0f));
+        Existing.Value = FMath::Max(Existing.Value, Score);
+    };
+
+    // 장면 속 대상마다 액션 종류에 맞는 다음 행동 (전투가 이어질 가능성이 가장 높음)
+    bool bInCombat = false;
+    for (const FParsedAction& Action : SceneActions)
+    {
+        bInCombat |= Action.ActionType == EActionType::Attack;
+
+        const FString Target = Normalize(Action.Target);
+        if (Target.IsEmpty())
+        {
+            continue;
+        }
+
+        switch (Action.ActionType)
+        {
+        case EActionType::Attack:   AddCandidate(FString::Printf(TEXT("attack the %s"), *Target), 3.0f); break;
+        case EActionType::Talk:     AddCandidate(FString::Printf(TEXT("talk to the %s"), *Target), 2.0f); break;
+        case EActionType::Interact: AddCandidate(FString::Printf(TEXT("open the %s"), *Target), 2.0f); break;
+        case EActionType::Cast:     AddCandidate(FString::Printf(TEXT("cast a spell at the %s"), *Target), 1.5f); break;
+        case EActionType::Look:     AddCandidate(FString::Printf(TEXT("examine the %s"), *Target), 1.0f); break;
+        case EActionType::Move:     AddCandidate(FString::Printf(TEXT("go to the %s"), *Target), 1.0f); break;
+        case EActionType::UseItem:  AddCandidate(FString::Printf(TEXT("use the %s"), *Target), 1.0f); break;
+        default: break;
+        }
+    }
+
+    // 전투 중에는 같은 입력을 반복하는 경우가 많음
+    if (!LastInput.IsEmpty())
+    {
+        AddCandidate(LastInput.TrimStartAndEnd(), bInCombat ? 2.5f : 0.5f);
+    }
+
+    TArray<TPair<FString, float>> Sorted;
+    Candidates.GenerateValueArray(Sorted);
+    Sorted.StableSort([](const TPair<FString, float>& A, const TPair<FString, float>& B) { return A.Value > B.Value; });
+
+    for (int32 i = 0; i < Sorted.Num() && i < TopK; i++)
+    {
+        OutInputs.Add(Sorted[i].Key);
+    }
+}
+
+bool UAIIntentRouter::TryRoute(const FString& Input, UAIActionParser* Parser, const FString& LastNarration, FParsedAction& OutAction, FString& OutNarration)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_IntentRoute, AIDMChannel);
+
+    const FString Normalized = Normalize(Input);
+    if (Normalized.IsEmpty())
+    {
+        return false;
+    }
+
+    // 긴 입력은 문구 표를 볼 필요도 없음
+    int32 Words = 1;
+    for (TCHAR Char : Normalized)
+    {
+        Words += Char == TEXT(' ') ? 1 : 0;
+    }
+    if (Words > MaxWords)
+    {
+        return false;
+    }
+
+    const int32* IntentIndex = PhraseIndex.Find(Normalized);
+    if (!IntentIndex)
+    {
+        return false;
+    }
+    const FAILocalIntent& Intent = Intents[*IntentIndex];
+
+    // 템플릿 선택 ({last}가 필요한데 이전 묘사가 없으면 건너뜀)
+    OutNarration.Reset();
+    for (int32 Attempt = 0; Attempt < Intent.Narrations.Num() && OutNarration.IsEmpty(); Attempt++)
+    {
+        const FString& Template = Intent.Narrations[NarrationCounter++ % Intent.Narrations.Num()];
+        if (!Template.Contains(TEXT("{last}")))
+        {
+            OutNarration = Template;
+        }
+        else if (!LastNarration.IsEmpty())
+        {
+            OutNarration = Template.Replace(TEXT("{last}"), *LastNarration);
+        }
+    }
+    if (OutNarration.IsEmpty())
+    {
+        return false;
+    }
+
+    // 의도는 문구 표가 정하고, 대상/매개변수는 모델 응답과 같은 파서로 채움
+    OutAction = FParsedAction();
+    OutAction.ActionType = Intent.ActionType;
+    OutAction.Command = Input.TrimStartAndEnd();
+    if (Parser)
+    {
+        OutAction.Parameters = Parser->ParseParameters(OutAction.Command);
+        OutAction.Target = Parser->ExtractTarget(OutAction.Command);
+    }
+    OutAction.Description = OutNarration;
+
+    return true;
+}
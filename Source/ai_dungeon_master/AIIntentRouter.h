@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AIActionParser.h"
+#include "AIIntentRouter.generated.h"
+
+// 모델 없이 처리할 수 있는 결정적인 명령 하나
+USTRUCT(BlueprintType)
+struct FAILocalIntent
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    EActionType ActionType = EActionType::Unknown;
+
+    // 정규화된 입력과 정확히 같아야 하는 문구 (소문자)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FString> Phrases;
+
+    // 돌아가며 사용하는 응답 템플릿 ({last} = 마지막 DM 묘사, 없으면 해당 템플릿은 건너뜀)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FString> Narrations;
+};
+
+/**
+ * 플레이어 입력을 모델에 보내기 전에 보는 의도 라우터
+ * 짧은 입력이 등록된 문구와 정확히 일치할 때만(높은 확신) 로컬 템플릿으로 응답하고,
+ * 조금이라도 애매하거나 창의적인 입력은 모델로 보낸다.
+ */
+UCLASS(BlueprintType)
+class AI_DUNGEON_MASTER_API UAIIntentRouter : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UAIIntentRouter();
+
+    virtual void PostInitProperties() override;
+
+    // 로컬 처리 가능하면 액션(파서로 대상/매개변수 채움)과 응답을 돌려줌
+    bool TryRoute(const FString& Input, UAIActionParser* Parser, const FString& LastNarration, FParsedAction& OutAction, FString& OutNarration);
+
+    // Intents를 바꾼 뒤 호출
+    UFUNCTION(BlueprintCallable, Category = "AI|Intent")
+    void RebuildIndex();
+
+    // 소문자, 구두점 제거, "i "/"let me " 같은 앞말 제거
+    static FString Normalize(const FString& Input);
+
+    // 예측한 입력과 실제 입력을 맞춰 보는 키 (정규화 + 관사 제거)
+    static FString MakeMatchKey(const FString& Input);
+
+    // 방금 응답에서 파싱된 액션(장면 속 대상)과 직전 입력으로 다음 입력 후보를 점수순으로 예측
+    // 로컬에서 처리되는 입력은 제외
+    void PredictNextInputs(const TArray<FParsedAction>& SceneActions, const FString& LastInput, int32 TopK, TArray<FString>& OutInputs) const;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Intent")
+    TArray<FAILocalIntent> Intents;
+
+    // 이보다 긴 입력은 항상 모델로
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|Intent")
+    int32 MaxWords = 4;
+
+private:
+    // 정규화된 문구 -> Intents 인덱스
+    TMap<FString, int32> PhraseIndex;
+
+    // 템플릿 순환용
+    int32 NarrationCounter = 0;
+};
@@ -0,0 +1,556 @@
+#include "AILocalBackend.h"
+#include "AIDMLog.h"
+#include "AIRequestTrace.h"
+#include "Async/Async.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include <atomic>
+
+#if WITH_LLAMA_CPP
+THIRD_PARTY_INCLUDES_START
+#include "llama.h"
+THIRD_PARTY_INCLUDES_END
+#endif
+
+// 요청 하나 (게임 스레드에서 만들고 작업 스레드에서 처리)
+struct FAILocalBackend::FJob
+{
+    TArray<TPair<FString, FString>> Messages;
+    int32 MaxTokens = 0;
+    float Temperature = 0.7f;
+    bool bStream = false;
+
+    // 게임 스레드에서만 사용
+    FOnAIChatChunk OnChunk;
+    FOnAIChatComplete OnComplete;
+    TSharedPtr<FAIChatCancellation> Cancellation;
+    TWeakPtr<FAILocalBackend> Owner;
+
+    uint64 SubmitCycles = 0;
+    std::atomic<bool> bCancelled{ false };     // 작업 스레드가 토큰마다 확인
+
+    // 작업 스레드가 채움
+    int32 PromptTokens = 0;
+    int32 ReusedPromptTokens = 0;
+    int32 GeneratedTokens = 0;
+    double GenerationMs = 0.0;
+};
+
+#if WITH_LLAMA_CPP
+
+namespace AILocalBackendPrivate
+{
+    // 끝에서 잘린 UTF-8 문자를 제외한 길이 (토큰 하나가 문자 일부만 담을 수 있음)
+    static int32 GetCompleteUTF8Length(const TArray<ANSICHAR>& Bytes)
+    {
+        const int32 Num = Bytes.Num();
+        for (int32 Back = 1; Back <= FMath::Min(4, Num); Back++)
+        {
+            const uint8 Byte = static_cast<uint8>(Bytes[Num - Back]);
+            if ((Byte & 0xC0) == 0x80)
+            {
+                continue;
+            }
+            const int32 Expected = Byte >= 0xF0 ? 4 : (Byte >= 0xE0 ? 3 : (Byte >= 0xC0 ? 2 : 1));
+            return Expected > Back ? Num - Back : Num;
+        }
+        return Num;
+    }
+
+    static float GetElapsedMs(uint64 StartCycles)
+    {
+        return static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+    }
+}
+
+using namespace AILocalBackendPrivate;
+
+/**
+ * 모델과 KV 캐시를 가진 작업 스레드
+ * llama 컨텍스트는 스레드 안전하지 않으므로 요청은 이 스레드에서 하나씩 처리한다.
+ */
+class FAILocalBackend::FWorker : public FRunnable
+{
+public:
+    explicit FWorker(const FAILocalBackendSettings& InSettings)
+        : Settings(InSettings)
+        , WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+    {
+        Thread = FRunnableThread::Create(this, TEXT("AIDMLocalModel"), 0, TPri_BelowNormal);
+    }
+
+    virtual ~FWorker() override
+    {
+        if (Thread)
+        {
+            Thread->Kill(true);
+            delete Thread;
+        }
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    }
+
+    void Enqueue(const TSharedRef<FJob>& Job)
+    {
+        Queue.Enqueue(Job);
+        WakeEvent->Trigger();
+    }
+
+    virtual uint32 Run() override
+    {
+        LoadModel();
+
+        while (!bStop)
+        {
+            TSharedPtr<FJob> Job;
+            while (!bStop && Queue.Dequeue(Job))
+            {
+                Process(Job.ToSharedRef());
+            }
+            WakeEvent->Wait();
+        }
+
+        FreeModel();
+        return 0;
+    }
+
+    virtual void Stop() override
+    {
+        bStop = true;
+        WakeEvent->Trigger();
+    }
+
+private:
+    void LoadModel()
+    {
+        FString ModelPath = Settings.ModelPath;
+        if (FPaths::IsRelative(ModelPath))
+        {
+            ModelPath = FPaths::Combine(FPaths::ProjectDir(), ModelPath);
+        }
+
+        const double StartTime = FPlatformTime::Seconds();
+        llama_backend_init();
+
+        llama_model_params ModelParams = llama_model_default_params();
+        ModelParams.n_gpu_layers = 0;
+        Model = llama_model_load_from_file(TCHAR_TO_UTF8(*ModelPath), ModelParams);
+        if (!Model)
+        {
+            UE_LOG(LogAIDM, Error, TEXT("로컬 모델 로드 실패: %s"), *ModelPath);
+            return;
+        }
+
+        const int32 Threads = Settings.MaxThreads > 0 ? Settings.MaxThreads : GetDefaultThreadCount();
+        llama_context_params ContextParams = llama_context_default_params();
+        ContextParams.n_ctx = Settings.ContextSize;
+        ContextParams.n_batch = FMath::Min(512, Settings.ContextSize);
+        ContextParams.n_threads = Threads;
+        ContextParams.n_threads_batch = Threads;
+        Context = llama_init_from_model(Model, ContextParams);
+        if (!Context)
+        {
+            UE_LOG(LogAIDM, Error, TEXT("로컬 모델 컨텍스트 생성 실패 (n_ctx %d)"), Settings.ContextSize);
+            FreeModel();
+            return;
+        }
+
+        Vocab = llama_model_get_vocab(Model);
+        ChatTemplate = llama_model_chat_template(Model, nullptr);
+        UE_LOG(LogAIDM, Log, TEXT("로컬 모델 로드: %s (%.1f s, 스레드 %d, n_ctx %d)"), *FPaths::GetCleanFilename(ModelPath),
+            FPlatformTime::Seconds() - StartTime, Threads, Settings.ContextSize);
+    }
+
+    void FreeModel()
+    {
+        if (Context)
+        {
+            llama_free(Context);
+            Context = nullptr;
+        }
+        if (Model)
+        {
+            llama_model_free(Model);
+            Model = nullptr;
+        }
+        Vocab = nullptr;
+        CachedTokens.Reset();
+    }
+
+    // 모델의 채팅 템플릿 적용 (없으면 ChatML)
+    bool ApplyChatTemplate(const TArray<TPair<FString, FString>>& Messages, TArray<ANSICHAR>& OutPrompt) const
+    {
+        TArray<TArray<ANSICHAR>> Storage;
+        Storage.Reserve(Messages.Num() * 2);
+        for (const TPair<FString, FString>& Message : Messages)
+        {
+            for (const FString* Text : { &Message.Key, &Message.Value })
+            {
+                const FTCHARToUTF8 Converted(**Text);
+                TArray<ANSICHAR>& Bytes = Storage.AddDefaulted_GetRef();
+                Bytes.Append(Converted.Get(), Converted.Length());
+                Bytes.Add('\0');
+            }
+        }
+
+        TArray<llama_chat_message> Chat;
+        for (int32 Index = 0; Index < Messages.Num(); Index++)
+        {
+            Chat.Add({ Storage[Index * 2].GetData(), Storage[Index * 2 + 1].GetData() });
+        }
+
+        OutPrompt.SetNumUninitialized(4096);
+        int32 Length = llama_chat_apply_template(ChatTemplate, Chat.GetData(), Chat.Num(), true, OutPrompt.GetData(), OutPrompt.Num());
+        if (Length > OutPrompt.Num())
+        {
+            OutPrompt.SetNumUninitialized(Length);
+            Length = llama_chat_apply_template(ChatTemplate, Chat.GetData(), Chat.Num(), true, OutPrompt.GetData(), OutPrompt.Num());
+        }
+        if (Length < 0)
+        {
+            return false;
+        }
+        OutPrompt.SetNum(Length);
+        return true;
+    }
+
+    bool Tokenize(const TArray<ANSICHAR>& Text, TArray<llama_token>& OutTokens) const
+    {
+        const int32 Count = -llama_tokenize(Vocab, Text.GetData(), Text.Num(), nullptr, 0, true, true);
+        if (Count <= 0)
+        {
+            return false;
+        }
+        OutTokens.SetNumUninitialized(Count);
+        return llama_tokenize(Vocab, Text.GetData(), Text.Num(), OutTokens.GetData(), Count, true, true) == Count;
+    }
+
+    llama_sampler* CreateSampler(float Temperature) const
+    {
+        llama_sampler* Sampler = llama_sampler_chain_init(llama_sampler_chain_default_params());
+        if (Temperature <= 0.0f)
+        {
+            llama_sampler_chain_add(Sampler, llama_sampler_init_greedy());
+            return Sampler;
+        }
+        llama_sampler_chain_add(Sampler, llama_sampler_init_top_k(40));
+        llama_sampler_chain_add(Sampler, llama_sampler_init_top_p(0.95f, 1));
+        llama_sampler_chain_add(Sampler, llama_sampler_init_temp(Temperature));
+        llama_sampler_chain_add(Sampler, llama_sampler_init_dist(Settings.Seed));
+        return Sampler;
+    }
+
+    // KV 캐시를 잃었으면 처음부터 다시 처리하도록 비움
+    void ResetCache()
+    {
+        llama_memory_clear(llama_get_memory(Context), true);
+        CachedTokens.Reset();
+    }
+
+    static void PostChunk(const TSharedRef<FJob>& Job, const FString& Text)
+    {
+        AsyncTask(ENamedThreads::GameThread, [Job, Text]()
+        {
+            if (!Job->Cancellation || !Job->Cancellation->bCancelled)
+            {
+                Job->OnChunk.ExecuteIfBound(Text);
+            }
+        });
+    }
+
+    static void PostResult(const TSharedRef<FJob>& Job, const FAIChatResult& Result)
+    {
+        AsyncTask(ENamedThreads::GameThread, [Job, Result]()
+        {
+            if (TSharedPtr<FAILocalBackend> Owner = Job->Owner.Pin())
+            {
+                Owner->CompleteJob(Job, Result);
+            }
+        });
+    }
+
+    void Process(const TSharedRef<FJob>& Job)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_LocalGenerate, AIDMChannel);
+
+        // 대기 중에 취소된 요청은 처리하지 않음
+        if (Job->bCancelled)
+        {
+            return;
+        }
+
+        FAIChatResult Result;
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+
+        TArray<ANSICHAR> Prompt;
+        TArray<llama_token> PromptTokens;
+        if (!Context || !ApplyChatTemplate(Job->Messages, Prompt) || !Tokenize(Prompt, PromptTokens))
+        {
+            Result.TotalMs = GetElapsedMs(Job->SubmitCycles);
+            PostResult(Job, Result);
+            return;
+        }
+
+        // 컨텍스트보다 긴 프롬프트는 요청 오류로 처리
+        Result.bSuccess = true;
+        const int32 ContextSize = static_cast<int32>(llama_n_ctx(Context));
+        if (PromptTokens.Num() >= ContextSize)
+        {
+            UE_LOG(LogAIDM, Warning, TEXT("로컬 모델 프롬프트가 컨텍스트보다 김 (%d / %d 토큰)"), PromptTokens.Num(), ContextSize);
+            Result.ResponseCode = 400;
+            Result.TotalMs = GetElapsedMs(Job->SubmitCycles);
+            PostResult(Job, Result);
+            return;
+        }
+
+        // 직전 요청과 같은 앞부분은 KV 캐시에 남겨 두고 나머지만 처리 (마지막 토큰은 로짓을 위해 다시 처리)
+        int32 Reused = 0;
+        while (Reused < CachedTokens.Num() && Reused < PromptTokens.Num() && CachedTokens[Reused] == PromptTokens[Reused])
+        {
+            Reused++;
+        }
+        Reused = FMath::Min(Reused, PromptTokens.Num() - 1);
+        llama_memory_seq_rm(llama_get_memory(Context), 0, Reused, -1);
+        CachedTokens.SetNum(Reused);
+
+        Job->PromptTokens = PromptTokens.Num();
+        Job->ReusedPromptTokens = Reused;
+
+        const int32 BatchSize = static_cast<int32>(llama_n_batch(Context));
+        for (int32 Pos = Reused; Pos < PromptTokens.Num(); Pos += BatchSize)
+        {
+            const int32 Count = FMath::Min(BatchSize, PromptTokens.Num() - Pos);
+            if (Job->bCancelled || bStop || llama_decode(Context, llama_batch_get_one(PromptTokens.GetData() + Pos, Count)) != 0)
+            {
+                ResetCache();
+                Result.bSuccess = false;
+                Result.TotalMs = GetElapsedMs(Job->SubmitCycles);
+                PostResult(Job, Result);
+                return;
+            }
+            CachedTokens.Append(PromptTokens.GetData() + Pos, Count);
+        }
+
+        // 생성 (토큰마다 취소 확인)
+        const int32 MaxTokens = FMath::Min(Job->MaxTokens, ContextSize - PromptTokens.Num());
+        llama_sampler* Sampler = CreateSampler(Job->Temperature);
+        TArray<ANSICHAR> PendingBytes;
+        char Piece[256];
+
+        while (Job->GeneratedTokens < MaxTokens && !Job->bCancelled && !bStop)
+        {
+            llama_token Token = llama_sampler_sample(Sampler, Context, -1);
+            if (llama_vocab_is_eog(Vocab, Token))
+            {
+                break;
+            }
+            Job->GeneratedTokens++;
+
+            const int32 PieceLength = llama_token_to_piece(Vocab, Token, Piece, sizeof(Piece), 0, false);
+            if (PieceLength > 0)
+            {
+                PendingBytes.Append(Piece, PieceLength);
+                const int32 CompleteLength = GetCompleteUTF8Length(PendingBytes);
+                if (CompleteLength > 0)
+                {
+                    const FUTF8ToTCHAR Converted(PendingBytes.GetData(), CompleteLength);
+                    const FString Text(Converted.Length(), Converted.Get());
+                    PendingBytes.RemoveAt(0, CompleteLength, EAllowShrinking::No);
+
+                    Result.Content += Text;
+                    if (Job->bStream)
+                    {
+                        Result.Chunks.Add({ GetElapsedMs(Job->SubmitCycles), Text });
+                        PostChunk(Job, Text);
+                    }
+                }
+            }
+
+            if (llama_decode(Context, llama_batch_get_one(&Token, 1)) != 0)
+            {
+                ResetCache();
+                break;
+            }
+            CachedTokens.Add(Token);
+        }
+        llama_sampler_free(Sampler);
+
+        // 취소되거나 디코딩에 실패한 응답은 비워 둠
+        if (Job->GeneratedTokens >= MaxTokens)
+        {
+            Result.FinishReason = TEXT("length");
+        }
+        else if (!Job->bCancelled && !bStop)
+        {
+            Result.FinishReason = TEXT("stop");
+        }
+
+        Job->GenerationMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+        Result.ResponseCode = 200;
+        Result.bHasContent = true;
+        Result.TotalMs = GetElapsedMs(Job->SubmitCycles);
+        PostResult(Job, Result);
+    }
+
+    FAILocalBackendSettings Settings;
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bStop{ false };
+    TQueue<TSharedPtr<FJob>, EQueueMode::Mpsc> Queue;
+
+    // 작업 스레드 전용
+    llama_model* Model = nullptr;
+    llama_context* Context = nullptr;
+    const llama_vocab* Vocab = nullptr;
+    const char* ChatTemplate = nullptr;
+    TArray<llama_token> CachedTokens;   // 지금 KV 캐시에 들어 있는 토큰 (시퀀스 0)
+};
+
+#else
+
+// llama.cpp 없이 빌드하면 작업 스레드 없음
+class FAILocalBackend::FWorker
+{
+};
+
+#endif
+
+FAILocalBackend::FAILocalBackend(const FAILocalBackendSettings& InSettings)
+    : Settings(InSettings)
+{
+#if WITH_LLAMA_CPP
+    // 모델 로드는 작업 스레드에서 (그 전에 들어온 요청은 대기열에서 기다림)
+    Worker = MakeUnique<FWorker>(Settings);
+#else
+    UE_LOG(LogAIDM, Warning, TEXT("llama.cpp 없이 빌드되어 로컬 모델을 사용할 수 없습니다 (%s)"), *Settings.ModelPath);
+#endif
+}
+
+FAILocalBackend::~FAILocalBackend()
+{
+    // 진행 중인 생성은 다음 토큰에서 멈추고 응답하지 않음
+    Worker.Reset();
+
+    if (Stats.Requests > 0)
+    {
+        UE_LOG(LogAIDM, Log, TEXT("로컬 모델: 요청 %d (실패 %d), 프롬프트 캐시 재사용 %.0f%%, 생성 %.1f tok/s"),
+            Stats.Requests, Stats.Failures, Stats.GetCacheReuseRate() * 100.0f, Stats.GetTokensPerSecond());
+    }
+}
+
+int32 FAILocalBackend::GetDefaultThreadCount()
+{
+    return FMath::Clamp(FPlatformMisc::NumberOfCores() - 2, 1, 8);
+}
+
+bool FAILocalBackend::ParseRequestBody(const FString& Body, TArray<TPair<FString, FString>>& OutMessages, int32& OutMaxTokens, float& OutTemperature)
+{
+    TSharedPtr<FJsonObject> JsonObject;
+    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Body);
+    if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+    {
+        return false;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>>* Messages = nullptr;
+    if (!JsonObject->TryGetArrayField(TEXT("messages"), Messages))
+    {
+        return false;
+    }
+
+    for (const TSharedPtr<FJsonValue>& Value : *Messages)
+    {
+        const TSharedPtr<FJsonObject>* Message = nullptr;
+        FString Role;
+        FString Content;
+        if (Value->TryGetObject(Message) && (*Message)->TryGetStringField(TEXT("role"), Role) && (*Message)->TryGetStringField(TEXT("content"), Content))
+        {
+            OutMessages.Emplace(MoveTemp(Role), MoveTemp(Content));
+        }
+    }
+
+    JsonObject->TryGetNumberField(TEXT("max_tokens"), OutMaxTokens);
+    double Temperature = 0.0;
+    if (JsonObject->TryGetNumberField(TEXT("temperature"), Temperature))
+    {
+        OutTemperature = static_cast<float>(Temperature);
+    }
+    return OutMessages.Num() > 0;
+}
+
+void FAILocalBackend::SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete)
+{
+    TSharedRef<FJob> Job = MakeShared<FJob>();
+    Job->MaxTokens = Settings.DefaultMaxTokens;
+    Job->bStream = Request.bStream;
+    Job->OnChunk = OnChunk;
+    Job->OnComplete = OnComplete;
+    Job->Cancellation = Request.Cancellation;
+    Job->Owner = AsShared();
+    Job->SubmitCycles = FPlatformTime::Cycles64();
+
+    const bool bParsed = ParseRequestBody(Request.Body, Job->Messages, Job->MaxTokens, Job->Temperature);
+
+    if (!Worker || !bParsed)
+    {
+        // 다른 백엔드처럼 호출한 뒤에 완료 (모델이 없으면 전송 실패, 본문 오류면 400)
+        TWeakPtr<FAILocalBackend> WeakThis = AsShared();
+        const bool bAvailable = Worker.IsValid();
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, Job, bAvailable](float)
+        {
+            if (TSharedPtr<FAILocalBackend> This = WeakThis.Pin())
+            {
+                FAIChatResult Result;
+                Result.bSuccess = bAvailable;
+                Result.ResponseCode = 400;
+                This->CompleteJob(Job, Result);
+            }
+            return false;
+        }));
+        return;
+    }
+
+    if (Request.Cancellation)
+    {
+        TWeakPtr<FJob> WeakJob = Job;
+        Request.Cancellation->OnCancel = [WeakJob]()
+        {
+            if (TSharedPtr<FJob> PinnedJob = WeakJob.Pin())
+            {
+                PinnedJob->bCancelled = true;
+            }
+        };
+    }
+
+#if WITH_LLAMA_CPP
+    Worker->Enqueue(Job);
+#endif
+}
+
+void FAILocalBackend::CompleteJob(const TSharedRef<FJob>& Job, const FAIChatResult& Result)
+{
+    Stats.Requests++;
+    if (!Result.bSuccess || Result.ResponseCode != 200)
+    {
+        Stats.Failures++;
+    }
+    Stats.PromptTokens += Job->PromptTokens;
+    Stats.ReusedPromptTokens += Job->ReusedPromptTokens;
+    Stats.GeneratedTokens += Job->GeneratedTokens;
+    Stats.GenerationMs += Job->GenerationMs;
+
+    // 취소된 요청은 응답하지 않음
+    if (Job->Cancellation && Job->Cancellation->bCancelled)
+    {
+        return;
+    }
+    Job->OnComplete.ExecuteIfBound(Result);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIChatBackend.h"
+
+// 로컬 모델 설정
+struct FAILocalBackendSettings
+{
+    FString ModelPath;              // 양자화된 GGUF 파일 (상대 경로면 프로젝트 폴더 기준)
+    int32 ContextSize = 4096;       // KV 캐시 크기 (토큰)
+    int32 MaxThreads = 0;           // 생성 스레드 수 상한 (0 = 물리 코어 - 2, 1~8)
+    int32 DefaultMaxTokens = 256;   // 요청에 max_tokens가 없을 때
+    uint32 Seed = 1234;
+};
+
+// 로컬 생성 지표 (게임 스레드에서만 갱신)
+struct FAILocalBackendStats
+{
+    int32 Requests = 0;
+    int32 Failures = 0;
+    int64 PromptTokens = 0;
+    int64 ReusedPromptTokens = 0;   // 이전 턴의 KV 캐시를 그대로 쓴 프롬프트 토큰
+    int64 GeneratedTokens = 0;
+    double GenerationMs = 0.0;      // 프롬프트 처리 + 생성
+
+    float GetCacheReuseRate() const { return PromptTokens > 0 ? static_cast<float>(ReusedPromptTokens) / PromptTokens : 0.0f; }
+    float GetTokensPerSecond() const { return GenerationMs > 0.0 ? static_cast<float>(GeneratedTokens * 1000.0 / GenerationMs) : 0.0f; }
+};
+
+/**
+ * 네트워크 없이 CPU에서 작은 GGUF 모델로 응답하는 백엔드 (llama.cpp, WITH_LLAMA_CPP일 때만)
+ * 모델 로드와 생성은 전용 작업 스레드 하나에서 순서대로 처리하고, 생성 스레드 수는 MaxThreads로 제한한다.
+ * 직전 요청과 앞부분이 같은 프롬프트(시스템 프롬프트, 요약, 이전 턴)는 KV 캐시를 재사용해 새 토큰만 처리한다.
+ * 응답 조각과 완료 콜백은 게임 스레드로 넘겨 호출한다.
+ * llama.cpp 없이 빌드하면 모든 요청이 실패로 완료된다.
+ */
+class AI_DUNGEON_MASTER_API FAILocalBackend : public IAIChatBackend, public TSharedFromThis<FAILocalBackend>
+{
+public:
+    explicit FAILocalBackend(const FAILocalBackendSettings& InSettings);
+    virtual ~FAILocalBackend();
+
+    virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) override;
+    virtual bool RequiresAPIKey() const override { return false; }
+    virtual const TCHAR* GetName() const override { return TEXT("Local"); }
+
+    const FAILocalBackendStats& GetStats() const { return Stats; }
+
+    // 요청 JSON에서 메시지(role, content)와 생성 설정 읽기
+    static bool ParseRequestBody(const FString& Body, TArray<TPair<FString, FString>>& OutMessages, int32& OutMaxTokens, float& OutTemperature);
+
+    // 기본 생성 스레드 수 (게임 스레드와 렌더 스레드 몫을 남김)
+    static int32 GetDefaultThreadCount();
+
+private:
+    struct FJob;
+    class FWorker;
+
+    void CompleteJob(const TSharedRef<FJob>& Job, const FAIChatResult& Result);
+
+    FAILocalBackendSettings Settings;
+    FAILocalBackendStats Stats;
+    TUniquePtr<FWorker> Worker;
+};
@@ -1,136 +1,1102 @@
 #include "AIManager.h"
-#include "HttpModule.h"
-#include "Interfaces/IHttpRequest.h"
-#include "Interfaces/IHttpResponse.h"
+#include "AIDMSubsystem.h"
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonWriter.h"
 #include "Engine/Engine.h"
 #include "Misc/Paths.h"
-#include "Misc/FileHelper.h"
-#include "HAL/PlatformFilemanager.h"
+#include "AISessionRecording.h"
+#include "AILocalBackend.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Crc.h"
+#include "AIWorldEntityComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+const FName AAIManager::DefaultSessionId(TEXT("Default"));
 
 AAIManager::AAIManager()
 {
     PrimaryActorTick.bCanEverTick = false;
     ActionParser = nullptr;
+    IntentRouter = nullptr;
+}
+
+void AAIManager::WarmUp()
+{
+    // 액션 파서 생성 (UObject로 안전하게)
+    if (!ActionParser)
+    {
+        ActionParser = NewObject<UAIActionParser>(GetPersistentOuter());
+        if (ActionParser)
+        {
+            UE_LOG(LogAIDM, Log, TEXT("액션 파서 생성 완료"));
+        }
+        else
+        {
+            UE_LOG(LogAIDM, Error, TEXT("액션 파서 생성 실패"));
+        }
+    }
+
+    // 입력 의도 라우터
+    if (!IntentRouter)
+    {
+        IntentRouter = NewObject<UAIIntentRouter>(this);
+    }
+
+    // 응답 지연 목표
+    LatencyTracker.SetTotalSLO(LatencySLOMs);
+
+    FAIResponseLengthSettings LengthSettings;
+    LengthSettings.MinTokens = MinResponseTokens;
+    LengthSettings.MaxTokens = MaxResponseTokens;
+    LengthSettings.TargetLatencyMs = LatencySLOMs;
+    ResponseLength.SetSettings(LengthSettings);
+
+    // 분당 토큰 한도
+    FAITokenRateLimits RateLimits;
+    RateLimits.GlobalTokensPerMinute = GlobalTokensPerMinute;
+    RateLimits.SessionTokensPerMinute = SessionTokensPerMinute;
+    RateLimits.PriorityTokensPerMinute[static_cast<int32>(EAIRequestPriority::Background)] = BackgroundTokensPerMinute;
+    RateLimits.PriorityTokensPerMinute[static_cast<int32>(EAIRequestPriority::Speculative)] = SpeculativeTokensPerMinute;
+    RateLimits.ForegroundReserveRatio = ForegroundReserveRatio;
+    TokenRate.SetLimits(RateLimits);
+
+    // 토큰 수 계산기 (세션보다 먼저, 로딩 중에 한 번만)
+    if (!Tokenizer)
+    {
+        TSharedRef<FAITokenizer> NewTokenizer = MakeShared<FAITokenizer>();
+        NewTokenizer->LoadFromFile(TokenizerPath);
+        Tokenizer = NewTokenizer;
+    }
+
+    // 설정은 서브시스템이 시작할 때부터 백그라운드에서 로드 중 (게임 스레드 파일 읽기 없음)
+    BindConfigLoader();
+
+    // 채팅 완성 백엔드 (설정이 로드되어 있으면 키와 엔드포인트 반영)
+    if (!Backend)
+    {
+        CreateBackend();
+    }
+
+    // 기본 세션 (이전 세션 복원 포함)
+    GetDefaultSession();
+}
+
+void AAIManager::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // 게임 인스턴스마다 매니저는 하나
+    if (UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this))
+    {
+        if (!Subsystem->RegisterManager(this))
+        {
+            Destroy();
+            return;
+        }
+    }
+
+    WarmUp();
+
+    // 복원된 턴 중 창 밖의 턴은 유휴 시간에 요약 (레벨 전환으로 넘겨받은 세션 포함)
+    for (const TPair<FName, UAIConversationSession*>& Pair : Sessions)
+    {
+        ScheduleSummaryFold(Pair.Value);
+    }
+
+    UE_LOG(LogAIDM, Log, TEXT("AI Manager initialized - ready for use"));
+
+    AIDM_SCREEN_MESSAGE(5.0f, FColor::Green, TEXT("AI Manager Ready"));
+
+    // 자동 테스트 실행 (디버그용)
+    if (bRunStartupSelfTest)
+    {
+        FTimerHandle TestTimerHandle;
+        GetWorld()->GetTimerManager().SetTimer(TestTimerHandle, [this]()
+        {
+            if (ActionParser)
+            {
+                UE_LOG(LogAIDM, Warning, TEXT("=== 자동 테스트 시작 ==="));
+                TestActionParser(TEXT("move to the door"));
+                TestActionParser(TEXT("[attack orc]"));
+                TestActionParser(TEXT("*look around*"));
+            }
+        }, 2.0f, false);
+    }
+}
+
+void AAIManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // 응답을 받지 않을 요청의 토큰 예약 해제 (속도 한도는 다음 레벨로 넘어감)
+    for (const TPair<int32, FAIInFlightRequest>& Pair : InFlightRequests)
+    {
+        ReleaseTokenRate(EAIRequestPriority::Foreground, Pair.Value.SessionId, Pair.Value.ReservedTokens, Pair.Value.PromptTokens);
+    }
+    for (const TPair<int32, FAISpeculation>& Pair : Speculations)
+    {
+        ReleaseTokenRate(EAIRequestPriority::Speculative, Pair.Value.SessionId, Pair.Value.ReservedTokens, Pair.Value.PromptTokens);
+    }
+    for (const TPair<int32, FAIBackgroundReservation>& Pair : BackgroundReservations)
+    {
+        ReleaseTokenRate(EAIRequestPriority::Background, Pair.Value.SessionId, Pair.Value.ReservedTokens, Pair.Value.PromptTokens);
+    }
+    BackgroundReservations.Reset();
+
+    InFlightRequests.Reset();
+    InFlightByBodyHash.Reset();
+    DeferredMessages.Reset();
+    RateLimitedMessages.Reset();
+    TokenRate.SetForegroundWaiting(false);
+
+    // 진행 중인 예측 요청은 모두 취소 (취소 완료 콜백이 바로 와도 무시되도록 먼저 비움)
+    TMap<int32, FAISpeculation> CancelledSpeculations = MoveTemp(Speculations);
+    Speculations.Reset();
+    for (TPair<int32, FAISpeculation>& Pair : CancelledSpeculations)
+    {
+        if (Pair.Value.Cancellation)
+        {
+            Pair.Value.Cancellation->Cancel();
+        }
+    }
+    if (SpeculationIssuedCount > 0)
+    {
+        UE_LOG(LogAIDM, Log, TEXT("예측 요청 %d개 중 %d개 적중"), SpeculationIssuedCount, SpeculationHitCount);
+    }
+
+    const FAISemanticCacheStats CacheStats = SemanticCache.GetStats();
+    if (CacheStats.Lookups > 0)
+    {
+        UE_LOG(LogAIDM, Log, TEXT("의미 캐시: 조회 %d, 적중 %d (%.0f%%), 비교 %d 중 잘못된 적중 %d"),
+            CacheStats.Lookups, CacheStats.Hits, CacheStats.HitRate * 100.0f, CacheStats.Verified, CacheStats.FalseHits);
+    }
+
+    const FAITokenRateStats RateStats = TokenRate.GetStats();
+    if (RateStats.DeferredRequests > 0 || RateStats.DroppedRequests > 0 || RateStats.RateLimitResponses > 0)
+    {
+        UE_LOG(LogAIDM, Log, TEXT("토큰 속도 한도: 전송 %d, 대기한 턴 %d, 건너뛴 요약/예측 %d, 429 응답 %d"),
+            RateStats.AdmittedRequests, RateStats.DeferredRequests, RateStats.DroppedRequests, RateStats.RateLimitResponses);
+    }
+
+    if (ConfigLoader)
+    {
+        ConfigLoader->OnConfigLoaded().Remove(ConfigLoadedHandle);
+        ConfigLoader.Reset();
+    }
+
+    // 레벨 전환이면 서브시스템이 세션, 파서, 백엔드를 다음 레벨로 넘김
+    UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this);
+    if (Subsystem && Subsystem->UnregisterManager(this, EndPlayReason))
+    {
+        Super::EndPlay(EndPlayReason);
+        return;
+    }
+
+    if (Backend)
+    {
+        const FAIConnectionStats ConnectionStats = Backend->GetConnectionStats();
+        if (ConnectionStats.Requests > 0)
+        {
+            UE_LOG(LogAIDM, Log, TEXT("연결 유지: 유휴 창 안 요청 %.0f%% (요청 %d, 미리 연결 %d, 유지 %d), 첫 바이트 평균 창 안 %.0f ms / 밖 %.0f ms, 관찰한 연결 수립 비용 %.0f ms"),
+                ConnectionStats.GetIdleWindowRate() * 100.0f, ConnectionStats.Requests, ConnectionStats.Prewarms, ConnectionStats.KeepAlivePings,
+                ConnectionStats.GetAvgFirstByteMs(true), ConnectionStats.GetAvgFirstByteMs(false), ConnectionStats.GetObservedHandshakeMs());
+        }
+    }
+
+    RouteTracker.LogSummary();
+
+    const FAIResponseLengthStats LengthStats = ResponseLength.GetStats();
+    if (LengthStats.Requests > 0)
+    {
+        UE_LOG(LogAIDM, Log, TEXT("응답 길이: 요청 %d, 잘림 %.0f%%, 평균 사용률 %.0f%%, 생성 %.1f tok/s"),
+            LengthStats.Requests, LengthStats.TruncationRate * 100.0f, LengthStats.AverageFillRatio * 100.0f, LengthStats.TokensPerSecond);
+    }
+
+    if (HedgedBackend && HedgedBackend->GetStats().Requests > 0)
+    {
+        const FAIHedgeStats& HedgeStats = HedgedBackend->GetStats();
+        UE_LOG(LogAIDM, Log, TEXT("헤지 %.0f%% (요청 %d, 헤지 %d, 보조 승 %d, 마감 대체 %d)"), HedgeStats.GetHedgeRate() * 100.0f,
+            HedgeStats.Requests, HedgeStats.Hedged, HedgeStats.SecondaryWins, HedgeStats.DeadlineFallbacks);
+    }
+
+    // 기록 백엔드면 기록 파일 닫힘
+    Backend.Reset();
+    HedgedBackend.Reset();
+
+    // 세션 로그 닫기
+    for (const TPair<FName, UAIConversationSession*>& Pair : Sessions)
+    {
+        if (Pair.Value)
+        {
+            Pair.Value->Shutdown();
+        }
+    }
+    Sessions.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+UAIConversationSession* AAIManager::GetOrCreateSession(FName SessionId)
+{
+    if (UAIConversationSession* Existing = FindSession(SessionId))
+    {
+        return Existing;
+    }
+
+    UAIConversationSession* Session = NewObject<UAIConversationSession>(GetPersistentOuter());
+    Sessions.Add(SessionId, Session);
+    Session->Initialize(this, SessionId, bPersistSession);
+    return Session;
+}
+
+UObject* AAIManager::GetPersistentOuter()
+{
+    UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this);
+    return Subsystem ? static_cast<UObject*>(Subsystem) : this;
+}
+
+UAIConversationSession* AAIManager::FindSession(FName SessionId) const
+{
+    UAIConversationSession* const* Found = Sessions.Find(SessionId);
+    return Found ? *Found : nullptr;
+}
+
+void AAIManager::RemoveSession(FName SessionId)
+{
+    UAIConversationSession* Session = nullptr;
+    if (Sessions.RemoveAndCopyValue(SessionId, Session) && Session)
+    {
+        Session->Shutdown();
+    }
+    TokenRate.RemoveSession(SessionId);
+    SemanticCache.RemoveSession(SessionId);
+}
+
+void AAIManager::SendMessage(const FString& Message)
+{
+    SendTracedMessage(Message, FAIRequestTrace());
+}
+
+void AAIManager::SendTracedMessage(const FString& Message, FAIRequestTrace Trace)
+{
+    SendSessionMessage(GetDefaultSession(), Message, Trace);
+}
+
+void AAIManager::SendSessionMessage(UAIConversationSession* Session, const FString& Message, FAIRequestTrace Trace)
+{
+    Trace.Mark(EAITraceStage::Dispatch);
+
+    if (!Session)
+    {
+        return;
+    }
+
+    // 속도 한도로 기다리는 턴이 있으면 그 뒤에 (응답 순서 유지)
+    if (!FlushingMessage && RateLimitedMessages.ContainsByPredicate([Session](const FAIDeferredMessage& Queued) { return Queued.Session.Get() == Session; }))
+    {
+        QueueRateLimitedMessage(Session, Message, Trace, 0);
+        return;
+    }
+
+    // 주변 상태가 바뀌었으면 장면 버전도 바뀌므로 예측 응답, 로컬 명령, 의미 캐시보다 먼저
+    UpdateWorldState(Session);
+
+    // 미리 받아 둔 예측 응답과 맞으면 바로 처리, 아니면 이 세션의 예측 요청은 모두 버림
+    if (Session->PendingRequestCount == 0 && TryServeSpeculation(Session, Message, Trace))
+    {
+        return;
+    }
+    CancelSpeculations(Session, [](const FString&) { return true; });
+    GetWorldTimerManager().ClearTimer(Session->SpeculationTimerHandle);
+
+    // 결정적인 짧은 명령은 모델 없이 처리 (응답 순서가 바뀌지 않도록 대기 중인 요청이 없을 때만)
+    if (bEnableLocalIntents && IntentRouter && Session->PendingRequestCount == 0 && TryHandleLocalIntent(Session, Message, Trace))
+    {
+        return;
+    }
+
+    // 같은 장면의 비슷한 입력에 대한 이전 모델 응답 (같은 이유로 대기 중인 요청이 없을 때만)
+    if (bEnableSemanticCache && Session->PendingRequestCount == 0 && TryServeSemanticCache(Session, Message, Trace))
+    {
+        return;
+    }
+
+    // 설정이 아직 로드 중이면 로드된 뒤 전송 (첫 요청도 디스크를 기다리지 않음)
+    if (!Backend)
+    {
+        CreateBackend();
+    }
+    if (Backend->RequiresAPIKey() && !Config.IsValid())
+    {
+        DeferredMessages.Add({ Session, Message, Trace });
+        UE_LOG(LogAIDM, Log, TEXT("AI 설정 로드 대기 중 - 메시지 보류 (%d개)"), DeferredMessages.Num());
+        return;
+    }
+
+    // API 키 확인
+    if (!PrepareBackendAPIKey())
+    {
+        UE_LOG(LogAIDM, Error, TEXT("API Key not available"));
+        BroadcastResponse(Session, false, TEXT("API Key missing"));
+
+        AIDM_SCREEN_MESSAGE(3.0f, FColor::Red, TEXT("API Key missing!"));
+        return;
+    }
+
+    if (Message.IsEmpty())
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("Empty message"));
+        return;
+    }
+
+    // 세션별 동시 요청 한도
+    if (Session->MaxPendingRequests > 0 && Session->PendingRequestCount >= Session->MaxPendingRequests)
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("세션 %s: 대기 중인 요청이 한도(%d)를 넘어 거절"), *Session->GetSessionId().ToString(), Session->MaxPendingRequests);
+        BroadcastResponse(Session, false, TEXT("Too many pending requests"));
+        return;
+    }
+
+    // 세션 토큰 예산
+    if (Session->MaxSessionTokens > 0 && Session->TokensUsed >= Session->MaxSessionTokens)
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("세션 %s: 토큰 예산(%d)을 모두 사용해 거절"), *Session->GetSessionId().ToString(), Session->MaxSessionTokens);
+        BroadcastResponse(Session, false, TEXT("Token budget exceeded"));
+        return;
+    }
+
+    // 허용 여부는 기록하지 않는 미리보기 본문으로 판단 (창은 줄기만 하므로 토큰 수는 상한)
+    FAILengthDecision Length;
+    int32 PromptTokens = 0;
+    FString Body = CreateRequestBody(Session, Message, &Length, true, &PromptTokens);
+
+    // 같은 본문이 이미 진행 중이면 그 응답을 함께 받음
+    int32 InFlightId = INDEX_NONE;
+    TArray<int32> Candidates;
+    InFlightByBodyHash.MultiFind(FCrc::StrCrc32(*Body), Candidates);
+    for (int32 CandidateId : Candidates)
+    {
+        const FAIInFlightRequest* Candidate = InFlightRequests.Find(CandidateId);
+        if (Candidate && Candidate->Body == Body)
+        {
+            InFlightId = CandidateId;
+            break;
+        }
+    }
+
+    // 분당 토큰 한도 (합쳐진 요청은 새로 쓰는 토큰이 없음)
+    const int32 EstimatedTokens = PromptTokens + Length.MaxTokens;
+    if (InFlightId == INDEX_NONE && !TokenRate.TryAdmit(EAIRequestPriority::Foreground, Session->GetSessionId(), EstimatedTokens))
+    {
+        QueueRateLimitedMessage(Session, Message, Trace, EstimatedTokens);
+        return;
+    }
+    if (InFlightId != INDEX_NONE)
+    {
+        CoalescedRequestCount++;
+    }
+    else
+    {
+        // 허용된 뒤에만 창 이동과 캐시 통계를 기록하는 실제 본문 생성
+        Body = CreateRequestBody(Session, Message, &Length, false, &PromptTokens);
+    }
+
+    LatencyTracker.BeginRequest(Trace);
+
+    // 플레이어 요청이 대기 중이면 요약은 미룬다
+    Session->PendingRequestCount++;
+    GetWorldTimerManager().ClearTimer(Session->SummaryTimerHandle);
+
+    // 세션 로그 기록 (요청 본문 생성 후 컨텍스트에 추가)
+    Session->AppendSessionRecord(EAISessionRecordType::UserMessage, Message);
+
+    Trace.Mark(EAITraceStage::RequestSent);
+
+    if (InFlightId != INDEX_NONE)
+    {
+        InFlightRequests[InFlightId].Deliveries.Add({ Session, Trace });
+    }
+    else
+    {
+        // 백엔드가 즉시 완료해도 전달되도록 먼저 등록
+        FAIInFlightRequest& InFlight = InFlightRequests.Add(Trace.RequestId);
+        InFlight.Body = Body;
+        InFlight.PromptTokens = PromptTokens;
+        InFlight.Length = Length;
+        InFlight.SessionId = Session->GetSessionId();
+        InFlight.ReservedTokens = EstimatedTokens;
+        InFlight.Deliveries.Add({ Session, Trace });
+        InFlightByBodyHash.Add(FCrc::StrCrc32(*Body), Trace.RequestId);
+
+        // 요청 전송
+        FAIChatRequest ChatRequest;
+        ChatRequest.Body = Body;
+        ChatRequest.bStream = bStreamResponses;
+        Backend->SendRequest(ChatRequest,
+            FOnAIChatChunk::CreateUObject(this, &AAIManager::OnBackendChunk, Trace.RequestId),
+            FOnAIChatComplete::CreateUObject(this, &AAIManager::OnBackendResponse, Trace.RequestId));
+    }
+
+    AIDM_EVENT(Log, "RequestSent", AIDM_FIELD("id", Trace.RequestId), AIDM_FIELD("session", Session->GetSessionId().ToString()),
+        AIDM_FIELD("chars", Message.Len()), AIDM_FIELD("text", Message));
+
+    AIDM_SCREEN_MESSAGE(3.0f, FColor::Yellow, TEXT("Sending to AI..."));
+}
+
+bool AAIManager::TryHandleLocalIntent(UAIConversationSession* Session, const FString& Message, FAIRequestTrace& Trace)
+{
+    // 마지막 묘사 뒤 장면이 바뀌었으면 묘사를 되풀이하는 명령(둘러보기)은 모델로
+    const FString LastNarration = Session->LastModelNarrationSceneVersion == Session->SceneVersion ? Session->LastModelNarration : FString();
+
+    FParsedAction Action;
+    FString Narration;
+    if (!IntentRouter->TryRoute(Message, ActionParser, LastNarration, Action, Narration))
+    {
+        return false;
+    }
+
+    // 네트워크 구간이 0인 요청으로 지연 추적 (전체 지연 백분위에 반영)
+    LatencyTracker.BeginRequest(Trace);
+    Trace.Mark(EAITraceStage::RequestSent);
+    Trace.Mark(EAITraceStage::ResponseReceived);
+    Trace.Mark(EAITraceStage::JsonParsed);
+
+    // 모델 응답과 같은 형태로 기록 (다음 요청 컨텍스트에도 포함)
+    Session->AppendSessionRecord(EAISessionRecordType::UserMessage, Message);
+    Session->AppendSessionRecord(EAISessionRecordType::AIResponse, Narration);
+    Session->AppendSessionRecord(EAISessionRecordType::ParsedAction, FString::Printf(TEXT("%s|%s|%s"),
+        *UEnum::GetValueAsString(Action.ActionType), *Action.Command, *Action.Target));
+
+    if (ActionParser)
+    {
+        ActionParser->OnActionParsed.Broadcast(Action);
+    }
+    Trace.Mark(EAITraceStage::ActionsParsed);
+    Session->LastParsedActions = { Action };
+    LocalIntentCount++;
+    UpdateSemanticCache(Session, Message, Narration, Session->LastParsedActions, false);
+
+    BroadcastResponse(Session, true, Narration);
+    Trace.Mark(EAITraceStage::Delivered);
+    LatencyTracker.CompleteRequest(Trace, true);
+
+    FAIModelRoute LocalRoute;
+    LocalRoute.Model = TEXT("intent-router");
+    RouteTracker.Record(EAIModelRoute::Local, LocalRoute, true, static_cast<float>(Trace.GetTotalMs(EAITraceStage::Delivered)), FAITokenUsage(), 0, 0);
+    AIDM_EVENT(Log, "LocalIntent", AIDM_FIELD("id", Trace.RequestId), AIDM_FIELD("session", Session->GetSessionId().ToString()),
+        AIDM_FIELD("type", UEnum::GetValueAsString(Action.ActionType)), AIDM_FIELD("total_ms", Trace.GetTotalMs(EAITraceStage::Delivered)));
+    return true;
+}
+
+void AAIManager::BroadcastResponse(UAIConversationSession* Session, bool bSuccess, const FString& Response)
+{
+    Session->OnAIResponse.Broadcast(bSuccess, Response);
+    if (Session->GetSessionId() == DefaultSessionId)
+    {
+        OnAIResponse.Broadcast(bSuccess, Response);
+    }
+}
+
+void AAIManager::OnBackendChunk(const FString& Chunk, int32 RequestId)
+{
+    const FAIInFlightRequest* InFlight = InFlightRequests.Find(RequestId);
+    if (!InFlight)
+    {
+        return;
+    }
+
+    for (const FAIPendingDelivery& Delivery : InFlight->Deliveries)
+    {
+        UAIConversationSession* Session = Delivery.Session.Get();
+        if (Session && Session->Manager == this)
+        {
+            BroadcastChunk(Session, Chunk);
+        }
+    }
+}
+
+void AAIManager::BroadcastChunk(UAIConversationSession* Session, const FString& Chunk)
+{
+    Session->OnAIResponseChunk.Broadcast(Chunk);
+    if (Session->GetSessionId() == DefaultSessionId)
+    {
+        OnAIResponseChunk.Broadcast(Chunk);
+    }
 }
 
-void AAIManager::BeginPlay()
-{
-    Super::BeginPlay();
+void AAIManager::OnBackendResponse(const FAIChatResult& Result, int32 RequestId)
+{
+    FAIInFlightRequest InFlight;
+    if (!InFlightRequests.RemoveAndCopyValue(RequestId, InFlight))
+    {
+        return;
+    }
+    InFlightByBodyHash.RemoveSingle(FCrc::StrCrc32(*InFlight.Body), RequestId);
+
+    for (FAIPendingDelivery& Delivery : InFlight.Deliveries)
+    {
+        Delivery.Trace.Mark(EAITraceStage::ResponseReceived);
+    }
+
+    FString Content;
+    FAITokenUsage Usage;
+    FString FinishReason;
+    const bool bSuccess = ReadChatResult(Result, Content, true, &Usage, &FinishReason);
+    const int32 UsedTokens = RecordRouteUsage(EAIModelRoute::Narration, bSuccess, Result.TotalMs, Usage, InFlight.PromptTokens, Content);
+    SettleTokenRate(EAIRequestPriority::Foreground, InFlight.SessionId, InFlight.ReservedTokens, UsedTokens, Result.ResponseCode);
+    if (bSuccess)
+    {
+        RecordResponseLength(InFlight.Length, Result, FinishReason, Usage, Content);
+    }
+    if (Result.bDeadlineFallback)
+    {
+        AIDM_EVENT(Warning, "DeadlineFallback", AIDM_FIELD("id", RequestId), AIDM_FIELD("ms", Result.TotalMs), AIDM_FIELD("chars", Content.Len()));
+    }
+
+    // 액션 파싱은 합쳐진 요청 전체에 한 번만
+    TArray<FParsedAction> ParsedActions;
+    float ParseMs = 0.0f;
+    if (bSuccess && ActionParser)
+    {
+        for (FAIPendingDelivery& Delivery : InFlight.Deliveries)
+        {
+            Delivery.Trace.Mark(EAITraceStage::JsonParsed);
+        }
+
+        const double ParseStartTime = FPlatformTime::Seconds();
+        ParsedActions = ActionParser->ParseAIResponse(Content);
+        ParseMs = static_cast<float>((FPlatformTime::Seconds() - ParseStartTime) * 1000.0);
+    }
+
+    for (FAIPendingDelivery& Delivery : InFlight.Deliveries)
+    {
+        // 제거되었거나 다른 매니저로 넘어간 세션은 건너뜀
+        UAIConversationSession* Session = Delivery.Session.Get();
+        if (!Session || Session->Manager != this)
+        {
+            LatencyTracker.CompleteRequest(Delivery.Trace, false);
+            continue;
+        }
+
+        // 합쳐진 요청은 받은 세션마다 청구
+        Session->TokensUsed += UsedTokens;
+
+        const float ResponseMs = static_cast<float>(Delivery.Trace.GetMs(EAITraceStage::RequestSent, EAITraceStage::ResponseReceived));
+        DeliverResponse(Session, Delivery.Trace, bSuccess, Content, ParsedActions, ParseMs, ResponseMs);
+    }
+
+    if (bSuccess)
+    {
+        AIDM_SCREEN_MESSAGE(8.0f, FColor::Green, FString::Printf(TEXT("AI: %s"), *Content));
+    }
+}
+
+int32 AAIManager::RecordRouteUsage(EAIModelRoute Route, bool bSuccess, float LatencyMs, const FAITokenUsage& Usage, int32 PromptTokens, const FString& Content)
+{
+    const int32 CompletionTokens = bSuccess && Usage.CompletionTokens <= 0 ? CountTokens(Content) : 0;
+    RouteTracker.Record(Route, GetConfig().GetRoute(Route), bSuccess, LatencyMs, Usage, PromptTokens, CompletionTokens);
+    return (Usage.PromptTokens > 0 ? Usage.PromptTokens : PromptTokens) + (Usage.CompletionTokens > 0 ? Usage.CompletionTokens : CompletionTokens);
+}
+
+void AAIManager::RecordResponseLength(const FAILengthDecision& Length, const FAIChatResult& Result, const FString& FinishReason, const FAITokenUsage& Usage, FString& InOutContent)
+{
+    // 마감 시간 대체 응답은 모델이 끝낸 길이가 아님
+    if (Length.MaxTokens <= 0 || Result.bDeadlineFallback)
+    {
+        return;
+    }
+
+    const int32 CompletionTokens = Usage.CompletionTokens > 0 ? Usage.CompletionTokens : CountTokens(InOutContent);
+    const float FirstChunkMs = Result.Chunks.Num() > 0 ? Result.Chunks[0].OffsetMs : -1.0f;
+    ResponseLength.Record(Length, CompletionTokens, FinishReason, FirstChunkMs, Result.TotalMs);
+
+    if (FinishReason == TEXT("length"))
+    {
+        AIDM_EVENT(Verbose, "ResponseTruncated", AIDM_FIELD("type", UEnum::GetValueAsString(Length.Intent)),
+            AIDM_FIELD("max_tokens", Length.MaxTokens), AIDM_FIELD("tokens", CompletionTokens));
+        if (bTrimTruncatedResponses)
+        {
+            InOutContent = FAIResponseLengthController::TrimToLastSentence(InOutContent);
+        }
+    }
+}
+
+void AAIManager::SettleTokenRate(EAIRequestPriority Priority, FName SessionId, int32 ReservedTokens, int32 UsedTokens, int32 ResponseCode)
+{
+    TokenRate.Settle(Priority, SessionId, ReservedTokens, UsedTokens);
+    if (ResponseCode == 429)
+    {
+        TokenRate.OnRateLimited();
+        AIDM_EVENT(Warning, "RateLimited", AIDM_FIELD("priority", UEnum::GetValueAsString(Priority)), AIDM_FIELD("session", SessionId.ToString()));
+    }
+}
+
+void AAIManager::ReleaseTokenRate(EAIRequestPriority Priority, FName SessionId, int32 ReservedTokens, int32 PromptTokens)
+{
+    if (ReservedTokens <= 0)
+    {
+        return;
+    }
+    TokenRate.Settle(Priority, SessionId, ReservedTokens, FMath::Min(PromptTokens, ReservedTokens));
+}
+
+int32 AAIManager::AddBackgroundReservation(FName SessionId, int32 PromptTokens, int32 ReservedTokens)
+{
+    const int32 ReservationId = ++LastBackgroundReservationId;
+    BackgroundReservations.Add(ReservationId, { SessionId, PromptTokens, ReservedTokens });
+    return ReservationId;
+}
+
+void AAIManager::SettleBackgroundReservation(int32 ReservationId, int32 UsedTokens, int32 ResponseCode)
+{
+    // 없으면 이미 해제됨 (EndPlay)
+    FAIBackgroundReservation Reservation;
+    if (BackgroundReservations.RemoveAndCopyValue(ReservationId, Reservation))
+    {
+        SettleTokenRate(EAIRequestPriority::Background, Reservation.SessionId, Reservation.ReservedTokens, UsedTokens, ResponseCode);
+    }
+}
+
+void AAIManager::QueueRateLimitedMessage(UAIConversationSession* Session, const FString& Message, const FAIRequestTrace& Trace, int32 EstimatedTokens)
+{
+    FAIDeferredMessage Deferred{ Session, Message, Trace, FPlatformTime::Seconds(), EstimatedTokens };
+    if (FlushingMessage)
+    {
+        // 다시 보내다 또 걸린 턴은 원래 자리와 대기 시작 시각 유지
+        Deferred.QueuedTime = FlushingMessage->QueuedTime;
+        RateLimitedMessages.Insert(MoveTemp(Deferred), RateLimitFlushIndex);
+    }
+    else
+    {
+        RateLimitedMessages.Add(MoveTemp(Deferred));
+        AIDM_EVENT(Log, "RateLimitQueued", AIDM_FIELD("session", Session->GetSessionId().ToString()), AIDM_FIELD("tokens", EstimatedTokens),
+            AIDM_FIELD("queued", RateLimitedMessages.Num()));
+
+        if (!GetWorldTimerManager().IsTimerActive(RateLimitTimerHandle))
+        {
+            const float WaitSeconds = TokenRate.GetWaitSeconds(EAIRequestPriority::Foreground, Session->GetSessionId(), EstimatedTokens);
+            GetWorldTimerManager().SetTimer(RateLimitTimerHandle, this, &AAIManager::FlushRateLimitedMessages, FMath::Clamp(WaitSeconds, 0.05f, 1.0f), false);
+        }
+    }
+
+    // 기다리는 턴이 있는 동안 요약/예측 요청은 보내지 않음
+    TokenRate.SetForegroundWaiting(true);
+}
+
+void AAIManager::FlushRateLimitedMessages()
+{
+    const double Now = FPlatformTime::Seconds();
+    float NextWaitSeconds = 1.0f;
+
+    // 세션마다 맨 앞 턴만 보낼 수 있음 (한 세션이 막혀도 다른 세션은 진행)
+    TSet<UAIConversationSession*> BlockedSessions;
+    int32 Index = 0;
+    while (Index < RateLimitedMessages.Num())
+    {
+        const FAIDeferredMessage Queued = RateLimitedMessages[Index];
+        UAIConversationSession* Session = Queued.Session.Get();
+        if (!Session || Session->Manager != this)
+        {
+            RateLimitedMessages.RemoveAt(Index);
+            continue;
+        }
+        if (BlockedSessions.Contains(Session))
+        {
+            Index++;
+            continue;
+        }
+
+        if (Now - Queued.QueuedTime > MaxRateLimitWaitSeconds)
+        {
+            RateLimitedMessages.RemoveAt(Index);
+            UE_LOG(LogAIDM, Warning, TEXT("세션 %s: 토큰 속도 한도로 %.0f초를 기다려 거절"), *Session->GetSessionId().ToString(), Now - Queued.QueuedTime);
+            BroadcastResponse(Session, false, TEXT("Rate limit exceeded"));
+            continue;
+        }
+
+        const float WaitSeconds = TokenRate.GetWaitSeconds(EAIRequestPriority::Foreground, Session->GetSessionId(), Queued.EstimatedTokens);
+        if (WaitSeconds > 0.0f)
+        {
+            BlockedSessions.Add(Session);
+            NextWaitSeconds = FMath::Min(NextWaitSeconds, WaitSeconds);
+            Index++;
+            continue;
+        }
+
+        RateLimitedMessages.RemoveAt(Index);
+        const int32 NumBefore = RateLimitedMessages.Num();
+        FlushingMessage = &Queued;
+        RateLimitFlushIndex = Index;
+        SendSessionMessage(Session, Queued.Message, Queued.Trace);
+        FlushingMessage = nullptr;
+
+        // 현재 본문 기준으로 다시 걸림
+        if (RateLimitedMessages.Num() > NumBefore)
+        {
+            BlockedSessions.Add(Session);
+            Index++;
+        }
+    }
+
+    TokenRate.SetForegroundWaiting(RateLimitedMessages.Num() > 0);
+    if (RateLimitedMessages.Num() > 0)
+    {
+        GetWorldTimerManager().SetTimer(RateLimitTimerHandle, this, &AAIManager::FlushRateLimitedMessages, FMath::Max(NextWaitSeconds, 0.05f), false);
+    }
+}
+
+int32 AAIManager::CountTokens(const FString& Text) const
+{
+    return Tokenizer ? Tokenizer->CountTokens(Text) : FAITokenUsage::EstimateTokens(Text);
+}
+
+FAIRequestEstimate AAIManager::EstimateRequest(const FString& Message)
+{
+    UAIConversationSession* Session = GetDefaultSession();
+    const int32 LastPromptTokens = Session && Session->PromptAssembler ? Session->PromptAssembler->GetCacheStats().LastPromptTokens : 0;
+    const int32 PromptTokens = LastPromptTokens + CountTokens(Message) + FAITokenizer::MessageOverheadTokens;
+    return RouteTracker.Estimate(EAIModelRoute::Narration, GetConfig().GetRoute(EAIModelRoute::Narration), PromptTokens);
+}
+
+bool AAIManager::ReadChatResult(const FAIChatResult& Result, FString& OutContent, bool bReportErrors, FAITokenUsage* OutUsage, FString* OutFinishReason)
+{
+    if (!Result.bSuccess)
+    {
+        OutContent = TEXT("Network error");
+        if (bReportErrors)
+        {
+            UE_LOG(LogAIDM, Error, TEXT("HTTP request failed"));
+            AIDM_SCREEN_MESSAGE(3.0f, FColor::Red, TEXT("Network error"));
+        }
+        return false;
+    }
+
+    if (Result.ResponseCode != 200)
+    {
+        OutContent = FString::Printf(TEXT("HTTP Error: %d"), Result.ResponseCode);
+        if (bReportErrors)
+        {
+            UE_LOG(LogAIDM, Error, TEXT("HTTP error code: %d"), Result.ResponseCode);
+            AIDM_SCREEN_MESSAGE(3.0f, FColor::Red, OutContent);
+        }
+        return false;
+    }
+
+    // JSON 파싱 (스트리밍/로컬 백엔드는 이미 조립된 텍스트)
+    OutContent = Result.Content;
+    if (OutFinishReason)
+    {
+        *OutFinishReason = Result.FinishReason;
+    }
+    if (Result.bHasContent || ExtractCompletionContent(Result.ResponseBody, OutContent, OutUsage, OutFinishReason))
+    {
+        return true;
+    }
+
+    OutContent = TEXT("Parse error");
+    if (bReportErrors)
+    {
+        UE_LOG(LogAIDM, Error, TEXT("Failed to parse AI response"));
+        AIDM_SCREEN_MESSAGE(3.0f, FColor::Red, TEXT("Parse error"));
+    }
+    return false;
+}
+
+void AAIManager::CompleteSessionResponse(UAIConversationSession* Session, FAIRequestTrace& Trace, bool bSuccess, const FString& Content)
+{
+    TArray<FParsedAction> ParsedActions;
+    float ParseMs = 0.0f;
+    if (bSuccess && ActionParser)
+    {
+        Trace.Mark(EAITraceStage::JsonParsed);
+
+        const double ParseStartTime = FPlatformTime::Seconds();
+        ParsedActions = ActionParser->ParseAIResponse(Content);
+        ParseMs = static_cast<float>((FPlatformTime::Seconds() - ParseStartTime) * 1000.0);
+    }
+
+    const float ResponseMs = static_cast<float>(Trace.GetMs(EAITraceStage::RequestSent, EAITraceStage::ResponseReceived));
+    DeliverResponse(Session, Trace, bSuccess, Content, ParsedActions, ParseMs, ResponseMs);
+}
+
+void AAIManager::DeliverResponse(UAIConversationSession* Session, FAIRequestTrace& Trace, bool bSuccess, const FString& Content,
+    const TArray<FParsedAction>& ParsedActions, float ParseMs, float ResponseMs)
+{
+    // 대기열이 비면 유휴 시간 후 요약 시도
+    Session->PendingRequestCount = FMath::Max(0, Session->PendingRequestCount - 1);
+    ScheduleSummaryFold(Session);
+
+    if (!bSuccess)
+    {
+        Session->LastParsedActions.Reset();
+        LatencyTracker.CompleteRequest(Trace, false);
+        BroadcastResponse(Session, false, Content);
+        return;
+    }
+
+    if (!Trace.HasStage(EAITraceStage::JsonParsed))
+    {
+        Trace.Mark(EAITraceStage::JsonParsed);
+    }
+
+    // 세션 로그 기록 (응답, 파싱된 액션, 소요 시간)
+    Session->AppendSessionRecord(EAISessionRecordType::AIResponse, Content, ResponseMs);
+    Session->LastModelNarration = Content;
+    Session->LastModelNarrationSceneVersion = Session->SceneVersion;
 
-    // 액션 파서 생성 (UObject로 안전하게)
-    if (!ActionParser)
+    if (ActionParser)
     {
-        ActionParser = NewObject<UAIActionParser>(this);
-        if (ActionParser)
+        for (const FParsedAction& Action : ParsedActions)
         {
-            UE_LOG(LogTemp, Log, TEXT("액션 파서 생성 완료"));
-        }
-        else
-        {
-            UE_LOG(LogTemp, Error, TEXT("액션 파서 생성 실패"));
+            Session->AppendSessionRecord(EAISessionRecordType::ParsedAction, FString::Printf(TEXT("%s|%s|%s"),
+                *UEnum::GetValueAsString(Action.ActionType), *Action.Command, *Action.Target));
         }
+        Session->AppendSessionRecord(EAISessionRecordType::Timing, TEXT("Parse"), ParseMs);
     }
+    Session->AppendSessionRecord(EAISessionRecordType::Timing, TEXT("Response"), ResponseMs);
+
+    Trace.Mark(EAITraceStage::ActionsParsed);
+    Session->LastParsedActions = ParsedActions;
+
+    // 대기 중인 요청이 이것뿐이면 LastPlayerInput이 이 응답의 입력
+    UpdateSemanticCache(Session, Session->LastPlayerInput, Content, ParsedActions, Session->PendingRequestCount == 0 && !bServingSemanticCache);
+
+    // 채팅 화면 표시(AddAIMessage)까지 포함
+    BroadcastResponse(Session, true, Content);
+    Trace.Mark(EAITraceStage::Delivered);
+    LatencyTracker.CompleteRequest(Trace, true);
+    ScheduleSpeculation(Session);
+    AIDM_EVENT(Log, "ResponseReceived", AIDM_FIELD("id", Trace.RequestId), AIDM_FIELD("session", Session->GetSessionId().ToString()),
+        AIDM_FIELD("total_ms", Trace.GetTotalMs(EAITraceStage::Delivered)), AIDM_FIELD("network_ms", ResponseMs),
+        AIDM_FIELD("chars", Content.Len()), AIDM_FIELD("text", Content));
+}
+
+FString AAIManager::CreateRequestBody(UAIConversationSession* Session, const FString& Message, FAILengthDecision* OutLength,
+    bool bPreview, int32* OutPromptTokens)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_CreateRequestBody, AIDMChannel);
 
-    UE_LOG(LogTemp, Log, TEXT("AI Manager initialized - ready for use"));
+    UAIPromptAssembler* PromptAssembler = Session->PromptAssembler;
+    const TArray<FAISessionRecord>& ConversationHistory = Session->ConversationHistory;
 
-    if (GEngine)
+    // 지금까지의 캠페인 요약 (요약된 턴은 기록에서 다시 보내지 않음)
+    if (Session->Summarizer)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, TEXT("AI Manager Ready"));
+        const FAICampaignSummary Summary = Session->Summarizer->GetSummary();
+        PromptAssembler->SetSummary(Summary.Text, Summary.Version);
     }
 
-    // 자동 테스트 실행 (디버그용)
-    FTimerHandle TestTimerHandle;
-    GetWorld()->GetTimerManager().SetTimer(TestTimerHandle, [this]()
+    // 최근 대화 기록 (창은 여러 턴 단위로만 이동)
+    const int32 WindowStart = bPreview ? PromptAssembler->FindRecentTurnWindowStart(ConversationHistory)
+        : PromptAssembler->SelectRecentTurnWindow(ConversationHistory, MaxContextTurns, ContextWindowStep, MaxContextTokens);
+    PromptAssembler->SetRecentTurns(ConversationHistory, WindowStart);
+
+    // 오래된 턴 중 현재 입력과 관련된 기억 (최근 턴은 이미 포함되므로 제외)
+    TArray<FAIMemoryHit> Memories;
+    if (Session->RetrievalMemory && RecallTopK > 0)
     {
-        if (ActionParser)
+        // 실패한 요청은 응답 없이 입력만 남으므로 응답 수로 셈 (요약기와 같은 기준)
+        int32 TurnsInWindow = 0;
+        for (int32 i = FMath::Max(0, WindowStart); i < ConversationHistory.Num(); i++)
         {
-            UE_LOG(LogTemp, Warning, TEXT("=== 자동 테스트 시작 ==="));
-            TestActionParser(TEXT("move to the door"));
-            TestActionParser(TEXT("[attack orc]"));
-            TestActionParser(TEXT("*look around*"));
+            if (ConversationHistory[i].RecordType == EAISessionRecordType::AIResponse)
+            {
+                TurnsInWindow++;
+            }
         }
-    }, 2.0f, false);
+        Memories = Session->RetrievalMemory->Recall(Message, RecallTopK, RecallMinScore, TurnsInWindow);
+    }
+    PromptAssembler->SetRecalledMemories(Memories);
+
+    // 주변 상태 (스냅샷은 가끔만 바뀌어 앞쪽에, 변경분은 입력 바로 앞에)
+    const bool bWorldState = bIncludeWorldState && Session->WorldObserver.IsValid();
+    PromptAssembler->SetWorldState(bWorldState ? Session->WorldState.GetSnapshot() : FString(), Session->WorldState.GetSnapshotVersion());
+    PromptAssembler->SetWorldDelta(bWorldState ? Session->WorldState.GetDelta() : FString());
+
+    // 사용자 메시지
+    PromptAssembler->SetUserInput(Message);
+
+    // 응답 길이 (max_tokens는 프롬프트 뒤에 있어 접두 캐시에 영향 없음)
+    const FAIModelRoute Route = GetConfig().GetRoute(EAIModelRoute::Narration);
+    FAILengthDecision Length;
+    Length.MaxTokens = Route.MaxTokens;
+    if (bAdaptiveMaxTokens)
+    {
+        const EActionType Intent = ActionParser ? ActionParser->ClassifyActionType(Message) : EActionType::Unknown;
+        Length = ResponseLength.Select(Intent, Route.MaxTokens);
+    }
+    if (OutLength)
+    {
+        *OutLength = Length;
+    }
+
+    if (bPreview)
+    {
+        return PromptAssembler->PreviewRequestBody(Route.Model, Length.MaxTokens, Route.Temperature, bStreamResponses, OutPromptTokens);
+    }
+
+    const FString Body = PromptAssembler->BuildRequestBody(Route.Model, Length.MaxTokens, Route.Temperature, bStreamResponses);
+    if (OutPromptTokens)
+    {
+        *OutPromptTokens = PromptAssembler->GetCacheStats().LastPromptTokens;
+    }
+    return Body;
 }
 
-void AAIManager::SendMessage(const FString& Message)
+void AAIManager::CreateBackend()
 {
-    // API 키 확인
-    FString CurrentAPIKey = GetAPIKey();
+    // 명령줄이 에디터 설정보다 우선
+    FString CommandLineRecordPath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("aidmrecord="), CommandLineRecordPath))
+    {
+        RecordSessionPath = CommandLineRecordPath;
+    }
+    FString CommandLineReplayPath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("aidmreplay="), CommandLineReplayPath))
+    {
+        ReplaySessionPath = CommandLineReplayPath;
+    }
+    FParse::Value(FCommandLine::Get(), TEXT("aidmreplayspeed="), ReplayTimeScale);
+    FString CommandLineLocalModelPath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("aidmlocal="), CommandLineLocalModelPath))
+    {
+        LocalModelPath = CommandLineLocalModelPath;
+    }
+    FParse::Value(FCommandLine::Get(), TEXT("aidmlocalthreads="), LocalThreadCount);
 
-    if (CurrentAPIKey.IsEmpty())
+    if (!ReplaySessionPath.IsEmpty())
+    {
+        Backend = MakeShared<FAIReplayBackend>(ReplaySessionPath, ReplayTimeScale);
+    }
+    else if (!LocalModelPath.IsEmpty())
+    {
+        // 오프라인 플레이, 네트워크 없는 벤치마크용 (헤지 없음)
+        FAILocalBackendSettings LocalSettings;
+        LocalSettings.ModelPath = LocalModelPath;
+        LocalSettings.MaxThreads = LocalThreadCount;
+        LocalSettings.ContextSize = LocalContextSize;
+        Backend = MakeShared<FAILocalBackend>(LocalSettings);
+        if (!RecordSessionPath.IsEmpty())
+        {
+            Backend = MakeShared<FAIRecordingBackend>(Backend, RecordSessionPath);
+        }
+    }
+    else
     {
-        UE_LOG(LogTemp, Error, TEXT("API Key not available"));
-        OnAIResponse.Broadcast(false, TEXT("API Key missing"));
+        Backend = MakeShared<FAIOpenAIBackend>();
 
-        if (GEngine)
+        // 응답이 늦으면 보조 엔드포인트로도 요청 (기록은 이긴 쪽 응답만)
+        if (bEnableHedging)
         {
-            GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("API Key missing!"));
+            HedgedBackend = MakeShared<FAIHedgedBackend>(Backend, MakeShared<FAIOpenAIBackend>(), MakeHedgeSettings());
+            Backend = HedgedBackend;
+        }
+        if (!RecordSessionPath.IsEmpty())
+        {
+            Backend = MakeShared<FAIRecordingBackend>(Backend, RecordSessionPath);
         }
-        return;
     }
 
-    if (Message.IsEmpty())
+    UE_LOG(LogAIDM, Log, TEXT("채팅 백엔드: %s"), Backend->GetName());
+    ApplyConfigToBackend();
+}
+
+void AAIManager::BindConfigLoader()
+{
+    if (ConfigLoader)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Empty message"));
         return;
     }
 
-    // HTTP 요청 생성
-    TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
-    Request->OnProcessRequestComplete().BindUObject(this, &AAIManager::OnHttpResponse);
-
-    Request->SetURL(TEXT("https://api.openai.com/v1/chat/completions"));
-    Request->SetVerb(TEXT("POST"));
-    Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
-    Request->SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *CurrentAPIKey));
+    // 서브시스템이 없으면 (커맨드렛 등) 직접 로드
+    UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this);
+    ConfigLoader = Subsystem ? Subsystem->GetConfigLoader() : nullptr;
+    if (!ConfigLoader)
+    {
+        ConfigLoader = MakeShared<FAIDMConfigLoader>();
+        ConfigLoader->Start(0.0f);
+    }
 
-    // JSON 요청 생성
-    Request->SetContentAsString(CreateRequestBody(Message));
-    Request->ProcessRequest();
+    ConfigLoadedHandle = ConfigLoader->OnConfigLoaded().AddUObject(this, &AAIManager::OnConfigLoaded);
+    Config = ConfigLoader->GetConfig();
+}
 
-    UE_LOG(LogTemp, Log, TEXT("Sending: %s"), *Message);
+void AAIManager::OnConfigLoaded(const TSharedRef<const FAIDMConfig>& NewConfig)
+{
+    Config = NewConfig;
+    ApplyConfigToBackend();
 
-    if (GEngine)
+    // 로드 전에 들어온 메시지 전송
+    TArray<FAIDeferredMessage> Pending = MoveTemp(DeferredMessages);
+    DeferredMessages.Reset();
+    for (FAIDeferredMessage& Deferred : Pending)
     {
-        GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Yellow, TEXT("Sending to AI..."));
+        if (UAIConversationSession* Session = Deferred.Session.Get())
+        {
+            SendSessionMessage(Session, Deferred.Message, Deferred.Trace);
+        }
     }
 }
 
-void AAIManager::OnHttpResponse(TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request,
-    TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> Response,
-    bool bSuccess)
+void AAIManager::ApplyConfigToBackend()
 {
-    if (!bSuccess || !Response.IsValid())
+    if (Backend && Config.IsValid())
     {
-        UE_LOG(LogTemp, Error, TEXT("HTTP request failed"));
-        OnAIResponse.Broadcast(false, TEXT("Network error"));
+        Backend->SetAPIKey(Config->APIKey);
+        Backend->SetEndpoint(Config->Endpoint, Config->RequestTimeoutSeconds);
+        if (HedgedBackend)
+        {
+            HedgedBackend->SetSecondaryEndpoint(Config->HedgeEndpoint.IsEmpty() ? Config->Endpoint : Config->HedgeEndpoint, Config->RequestTimeoutSeconds);
+            HedgedBackend->SetSecondaryModel(Config->HedgeModel);
+        }
 
-        if (GEngine)
+        // 엔드포인트가 정해진 시점(로딩 중)에 연결을 미리 맺음
+        if (bPrewarmConnection)
         {
-            GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Network error"));
+            Backend->WarmConnection(KeepAliveInterval);
         }
-        return;
     }
+}
 
-    int32 ResponseCode = Response->GetResponseCode();
-    if (ResponseCode != 200)
-    {
-        UE_LOG(LogTemp, Error, TEXT("HTTP error code: %d"), ResponseCode);
-        OnAIResponse.Broadcast(false, FString::Printf(TEXT("HTTP Error: %d"), ResponseCode));
+FAIHedgeSettings AAIManager::MakeHedgeSettings() const
+{
+    FAIHedgeSettings Settings;
+    Settings.HedgePercentile = HedgePercentile;
+    Settings.MinHedgeDelayMs = MinHedgeDelayMs;
+    Settings.MaxHedgeDelayMs = FMath::Max(MinHedgeDelayMs, MaxHedgeDelayMs);
+    Settings.HardDeadlineMs = ResponseDeadlineMs;
+    Settings.FallbackResponse = DeadlineFallbackResponse;
+    return Settings;
+}
 
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red,
-                FString::Printf(TEXT("HTTP Error: %d"), ResponseCode));
-        }
-        return;
+const FAIDMConfig& AAIManager::GetConfig() const
+{
+    static const FAIDMConfig DefaultConfig;
+    return Config.IsValid() ? *Config : DefaultConfig;
+}
+
+void AAIManager::ReloadConfig()
+{
+    BindConfigLoader();
+    ConfigLoader->Reload();
+}
+
+bool AAIManager::PrepareBackendAPIKey()
+{
+    if (!Backend)
+    {
+        CreateBackend();
     }
 
-    // JSON 파싱
-    FString ResponseString = Response->GetContentAsString();
+    // 키는 설정이 로드될 때 백엔드에 반영됨 (여기서는 파일을 읽지 않음)
+    return !Backend->RequiresAPIKey() || !GetConfig().APIKey.IsEmpty();
+}
+
+bool AAIManager::ExtractCompletionContent(const FString& ResponseString, FString& OutContent, FAITokenUsage* OutUsage, FString* OutFinishReason)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_ExtractCompletionContent, AIDMChannel);
+
     TSharedPtr<FJsonObject> JsonObject;
     TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(ResponseString);
 
@@ -142,245 +1108,558 @@ void AAIManager::OnHttpResponse(TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Re
             TSharedPtr<FJsonObject> Message = (*Choices)[0]->AsObject()->GetObjectField(TEXT("message"));
             if (Message.IsValid())
             {
-                FString Content = Message->GetStringField(TEXT("content"));
-
-                OnAIResponse.Broadcast(true, Content);
-                UE_LOG(LogTemp, Log, TEXT("AI Response: %s"), *Content);
+                OutContent = Message->GetStringField(TEXT("content"));
+                if (OutFinishReason)
+                {
+                    (*Choices)[0]->AsObject()->TryGetStringField(TEXT("finish_reason"), *OutFinishReason);
+                }
 
-                if (GEngine)
+                const TSharedPtr<FJsonObject>* UsageObject = nullptr;
+                if (OutUsage && JsonObject->TryGetObjectField(TEXT("usage"), UsageObject))
                 {
-                    GEngine->AddOnScreenDebugMessage(-1, 8.0f, FColor::Green,
-                        FString::Printf(TEXT("AI: %s"), *Content));
+                    (*UsageObject)->TryGetNumberField(TEXT("prompt_tokens"), OutUsage->PromptTokens);
+                    (*UsageObject)->TryGetNumberField(TEXT("completion_tokens"), OutUsage->CompletionTokens);
                 }
-                return;
+                return true;
             }
         }
     }
 
-    UE_LOG(LogTemp, Error, TEXT("Failed to parse AI response"));
-    OnAIResponse.Broadcast(false, TEXT("Parse error"));
+    return false;
+}
+
+void AAIManager::ScheduleSummaryFold(UAIConversationSession* Session)
+{
+    if (!Session || !Session->Summarizer || Session->PendingRequestCount > 0)
+    {
+        return;
+    }
+
+    GetWorldTimerManager().SetTimer(Session->SummaryTimerHandle,
+        FTimerDelegate::CreateUObject(this, &AAIManager::TryStartSummaryFold, TWeakObjectPtr<UAIConversationSession>(Session)),
+        SummaryIdleDelay, false);
+}
+
+void AAIManager::TryStartSummaryFold(TWeakObjectPtr<UAIConversationSession> WeakSession)
+{
+    // 플레이어 요청이 대기 중이거나 이미 요약 중이면 건너뜀 (다음 응답 후 다시 예약)
+    UAIConversationSession* Session = WeakSession.Get();
+    if (!Session || !Session->Summarizer || Session->PendingRequestCount > 0 || Session->Summarizer->IsFoldInFlight())
+    {
+        return;
+    }
+
+    TArray<FAISessionRecord> TurnsToFold;
+    const int32 RecordsInWindow = Session->ConversationHistory.Num() - Session->PromptAssembler->FindRecentTurnWindowStart(Session->ConversationHistory);
+    if (!Session->Summarizer->CollectTurnsToFold(Session->ConversationHistory, RecordsInWindow, TurnsToFold))
+    {
+        return;
+    }
+
+    if (!PrepareBackendAPIKey())
+    {
+        return;
+    }
+
+    // 요약은 정해진 형식의 짧은 작업이므로 요약 경로 모델로 (설정이 없으면 기본 모델)
+    // 경로에 응답 길이가 없으면 요약기 기본값 (본문의 max_tokens와 예약량이 같도록 여기서 정함)
+    const FAIModelRoute Route = GetConfig().GetRoute(EAIModelRoute::Summary);
+    const int32 MaxTokens = Route.MaxTokens > 0 ? Route.MaxTokens : Session->Summarizer->MaxSummaryTokens;
+    FAIChatRequest ChatRequest;
+    ChatRequest.Body = Session->Summarizer->CreateFoldRequestBody(TurnsToFold, Route.Model, MaxTokens, Route.Temperature);
+    ChatRequest.bLatencyCritical = false;
 
-    if (GEngine)
+    // 분당 토큰 한도 (플레이어 턴 몫을 남길 수 없으면 나중에 다시)
+    const int32 PromptTokens = CountTokens(ChatRequest.Body);
+    const int32 EstimatedTokens = PromptTokens + MaxTokens;
+    if (!TokenRate.TryAdmit(EAIRequestPriority::Background, Session->GetSessionId(), EstimatedTokens))
     {
-        GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("Parse error"));
+        ScheduleSummaryFold(Session);
+        return;
     }
+
+    // 백엔드가 바로 완료해도 CompleteFold가 BeginFold 뒤에 오도록 먼저 시작
+    Session->Summarizer->BeginFold(TurnsToFold);
+    Backend->SendRequest(ChatRequest, FOnAIChatChunk(),
+        FOnAIChatComplete::CreateUObject(this, &AAIManager::OnSummaryResponse, WeakSession, PromptTokens,
+            AddBackgroundReservation(Session->GetSessionId(), PromptTokens, EstimatedTokens)));
+    UE_LOG(LogAIDM, Log, TEXT("캠페인 요약 요청 (%s): 레코드 %d개"), *Session->GetSessionId().ToString(), TurnsToFold.Num());
 }
 
-FString AAIManager::CreateRequestBody(const FString& Message)
+void AAIManager::OnSummaryResponse(const FAIChatResult& Result, TWeakObjectPtr<UAIConversationSession> WeakSession, int32 PromptTokens, int32 ReservationId)
 {
-    TSharedPtr<FJsonObject> JsonObject = MakeShareable(new FJsonObject);
-    JsonObject->SetStringField(TEXT("model"), TEXT("gpt-3.5-turbo"));
-    JsonObject->SetNumberField(TEXT("max_tokens"), 100);
-    JsonObject->SetNumberField(TEXT("temperature"), 0.7);
+    FString NewSummary = Result.Content;
+    FAITokenUsage Usage;
+    const bool bParsed = Result.bSuccess && Result.ResponseCode == 200
+        && (Result.bHasContent || ExtractCompletionContent(Result.ResponseBody, NewSummary, &Usage));
+    const int32 UsedTokens = RecordRouteUsage(EAIModelRoute::Summary, bParsed, Result.TotalMs, Usage, PromptTokens, bParsed ? NewSummary : FString());
 
-    TArray<TSharedPtr<FJsonValue>> Messages;
+    SettleBackgroundReservation(ReservationId, UsedTokens, Result.ResponseCode);
 
-    // 시스템 메시지
-    TSharedPtr<FJsonObject> SystemMsg = MakeShareable(new FJsonObject);
-    SystemMsg->SetStringField(TEXT("role"), TEXT("system"));
-    SystemMsg->SetStringField(TEXT("content"), TEXT("You are a dungeon master for a text adventure game. Keep responses concise and engaging (under 50 words)."));
-    Messages.Add(MakeShareable(new FJsonValueObject(SystemMsg)));
+    UAIConversationSession* Session = WeakSession.Get();
+    if (!Session || !Session->Summarizer)
+    {
+        return;
+    }
+    Session->TokensUsed += UsedTokens;
 
-    // 사용자 메시지
-    TSharedPtr<FJsonObject> UserMsg = MakeShareable(new FJsonObject);
-    UserMsg->SetStringField(TEXT("role"), TEXT("user"));
-    UserMsg->SetStringField(TEXT("content"), Message);
-    Messages.Add(MakeShareable(new FJsonValueObject(UserMsg)));
+    Session->Summarizer->CompleteFold(bParsed, NewSummary);
 
-    JsonObject->SetArrayField(TEXT("messages"), Messages);
+    // 아직 접을 턴이 남아 있으면 다시 예약
+    ScheduleSummaryFold(Session);
+}
 
-    FString OutputString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutputString);
-    FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+void AAIManager::ScheduleSpeculation(UAIConversationSession* Session)
+{
+    if (!bEnableSpeculativePrefetch || !Session || !IntentRouter || Session->PendingRequestCount > 0)
+    {
+        return;
+    }
 
-    return OutputString;
+    GetWorldTimerManager().SetTimer(Session->SpeculationTimerHandle,
+        FTimerDelegate::CreateUObject(this, &AAIManager::TrySpeculate, TWeakObjectPtr<UAIConversationSession>(Session)),
+        SpeculationIdleDelay, false);
 }
 
-FString AAIManager::GetAPIKey()
+void AAIManager::TrySpeculate(TWeakObjectPtr<UAIConversationSession> WeakSession)
 {
-    // 이미 로드된 경우 캐시된 키 반환
-    if (bAPIKeyLoaded && !APIKey.IsEmpty())
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_TrySpeculate, AIDMChannel);
+
+    // 플레이어 요청이 대기 중이면 건너뜀 (다음 응답 후 다시 예약)
+    UAIConversationSession* Session = WeakSession.Get();
+    if (!bEnableSpeculativePrefetch || !Session || Session->Manager != this || !IntentRouter || Session->PendingRequestCount > 0)
+    {
+        return;
+    }
+    if (!Config.IsValid() || !PrepareBackendAPIKey())
     {
-        return APIKey;
+        return;
     }
 
-    // 재 시도 방지하도록 플래그 설정
-    if (bAPIKeyLoaded)
+    // 지난 턴에 만든 예측은 더 이상 쓸 수 없음
+    const int32 TurnVersion = Session->TurnVersion;
+    CancelSpeculations(Session, [](const FString&) { return true; });
+
+    // 본문이 지금 주변 상태를 담도록 (변경분은 키프레임 기준이라 여러 번 갱신해도 잃지 않음)
+    UpdateWorldState(Session);
+
+    // 시간당 예산
+    const double Now = FPlatformTime::Seconds();
+    SpeculationSendTimes.RemoveAll([Now](double SentTime) { return Now - SentTime > 3600.0; });
+
+    int32 InFlightCount = 0;
+    for (const TPair<int32, FAISpeculation>& Pair : Speculations)
     {
-        return TEXT("");
+        InFlightCount += Pair.Value.bReady ? 0 : 1;
     }
 
-    // 안전한 파일 읽기 시도
-    FString LoadedKey = LoadAPIKeyFromFile();
+    TArray<FString> Inputs;
+    IntentRouter->PredictNextInputs(Session->LastParsedActions, Session->LastPlayerInput, SpeculationTopK, Inputs);
 
-    if (!LoadedKey.IsEmpty())
+    for (const FString& Input : Inputs)
     {
-        APIKey = LoadedKey;
-        UE_LOG(LogTemp, Log, TEXT("API key loaded successfully from file"));
+        if (InFlightCount >= MaxSpeculativeInFlight
+            || (MaxSpeculativeRequestsPerHour > 0 && SpeculationSendTimes.Num() >= MaxSpeculativeRequestsPerHour))
+        {
+            break;
+        }
+
+        const int32 SpeculationId = ++LastSpeculationId;
+
+        // 백엔드가 즉시 완료해도 처리되도록 먼저 등록
+        FAISpeculation& Speculation = Speculations.Add(SpeculationId);
+        Speculation.Session = Session;
+        Speculation.Key = UAIIntentRouter::MakeMatchKey(Input);
+        Speculation.TurnVersion = TurnVersion;
+        Speculation.SceneVersion = Session->SceneVersion;
+        Speculation.Cancellation = MakeShared<FAIChatCancellation>();
+        Speculation.SessionId = Session->GetSessionId();
+
+        FAIChatRequest ChatRequest;
+        ChatRequest.Body = CreateRequestBody(Session, Input, &Speculation.Length, true, &Speculation.PromptTokens);
+        ChatRequest.bStream = bStreamResponses;
+        ChatRequest.Cancellation = Speculation.Cancellation;
+        ChatRequest.bLatencyCritical = false;
+
+        // 분당 토큰 한도 (플레이어 턴 몫을 남길 수 없으면 이번 턴은 예측하지 않음)
+        Speculation.ReservedTokens = Speculation.PromptTokens + Speculation.Length.MaxTokens;
+        if (!TokenRate.TryAdmit(EAIRequestPriority::Speculative, Session->GetSessionId(), Speculation.ReservedTokens))
+        {
+            Speculations.Remove(SpeculationId);
+            break;
+        }
+
+        InFlightCount++;
+        SpeculationIssuedCount++;
+        SpeculationSendTimes.Add(Now);
+
+        AIDM_EVENT(Verbose, "SpeculationSent", AIDM_FIELD("id", SpeculationId), AIDM_FIELD("session", Session->GetSessionId().ToString()),
+            AIDM_FIELD("text", Input));
+
+        Backend->SendRequest(ChatRequest,
+            FOnAIChatChunk::CreateUObject(this, &AAIManager::OnSpeculationChunk, SpeculationId),
+            FOnAIChatComplete::CreateUObject(this, &AAIManager::OnSpeculationResponse, SpeculationId));
     }
-    else
+}
+
+void AAIManager::OnSpeculationChunk(const FString& Chunk, int32 SpeculationId)
+{
+    FAISpeculation* Speculation = Speculations.Find(SpeculationId);
+    if (!Speculation)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Could not load API key from file"));
+        return;
     }
 
-    bAPIKeyLoaded = true;
-    return APIKey;
+    Speculation->StreamedText += Chunk;
+
+    // 넘겨받은 요청이면 실제 응답처럼 스트리밍
+    UAIConversationSession* Session = Speculation->Session.Get();
+    if (Speculation->bAdopted && Session && Session->Manager == this)
+    {
+        BroadcastChunk(Session, Chunk);
+    }
 }
 
-FString AAIManager::LoadAPIKeyFromFile()
+void AAIManager::OnSpeculationResponse(const FAIChatResult& Result, int32 SpeculationId)
 {
-    UE_LOG(LogTemp, Log, TEXT("=== Starting safe API key loading ==="));
+    FAISpeculation* Speculation = Speculations.Find(SpeculationId);
+    if (!Speculation)
+    {
+        // 취소됨
+        return;
+    }
+
+    UAIConversationSession* Session = Speculation->Session.Get();
+    const bool bSessionAlive = Session && Session->Manager == this;
+
+    FString Content;
+    FAITokenUsage Usage;
+    FString FinishReason;
+    const bool bSuccess = ReadChatResult(Result, Content, Speculation->bAdopted, &Usage, &FinishReason);
+    const int32 UsedTokens = RecordRouteUsage(EAIModelRoute::Narration, bSuccess, Result.TotalMs, Usage, Speculation->PromptTokens, Content);
+    SettleTokenRate(EAIRequestPriority::Speculative, Speculation->SessionId, Speculation->ReservedTokens, UsedTokens, Result.ResponseCode);
+    Speculation->ReservedTokens = 0;    // 받아 둔 응답을 나중에 취소해도 다시 해제하지 않음
+    if (bSuccess)
+    {
+        RecordResponseLength(Speculation->Length, Result, FinishReason, Usage, Content);
+    }
+    if (bSessionAlive)
+    {
+        Session->TokensUsed += UsedTokens;
+    }
 
-    // 1단계: 엔진 준비 상태 확인
-    if (!IsEngineReady())
+    if (Speculation->bAdopted)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Engine not ready for file operations"));
-        return TEXT("");
+        FAIRequestTrace Trace = Speculation->AdoptedTrace;
+        Speculations.Remove(SpeculationId);
+
+        Trace.Mark(EAITraceStage::ResponseReceived);
+        if (!bSessionAlive)
+        {
+            LatencyTracker.CompleteRequest(Trace, false);
+            return;
+        }
+        CompleteSessionResponse(Session, Trace, bSuccess, Content);
+        return;
     }
 
-    // 2단계: 파일 경로 생성
-    FString FilePath;
-    try
+    // 실패한 예측은 조용히 버림 (플레이어가 입력하면 평소대로 요청)
+    if (!bSuccess || !bSessionAlive)
     {
-        FilePath = FPaths::ProjectDir() + TEXT("api_key.txt");
-        UE_LOG(LogTemp, Log, TEXT("Target file path: %s"), *FilePath);
+        Speculations.Remove(SpeculationId);
+        return;
     }
-    catch (...)
+
+    Speculation->bReady = true;
+    Speculation->Content = MoveTemp(Content);
+    Speculation->Cancellation.Reset();
+}
+
+bool AAIManager::IsSemanticCacheIntent(const FString& Input) const
+{
+    return ActionParser && SemanticCacheIntents.Contains(ActionParser->ClassifyActionType(Input));
+}
+
+bool AAIManager::TryServeSemanticCache(UAIConversationSession* Session, const FString& Message, FAIRequestTrace& Trace)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_TryServeSemanticCache, AIDMChannel);
+
+    if (!IsSemanticCacheIntent(Message))
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to create file path"));
-        return TEXT("");
+        return false;
     }
 
-    // 3단계: 파일 존재 확인
-    if (!DoesFileExistSafely(FilePath))
+    FAISemanticCacheHit Hit;
+    if (!SemanticCache.Find(Session->GetSessionId(), Session->SceneVersion, UAIIntentRouter::MakeMatchKey(Message), SemanticCacheMinScore, Hit))
     {
-        UE_LOG(LogTemp, Warning, TEXT("API key file does not exist: %s"), *FilePath);
-        UE_LOG(LogTemp, Warning, TEXT("Please create api_key.txt in project root with your OpenAI API key"));
-        return TEXT("");
+        return false;
     }
 
-    // 4�ܰ�: ���� ���� �б�
-    FString FileContent = ReadFileContentSafely(FilePath);
+    // 비교용 모델 요청은 이번 턴이 기록되기 전 문맥으로
+    if (SemanticCacheVerifyRate > 0.0f && FMath::FRand() < SemanticCacheVerifyRate)
+    {
+        StartSemanticCacheVerification(Session, Message, Hit.EntryId);
+    }
 
-    if (FileContent.IsEmpty())
+    FString Content = Hit.Response;
+    if (SemanticCacheTemplates.Num() > 0)
     {
-        UE_LOG(LogTemp, Error, TEXT("Failed to read file or file is empty"));
-        return TEXT("");
+        const FString& Template = SemanticCacheTemplates[SemanticTemplateCounter++ % SemanticCacheTemplates.Num()];
+        Content = Template.Replace(TEXT("{response}"), *Hit.Response, ESearchCase::CaseSensitive);
     }
 
-    // 5단계: API 키 유효성 검사
-    FString CleanedKey = FileContent.TrimStartAndEnd();
+    // 네트워크 구간이 0인 모델 응답으로 처리 (액션 파싱, 기록, 예측 예약 동일)
+    LatencyTracker.BeginRequest(Trace);
+    Trace.Mark(EAITraceStage::RequestSent);
+    Session->PendingRequestCount++;
+    Session->AppendSessionRecord(EAISessionRecordType::UserMessage, Message);
+    Trace.Mark(EAITraceStage::ResponseReceived);
+
+    AIDM_EVENT(Log, "SemanticCacheHit", AIDM_FIELD("id", Trace.RequestId), AIDM_FIELD("session", Session->GetSessionId().ToString()),
+        AIDM_FIELD("score", Hit.Score), AIDM_FIELD("cached_input", Hit.Input), AIDM_FIELD("text", Message));
+
+    bServingSemanticCache = true;
+    CompleteSessionResponse(Session, Trace, true, Content);
+    bServingSemanticCache = false;
+    return true;
+}
 
-    if (CleanedKey.StartsWith(TEXT("sk-")) && CleanedKey.Len() > 20)
+void AAIManager::UpdateSemanticCache(UAIConversationSession* Session, const FString& Input, const FString& Content, const TArray<FParsedAction>& ParsedActions, bool bStore)
+{
+    // 장면을 바꿀 수 있는 입력이나 장면을 바꾼 응답이면 이전 응답은 모두 무효
+    const bool bSceneUnchanged = IsSemanticCacheIntent(Input)
+        && !ParsedActions.ContainsByPredicate([this](const FParsedAction& Action) { return !SemanticCacheIntents.Contains(Action.ActionType); });
+    if (!bSceneUnchanged)
     {
-        UE_LOG(LogTemp, Log, TEXT("Valid API key loaded (length: %d)"), CleanedKey.Len());
-        return CleanedKey;
+        Session->SceneVersion++;
+        return;
     }
-    else
+
+    if (bEnableSemanticCache && bStore && !Input.IsEmpty())
     {
-        UE_LOG(LogTemp, Error, TEXT("Invalid API key format. Must start with 'sk-' and be longer than 20 characters"));
-        return TEXT("");
+        SemanticCache.Store(Session->GetSessionId(), Session->SceneVersion, UAIIntentRouter::MakeMatchKey(Input), Content);
     }
 }
 
-bool AAIManager::IsEngineReady()
+void AAIManager::StartSemanticCacheVerification(UAIConversationSession* Session, const FString& Message, int32 EntryId)
 {
-    // 기본적인 엔진 상태 확인
-    if (!GEngine || !IsValid(this))
+    if (!Backend || !Config.IsValid() || !PrepareBackendAPIKey())
     {
-        return false;
+        return;
     }
 
-    // 월드 상태 확인
-    UWorld* World = GetWorld();
-    if (!World)
+    FAILengthDecision Length;
+    FAIChatRequest ChatRequest;
+    int32 PromptTokens = 0;
+    ChatRequest.Body = CreateRequestBody(Session, Message, &Length, true, &PromptTokens);
+    ChatRequest.bStream = bStreamResponses;     // 본문의 stream 값과 같게 (스트리밍 응답도 완료 시 한꺼번에 읽음)
+    ChatRequest.bLatencyCritical = false;
+
+    const int32 EstimatedTokens = PromptTokens + Length.MaxTokens;
+    if (!TokenRate.TryAdmit(EAIRequestPriority::Background, Session->GetSessionId(), EstimatedTokens))
     {
-        return false;
+        return;
     }
 
-    return true;
+    Backend->SendRequest(ChatRequest, FOnAIChatChunk(),
+        FOnAIChatComplete::CreateUObject(this, &AAIManager::OnSemanticCacheVerified, Session->GetSessionId(), EntryId, PromptTokens,
+            AddBackgroundReservation(Session->GetSessionId(), PromptTokens, EstimatedTokens)));
 }
 
-bool AAIManager::DoesFileExistSafely(const FString& FilePath)
+void AAIManager::OnSemanticCacheVerified(const FAIChatResult& Result, FName SessionId, int32 EntryId, int32 PromptTokens, int32 ReservationId)
 {
-    try
+    FString Content;
+    FAITokenUsage Usage;
+    const bool bSuccess = ReadChatResult(Result, Content, false, &Usage);
+    const int32 UsedTokens = RecordRouteUsage(EAIModelRoute::Narration, bSuccess, Result.TotalMs, Usage, PromptTokens, Content);
+    SettleBackgroundReservation(ReservationId, UsedTokens, Result.ResponseCode);
+
+    if (UAIConversationSession* Session = FindSession(SessionId))
     {
-        // ���� ������ ���: FPaths ���
-        return FPaths::FileExists(FilePath);
+        Session->TokensUsed += UsedTokens;
     }
-    catch (...)
+
+    if (bSuccess && SemanticCache.Verify(EntryId, Content, SemanticCacheVerifyMinScore))
     {
-        UE_LOG(LogTemp, Error, TEXT("Exception during file existence check"));
-        return false;
+        AIDM_EVENT(Warning, "SemanticCacheFalseHit", AIDM_FIELD("session", SessionId.ToString()), AIDM_FIELD("entry", EntryId));
     }
 }
 
-FString AAIManager::ReadFileContentSafely(const FString& FilePath)
+void AAIManager::UpdateWorldState(UAIConversationSession* Session)
 {
-    try
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(AIDM_UpdateWorldState, AIDMChannel);
+
+    const AActor* Observer = Session->WorldObserver.Get();
+    const UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this);
+    if (!bIncludeWorldState || !Observer || !Subsystem)
+    {
+        return;
+    }
+
+    TArray<FAIWorldEntity> Entities;
+
+    // 관찰자 자신 (위치 없이 이동 상태만)
+    FAIWorldEntity& Player = Entities.AddDefaulted_GetRef();
+    Player.Id = Observer->GetFName();
+    Player.Kind = TEXT("player");
+    Player.Name = TEXT("You");
+    if (const ACharacter* Character = Cast<ACharacter>(Observer))
     {
-        // ��� 1: ����Ʈ �迭�� �б� (�� ����)
-        TArray<uint8> FileData;
-        if (FFileHelper::LoadFileToArray(FileData, *FilePath))
+        const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+        if (Movement && Movement->IsFalling())
         {
-            // null terminator �߰�
-            FileData.Add(0);
+            Player.State = TEXT("falling");
+        }
+        else if (Movement && Movement->IsCrouching())
+        {
+            Player.State = TEXT("crouched");
+        }
+        else if (Character->GetVelocity().SizeSquared2D() > FMath::Square(10.0f))
+        {
+            Player.State = TEXT("moving");
+        }
+    }
 
-            // UTF8���� FString���� ��ȯ
-            FString Result = FString(UTF8_TO_TCHAR(FileData.GetData()));
-            UE_LOG(LogTemp, Log, TEXT("File read successfully using byte array method"));
-            return Result;
+    const FVector ObserverLocation = Observer->GetActorLocation();
+    const float ObserverYaw = Observer->GetActorRotation().Yaw;
+    const float RadiusSquared = FMath::Square(WorldStateRadius);
+
+    for (const TWeakObjectPtr<UAIWorldEntityComponent>& WeakComponent : Subsystem->GetWorldEntities())
+    {
+        const UAIWorldEntityComponent* Component = WeakComponent.Get();
+        const AActor* Actor = Component ? Component->GetOwner() : nullptr;
+        if (!Actor || Actor == Observer || Actor->IsHidden() || Actor->GetWorld() != GetWorld())
+        {
+            continue;
         }
 
-        // ��� 2: ���� ���ڿ� �б� (���)
-        FString DirectResult;
-        if (FFileHelper::LoadFileToString(DirectResult, *FilePath))
+        const FVector Offset = Actor->GetActorLocation() - ObserverLocation;
+        if (Offset.SizeSquared() > RadiusSquared)
         {
-            UE_LOG(LogTemp, Log, TEXT("File read successfully using direct string method"));
-            return DirectResult;
+            continue;
         }
 
-        UE_LOG(LogTemp, Error, TEXT("Both file reading methods failed"));
-        return TEXT("");
+        FAIWorldEntity& Entity = Entities.AddDefaulted_GetRef();
+        Entity.Id = Actor->GetFName();
+        Entity.Kind = Component->Kind.IsEmpty() ? TEXT("object") : Component->Kind.ToLower();
+        Entity.Name = Component->GetEntityName();
+        Entity.State = Component->State.ToLower();
+        Entity.Distance = Offset.Size();
+        Entity.BearingDegrees = FRotator::NormalizeAxis(Offset.Rotation().Yaw - ObserverYaw);
     }
-    catch (...)
+
+    Session->WorldState.SetBudget(WorldSnapshotTokens, WorldDeltaTokens);
+    if (Session->WorldState.Update(Entities) > 0)
     {
-        UE_LOG(LogTemp, Error, TEXT("Exception during file reading"));
-        return TEXT("");
+        Session->SceneVersion++;
     }
 }
 
-void AAIManager::TestActionParser(const FString& TestInput)
+bool AAIManager::TryServeSpeculation(UAIConversationSession* Session, const FString& Message, FAIRequestTrace& Trace)
 {
-    if (!ActionParser)
+    if (Speculations.Num() == 0)
+    {
+        return false;
+    }
+
+    const FString Key = UAIIntentRouter::MakeMatchKey(Message);
+    int32 SpeculationId = INDEX_NONE;
+    for (const TPair<int32, FAISpeculation>& Pair : Speculations)
+    {
+        if (Pair.Value.Session.Get() == Session && Pair.Value.TurnVersion == Session->TurnVersion && Pair.Value.SceneVersion == Session->SceneVersion
+            && !Pair.Value.bAdopted && Pair.Value.Key == Key)
+        {
+            SpeculationId = Pair.Key;
+            break;
+        }
+    }
+    if (SpeculationId == INDEX_NONE)
+    {
+        return false;
+    }
+
+    // 실제 요청과 같은 순서로 기록 (예측 요청 본문도 이 입력 전 문맥으로 만들어짐)
+    LatencyTracker.BeginRequest(Trace);
+    Session->PendingRequestCount++;
+    GetWorldTimerManager().ClearTimer(Session->SummaryTimerHandle);
+    GetWorldTimerManager().ClearTimer(Session->SpeculationTimerHandle);
+    Session->AppendSessionRecord(EAISessionRecordType::UserMessage, Message);
+    Trace.Mark(EAITraceStage::RequestSent);
+    SpeculationHitCount++;
+
+    // 맞은 것만 남기고 나머지 예측은 취소
+    Speculations[SpeculationId].bAdopted = true;
+    CancelSpeculations(Session, [](const FString&) { return true; });
+    FAISpeculation& Speculation = Speculations[SpeculationId];
+
+    AIDM_EVENT(Log, "SpeculationHit", AIDM_FIELD("id", Trace.RequestId), AIDM_FIELD("session", Session->GetSessionId().ToString()),
+        AIDM_FIELD("ready", Speculation.bReady), AIDM_FIELD("text", Message));
+
+    if (Speculation.bReady)
+    {
+        const FString Content = MoveTemp(Speculation.Content);
+        Speculations.Remove(SpeculationId);
+
+        Trace.Mark(EAITraceStage::ResponseReceived);
+        CompleteSessionResponse(Session, Trace, true, Content);
+        return true;
+    }
+
+    // 아직 받는 중이면 넘겨받아 도착하면 전달 (이미 받은 조각은 먼저 표시)
+    Speculation.AdoptedTrace = Trace;
+    if (!Speculation.StreamedText.IsEmpty())
+    {
+        BroadcastChunk(Session, Speculation.StreamedText);
+    }
+    return true;
+}
+
+void AAIManager::CancelSpeculations(UAIConversationSession* Session, TFunctionRef<bool(const FString& Key)> ShouldCancel)
+{
+    // 취소 완료 콜백이 바로 와도 무시되도록 목록에서 먼저 제거한 뒤 취소
+    TArray<TSharedPtr<FAIChatCancellation>> Cancellations;
+    for (auto It = Speculations.CreateIterator(); It; ++It)
     {
-        UE_LOG(LogTemp, Error, TEXT("액션 파서가 초기화되지 않았습니다"));
-        if (GEngine)
+        const FAISpeculation& Speculation = It.Value();
+        if (Speculation.bAdopted || Speculation.Session.Get() != Session || !ShouldCancel(Speculation.Key))
+        {
+            continue;
+        }
+
+        if (Speculation.Cancellation)
         {
-            GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, TEXT("액션 파서 없음"));
+            Cancellations.Add(Speculation.Cancellation);
         }
+        ReleaseTokenRate(EAIRequestPriority::Speculative, Speculation.SessionId, Speculation.ReservedTokens, Speculation.PromptTokens);
+        It.RemoveCurrent();
+    }
+
+    for (const TSharedPtr<FAIChatCancellation>& Cancellation : Cancellations)
+    {
+        Cancellation->Cancel();
+    }
+}
+
+void AAIManager::TestActionParser(const FString& TestInput)
+{
+    if (!ActionParser)
+    {
+        UE_LOG(LogAIDM, Error, TEXT("액션 파서가 초기화되지 않았습니다"));
+        AIDM_SCREEN_MESSAGE(3.0f, FColor::Red, TEXT("액션 파서 없음"));
         return;
     }
     
-    UE_LOG(LogTemp, Log, TEXT("=== 액션 파서 테스트 시작 ==="));
-    UE_LOG(LogTemp, Log, TEXT("입력: %s"), *TestInput);
+    UE_LOG(LogAIDM, Log, TEXT("=== 액션 파서 테스트 시작 ==="));
+    UE_LOG(LogAIDM, Log, TEXT("입력: %s"), *TestInput);
     
-    if (GEngine)
-    {
-        GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow, 
-            FString::Printf(TEXT("테스트 입력: %s"), *TestInput));
-    }
+    AIDM_SCREEN_MESSAGE(5.0f, FColor::Yellow, FString::Printf(TEXT("테스트 입력: %s"), *TestInput));
     
     // AI 응답 파싱
     TArray<FParsedAction> ParsedActions = ActionParser->ParseAIResponse(TestInput);
     
-    UE_LOG(LogTemp, Log, TEXT("파싱된 액션 수: %d"), ParsedActions.Num());
+    UE_LOG(LogAIDM, Log, TEXT("파싱된 액션 수: %d"), ParsedActions.Num());
     
-    if (GEngine)
-    {
-        GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green,
-            FString::Printf(TEXT("파싱된 액션 수: %d"), ParsedActions.Num()));
-    }
+    AIDM_SCREEN_MESSAGE(5.0f, FColor::Green, FString::Printf(TEXT("파싱된 액션 수: %d"), ParsedActions.Num()));
     
     // 각 액션 정보 출력
     for (int32 i = 0; i < ParsedActions.Num(); i++)
@@ -389,26 +1668,22 @@ void AAIManager::TestActionParser(const FString& TestInput)
         
         FString ActionTypeStr = UEnum::GetValueAsString(Action.ActionType);
         
-        UE_LOG(LogTemp, Log, TEXT("액션 %d:"), i + 1);
-        UE_LOG(LogTemp, Log, TEXT("  타입: %s"), *ActionTypeStr);
-        UE_LOG(LogTemp, Log, TEXT("  명령어: %s"), *Action.Command);
-        UE_LOG(LogTemp, Log, TEXT("  대상: %s"), *Action.Target);
-        UE_LOG(LogTemp, Log, TEXT("  매개변수 수: %d"), Action.Parameters.Num());
+        UE_LOG(LogAIDM, Log, TEXT("액션 %d:"), i + 1);
+        UE_LOG(LogAIDM, Log, TEXT("  타입: %s"), *ActionTypeStr);
+        UE_LOG(LogAIDM, Log, TEXT("  명령어: %s"), *Action.Command);
+        UE_LOG(LogAIDM, Log, TEXT("  대상: %s"), *Action.Target);
+        UE_LOG(LogAIDM, Log, TEXT("  매개변수 수: %d"), Action.Parameters.Num());
         
-        if (GEngine)
-        {
-            GEngine->AddOnScreenDebugMessage(-1, 8.0f, FColor::Cyan,
-                FString::Printf(TEXT("액션 %d: %s - %s"), i + 1, *ActionTypeStr, *Action.Command));
-        }
+        AIDM_SCREEN_MESSAGE(8.0f, FColor::Cyan, FString::Printf(TEXT("액션 %d: %s - %s"), i + 1, *ActionTypeStr, *Action.Command));
         
         // 매개변수들 출력
         for (int32 j = 0; j < Action.Parameters.Num(); j++)
         {
-            UE_LOG(LogTemp, Log, TEXT("    매개변수 %d: %s"), j + 1, *Action.Parameters[j]);
+            UE_LOG(LogAIDM, Log, TEXT("    매개변수 %d: %s"), j + 1, *Action.Parameters[j]);
         }
     }
     
-    UE_LOG(LogTemp, Log, TEXT("=== 액션 파서 테스트 완료 ==="));
+    UE_LOG(LogAIDM, Log, TEXT("=== 액션 파서 테스트 완료 ==="));
 }
 
 void AAIManager::TestParser(const FString& Input)
@@ -4,13 +4,24 @@
 #include "GameFramework/Actor.h"
 #include "Engine/Engine.h"
 #include "AIActionParser.h"
+#include "AIConversationSession.h"
+#include "AIRequestTrace.h"
+#include "AIDMLog.h"
+#include "AIChatBackend.h"
+#include "AIDMConfig.h"
+#include "AIIntentRouter.h"
+#include "AIHedgedBackend.h"
+#include "AITokenizer.h"
+#include "AIResponseLength.h"
+#include "AITokenRate.h"
+#include "AISemanticCache.h"
 #include "AIManager.generated.h"
 
-class IHttpRequest;
-class IHttpResponse;
-
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnAIResponse, bool, bSuccess, const FString&, Response);
-
+/**
+ * 모든 플레이어 세션이 공유하는 AI 서비스 (백엔드, 액션 파서, 지연 추적, 동일 요청 합치기)
+ * 플레이어별 대화 상태는 UAIConversationSession에 있고, 응답은 요청한 세션으로만 전달된다.
+ * SendMessage/OnAIResponse 등 기존 API는 기본 세션을 사용한다.
+ */
 UCLASS()
 class AI_DUNGEON_MASTER_API AAIManager : public AActor
 {
@@ -21,19 +32,180 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
-    // AI에게 메시지 전송
+    // 액션 파서, 백엔드, API 키, 기본 세션 준비 (UAIDMSubsystem이 로딩 중에 호출, 여러 번 호출해도 됨)
+    void WarmUp();
+
+    // 기본 세션 이름
+    static const FName DefaultSessionId;
+
+    // 세션 찾기/생성 (플레이어 또는 파티마다 하나)
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    UAIConversationSession* GetOrCreateSession(FName SessionId);
+
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    UAIConversationSession* FindSession(FName SessionId) const;
+
+    // 세션 로그를 닫고 제거 (진행 중인 응답은 버려짐)
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    void RemoveSession(FName SessionId);
+
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    UAIConversationSession* GetDefaultSession() { return GetOrCreateSession(DefaultSessionId); }
+
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    int32 GetNumSessions() const { return Sessions.Num(); }
+
+    // 새 세션의 동시 요청 한도 (0 = 무제한)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    int32 MaxPendingRequestsPerSession = 0;
+
+    // 새 세션이 쓸 수 있는 토큰 (프롬프트 + 응답, 0 = 무제한)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    int32 SessionTokenBudget = 0;
+
+    // 제공자 분당 토큰 한도에 맞춘 전송 속도 (예상 프롬프트 + max_tokens 기준, 0 = 제한 없음)
+    // 한도에 걸린 플레이어 턴은 MaxRateLimitWaitSeconds까지 기다렸다 보내고, 요약/예측 요청은 건너뜀
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|RateLimit", meta = (ClampMin = "0"))
+    int32 GlobalTokensPerMinute = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|RateLimit", meta = (ClampMin = "0"))
+    int32 SessionTokensPerMinute = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|RateLimit", meta = (ClampMin = "0"))
+    int32 BackgroundTokensPerMinute = 0;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|RateLimit", meta = (ClampMin = "0"))
+    int32 SpeculativeTokensPerMinute = 0;
+
+    // 요약/예측 요청이 전역, 세션 한도에서 플레이어 턴 몫으로 남겨 둘 비율
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|RateLimit", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float ForegroundReserveRatio = 0.25f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|RateLimit", meta = (ClampMin = "0.0"))
+    float MaxRateLimitWaitSeconds = 20.0f;
+
+    UFUNCTION(BlueprintPure, Category = "AI|RateLimit")
+    FAITokenRateStats GetTokenRateStats() const { return TokenRate.GetStats(); }
+
+    // AI에게 메시지 전송 (기본 세션)
     UFUNCTION(BlueprintCallable, Category = "AI")
     void SendMessage(const FString& Message);
 
-    // AI 응답 델리게이트
+    // 채팅 입력 시점부터 시작된 지연 시간 추적과 함께 전송 (기본 세션)
+    void SendTracedMessage(const FString& Message, FAIRequestTrace Trace);
+
+    // 세션의 메시지를 백엔드로 전송 (UAIConversationSession::SendMessage에서 호출)
+    void SendSessionMessage(UAIConversationSession* Session, const FString& Message, FAIRequestTrace Trace);
+
+    // AI 응답 델리게이트 (기본 세션)
     UPROPERTY(BlueprintAssignable, Category = "AI")
     FOnAIResponse OnAIResponse;
 
-    // API 키 가져오기 (테스트 목적)
+    // 스트리밍 응답 조각 델리게이트 (기본 세션, bStreamResponses일 때만)
+    UPROPERTY(BlueprintAssignable, Category = "AI")
+    FOnAIResponseChunk OnAIResponseChunk;
+
+    // 응답을 SSE로 스트리밍 받기
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend")
+    bool bStreamResponses = false;
+
+    // 모든 요청/응답을 기록할 파일 (명령줄 -aidmrecord=<경로>로도 지정)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend")
+    FString RecordSessionPath;
+
+    // 실제 API 대신 재생할 기록 파일 (명령줄 -aidmreplay=<경로>)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend")
+    FString ReplaySessionPath;
+
+    // 재생 속도 (1 = 원래 속도, 0 이하 = 지연 없음, 명령줄 -aidmreplayspeed=<배수>)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend")
+    float ReplayTimeScale = 1.0f;
+
+    // 네트워크 대신 CPU에서 실행할 GGUF 모델 (명령줄 -aidmlocal=<경로>, llama.cpp와 함께 빌드해야 함)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend")
+    FString LocalModelPath;
+
+    // 로컬 모델 생성 스레드 수 상한 (0 = 물리 코어 - 2, 명령줄 -aidmlocalthreads=<수>)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend", meta = (ClampMin = "0", ClampMax = "32"))
+    int32 LocalThreadCount = 0;
+
+    // 로컬 모델 KV 캐시 크기 (토큰)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend", meta = (ClampMin = "512", ClampMax = "32768"))
+    int32 LocalContextSize = 4096;
+
+    // 로딩 중에 LLM 엔드포인트 연결을 미리 맺음 (DNS/TCP/TLS를 첫 요청에서 빼기)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend")
+    bool bPrewarmConnection = true;
+
+    // 플레이어 턴 사이 유휴 중 연결 유지 간격 (초, 0 = 유지 안 함)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Backend")
+    float KeepAliveInterval = 25.0f;
+
+    // 직전 통신 후 가정한 서버 유휴 시간(50초) 안에 보낸 요청 비율 (시간 기준, 실제 재사용을 관찰한 값은 아님)
+    UFUNCTION(BlueprintPure, Category = "AI|Latency")
+    float GetConnectionIdleWindowRate() const { return Backend ? Backend->GetConnectionStats().GetIdleWindowRate() : 0.0f; }
+
+    // 관찰한 연결 수립 비용 (새 연결 HEAD와 유지 HEAD의 왕복 시간 차이, ms)
+    UFUNCTION(BlueprintPure, Category = "AI|Latency")
+    float GetObservedHandshakeMs() const { return Backend ? Backend->GetConnectionStats().GetObservedHandshakeMs() : 0.0f; }
+
+    FAIConnectionStats GetConnectionStats() const { return Backend ? Backend->GetConnectionStats() : FAIConnectionStats(); }
+
+    // 응답 시작이 늦으면 같은 요청을 보조 엔드포인트(설정 HedgeEndpoint/HedgeModel)에도 보내 먼저 오는 쪽 사용
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Hedging")
+    bool bEnableHedging = false;
+
+    // 최근 응답 시작 지연의 이 백분위를 넘으면 헤지
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Hedging")
+    float HedgePercentile = 95.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Hedging")
+    float MinHedgeDelayMs = 500.0f;
+
+    // 지연 샘플이 부족할 때도 이 시간에 헤지
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Hedging")
+    float MaxHedgeDelayMs = 4000.0f;
+
+    // 이 시간(ms)까지 응답이 끝나지 않으면 받은 부분 응답이나 대체 문구로 완료 (0 = 없음, 헤지 사용 시에만)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Hedging")
+    float ResponseDeadlineMs = 15000.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Hedging")
+    FString DeadlineFallbackResponse = TEXT("The dungeon master pauses, lost in thought. Try that again in a moment.");
+
+    // 보조 요청을 보낸 비율
+    UFUNCTION(BlueprintPure, Category = "AI|Hedging")
+    float GetHedgeRate() const { return HedgedBackend ? HedgedBackend->GetStats().GetHedgeRate() : 0.0f; }
+
+    FAIHedgeStats GetHedgeStats() const { return HedgedBackend ? HedgedBackend->GetStats() : FAIHedgeStats(); }
+
+    // 경로별 요청 수, 지연, 토큰, 추정 비용 (모델은 설정의 Routes)
+    UFUNCTION(BlueprintPure, Category = "AI|Routing")
+    FAIRouteStats GetRouteStats(EAIModelRoute Route) const { return RouteTracker.GetStats(Route); }
+
+    // 기본 세션에 Message를 보낼 때의 예상 토큰, 비용, 지연 (직전 요청 프롬프트 + 새 입력 기준)
+    UFUNCTION(BlueprintCallable, Category = "AI|Routing")
+    FAIRequestEstimate EstimateRequest(const FString& Message);
+
+    // 토크나이저 기준 토큰 수 (순위 파일이 없으면 글자 수로 추정)
+    int32 CountTokens(const FString& Text) const;
+
+    // 채팅 완성 백엔드 교체 (테스트, 부하 생성용)
+    void SetBackend(TSharedPtr<IAIChatBackend> InBackend) { Backend = InBackend; HedgedBackend.Reset(); }
+
+    // API 키 가져오기 (테스트 목적, 설정이 아직 로드되지 않았으면 빈 문자열)
     UFUNCTION(BlueprintCallable, Category = "OpenAI")
-    FString GetAPIKey();
+    FString GetAPIKey() const { return Config.IsValid() ? Config->APIKey : FString(); }
+
+    // 설정 파일 다시 로드 (파일 변경은 자동으로 감지됨)
+    UFUNCTION(BlueprintCallable, Category = "AI|Config")
+    void ReloadConfig();
+
+    UFUNCTION(BlueprintPure, Category = "AI|Config")
+    bool IsConfigLoaded() const { return Config.IsValid(); }
     
     // 액션 파서 테스트 함수
     UFUNCTION(BlueprintCallable, Category = "AI Action Parser")
@@ -43,28 +215,439 @@ public:
     UFUNCTION(Exec)
     void TestParser(const FString& Input);
 
+    // 기본 세션 로그에서 복원된 레코드 (채팅 화면 복원용)
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    TArray<FAISessionRecord> GetRestoredRecords() { return GetDefaultSession()->GetRestoredRecords(); }
+
+    // 지난 세션 포함 기본 세션 대화 기록 검색
+    UFUNCTION(BlueprintCallable, Category = "AI|Session")
+    TArray<FAISearchHit> SearchHistory(const FString& Query, int32 MaxResults = 10) { return GetDefaultSession()->SearchHistory(Query, MaxResults); }
+
+    // 기본 세션 대화 기록 검색 인덱스
+    UFUNCTION(BlueprintPure, Category = "AI|Session")
+    UAISearchIndex* GetSearchIndex() { return GetDefaultSession()->GetSearchIndex(); }
+
+    // 세션 로그/요약 캐시를 디스크에서 읽고 쓸지 (부하 테스트의 모의 세션은 끔)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    bool bPersistSession = true;
+
+    // 시작 2초 후 액션 파서 자동 테스트 실행 (디버그용)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    bool bRunStartupSelfTest = true;
+
+    // 시작 시 세션 로그에서 복원할 턴 수
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    int32 RestoreTurnCount = 20;
+
+    // 요청에 포함할 최근 대화 턴 수
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    int32 MaxContextTurns = 6;
+
+    // 최근 대화 창이 한 번에 이동하는 턴 수 (프롬프트 앞부분 캐시 유지용)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    int32 ContextWindowStep = 4;
+
+    // 최근 대화 창의 토큰 한도 (0 = 턴 수로만 제한, 넘으면 절반까지 줄임)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    int32 MaxContextTokens = 0;
+
+    // BPE 순위 파일 (tiktoken 형식, 프로젝트 폴더 기준, 없으면 글자 수로 추정)
+    // 패키지에 포함하려면 Additional Non-Asset Directories to Package에 추가
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Session")
+    FString TokenizerPath = TEXT("Content/AI/cl100k_base.tiktoken");
+
+    // 고정 규칙 (프롬프트 맨 앞, 내용을 바꾸면 버전도 올릴 것)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Prompt")
+    FString StaticRulesPrompt = TEXT("You are a dungeon master for a text adventure game. Keep responses concise and engaging (under 50 words).");
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Prompt")
+    int32 StaticRulesVersion = 1;
+
+    // 기본 세션 프롬프트 캐시 지표 (공유 앞부분 길이)
+    UFUNCTION(BlueprintPure, Category = "AI|Prompt")
+    FAIPromptCacheStats GetPromptCacheStats() { return GetDefaultSession()->GetPromptCacheStats(); }
+
+    // 세션의 관찰자(SetWorldObserver) 주변 상태를 프롬프트에 포함
+    // 대상은 UAIWorldEntityComponent를 붙인 액터 (종류, 이름, 상태는 컴포넌트에서)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|World")
+    bool bIncludeWorldState = true;
+
+    // 관찰자로부터 이 거리(cm) 안의 대상만
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|World", meta = (ClampMin = "0.0"))
+    float WorldStateRadius = 2000.0f;
+
+    // 전체 스냅샷 토큰 예산 (넘는 대상은 먼 것부터 빠짐)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|World", meta = (ClampMin = "0"))
+    int32 WorldSnapshotTokens = 150;
+
+    // 스냅샷 이후 변경분 토큰 예산 (넘으면 스냅샷을 다시 만듦)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|World", meta = (ClampMin = "0"))
+    int32 WorldDeltaTokens = 60;
+
+    // 요청에 넣을 관련 기억 수 (최근 턴 제외)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Memory")
+    int32 RecallTopK = 3;
+
+    // 기억으로 인정할 최소 유사도
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Memory")
+    float RecallMinScore = 0.25f;
+
+    // 요청 대기열이 이 시간(초) 동안 비어 있으면 오래된 턴 요약 시작
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Summary")
+    float SummaryIdleDelay = 3.0f;
+
+    // 기본 세션의 현재 캠페인 요약
+    UFUNCTION(BlueprintPure, Category = "AI|Summary")
+    UAIConversationSummarizer* GetSummarizer() { return GetDefaultSession()->GetSummarizer(); }
+
+    // 전체 응답 지연 목표 (p95, ms, 0이면 사용 안 함)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Latency")
+    float LatencySLOMs = 4000.0f;
+
+    // 최근 요청의 전체 지연 백분위 (ms)
+    UFUNCTION(BlueprintPure, Category = "AI|Latency")
+    float GetLatencyPercentile(float Percentile) const { return LatencyTracker.GetPercentile(EAILatencySpan::Total, Percentile); }
+
+    // 요청마다 의도와 최근 생성 속도로 max_tokens를 정함 (끄면 설정의 MaxTokens 고정)
+    // 설정의 MaxTokens가 기본 길이, LatencySLOMs 안에 생성이 끝나는 길이가 상한
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Length")
+    bool bAdaptiveMaxTokens = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Length", meta = (ClampMin = "1"))
+    int32 MinResponseTokens = 32;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Length", meta = (ClampMin = "1"))
+    int32 MaxResponseTokens = 400;
+
+    // max_tokens에서 잘린 응답은 마지막 완성된 문장까지만 전달
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Length")
+    bool bTrimTruncatedResponses = true;
+
+    // 잘린 응답 비율, 평균 사용률, 생성 속도
+    UFUNCTION(BlueprintPure, Category = "AI|Length")
+    FAIResponseLengthStats GetResponseLengthStats() const { return ResponseLength.GetStats(); }
+
+    // p95 지연이 SLO를 넘기 시작한 횟수 (초과가 이어지는 동안은 한 번)
+    UFUNCTION(BlueprintPure, Category = "AI|Latency")
+    int32 GetLatencySLOBreachCount() const { return LatencyTracker.GetSLOBreachCount(); }
+
+    // p95 지연이 SLO를 넘은 상태로 있던 총 시간 (초)
+    UFUNCTION(BlueprintPure, Category = "AI|Latency")
+    float GetLatencySLOBreachSeconds() const { return static_cast<float>(LatencyTracker.GetSLOBreachSeconds()); }
+
+    // 짧고 결정적인 명령(인벤토리, 대기, 둘러보기)은 모델 없이 로컬 템플릿으로 응답
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Intent")
+    bool bEnableLocalIntents = true;
+
+    UFUNCTION(BlueprintPure, Category = "AI|Intent")
+    UAIIntentRouter* GetIntentRouter() const { return IntentRouter; }
+
+    // 로컬에서 처리해 모델 호출을 아낀 수
+    UFUNCTION(BlueprintPure, Category = "AI|Intent")
+    int32 GetLocalIntentCount() const { return LocalIntentCount; }
+
+    // 진행 중인 같은 요청에 합쳐져 백엔드 호출을 아낀 수
+    UFUNCTION(BlueprintPure, Category = "AI|Latency")
+    int32 GetCoalescedRequestCount() const { return CoalescedRequestCount; }
+
+    // 같은 장면에서 비슷한 입력("look around the room" / "i look around")에 이전 모델 응답을 재사용
+    // SemanticCacheIntents에 든 의도만 저장/재사용하고, 다른 의도의 턴이 끝나거나 SetSceneState로 장면이 바뀌면 무효
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Cache")
+    bool bEnableSemanticCache = false;
+
+    // 장면을 바꾸지 않는 의도 (응답을 재사용해도 되는 입력)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Cache")
+    TArray<EActionType> SemanticCacheIntents = { EActionType::Look, EActionType::Inventory };
+
+    // 정규화된 입력 임베딩의 코사인 유사도
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Cache", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float SemanticCacheMinScore = 0.8f;
+
+    // 재사용 응답을 감싸는 템플릿 ({response}, 돌아가며 사용, 비어 있으면 그대로)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Cache")
+    TArray<FString> SemanticCacheTemplates;
+
+    // 적중 중 이 비율만 백그라운드로 모델에도 보내 응답을 비교 (잘못된 적중 측정, 토큰 비용 증가)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Cache", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float SemanticCacheVerifyRate = 0.1f;
+
+    // 비교한 모델 응답과 이보다 덜 비슷하면 잘못된 적중 (항목 제거)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Cache", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float SemanticCacheVerifyMinScore = 0.3f;
+
+    UFUNCTION(BlueprintPure, Category = "AI|Cache")
+    FAISemanticCacheStats GetSemanticCacheStats() const { return SemanticCache.GetStats(); }
+
+    // 응답 후 유휴 시간에 가능성 높은 다음 입력의 응답을 미리 요청 (적중하면 바로 표시, 토큰 비용 증가)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Speculation")
+    bool bEnableSpeculativePrefetch = false;
+
+    // 응답마다 미리 요청할 예측 입력 수
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Speculation")
+    int32 SpeculationTopK = 2;
+
+    // 응답 후 플레이어가 이 시간(초) 동안 입력하지 않으면 예측 요청 시작
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Speculation")
+    float SpeculationIdleDelay = 1.5f;
+
+    // 동시에 진행할 수 있는 예측 요청 수 (모든 세션 합계)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Speculation")
+    int32 MaxSpeculativeInFlight = 4;
+
+    // 한 시간 동안 보낼 수 있는 예측 요청 수 (0 = 무제한)
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI|Speculation")
+    int32 MaxSpeculativeRequestsPerHour = 120;
+
+    UFUNCTION(BlueprintPure, Category = "AI|Speculation")
+    int32 GetSpeculationIssuedCount() const { return SpeculationIssuedCount; }
+
+    // 미리 받은 (또는 받는 중인) 응답으로 처리한 플레이어 입력 수
+    UFUNCTION(BlueprintPure, Category = "AI|Speculation")
+    int32 GetSpeculationHitCount() const { return SpeculationHitCount; }
+
 private:
-    // HTTP 응답 처리
-    void OnHttpResponse(TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request,
-        TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> Response,
-        bool bSuccess);
+    // 벤치마크 커맨드렛은 BeginPlay 없이 요청 본문 생성을 직접 측정
+    friend class UAIDMBenchmarkCommandlet;
+    friend class UAIConversationSession;
+    friend class UAIDMSubsystem;
+
+    // 세션과 파서의 Outer (레벨 전환에도 남도록 게임 인스턴스 서브시스템, 없으면 매니저)
+    UObject* GetPersistentOuter();
+
+    // 백엔드 요청 하나를 기다리는 세션 요청 (같은 본문이면 여러 세션이 한 요청을 공유)
+    struct FAIPendingDelivery
+    {
+        TWeakObjectPtr<UAIConversationSession> Session;
+        FAIRequestTrace Trace;
+    };
+
+    struct FAIInFlightRequest
+    {
+        FString Body;
+        int32 PromptTokens = 0;
+        FAILengthDecision Length;
+        FName SessionId;                // 속도 한도를 청구한 세션 (처음 보낸 세션)
+        int32 ReservedTokens = 0;
+        TArray<FAIPendingDelivery> Deliveries;
+    };
+
+    // 미리 요청한 다음 입력 응답 (세션 대화 턴이 TurnVersion일 때만 유효)
+    struct FAISpeculation
+    {
+        TWeakObjectPtr<UAIConversationSession> Session;
+        FString Key;
+        int32 TurnVersion = 0;
+        int32 SceneVersion = 0;         // 본문을 만들 때의 장면 버전 (주변 상태가 바뀌면 쓰지 않음)
+        TSharedPtr<FAIChatCancellation> Cancellation;
+        bool bReady = false;
+        FString Content;
+        FString StreamedText;
+        int32 PromptTokens = 0;         // 응답에 usage가 없을 때 쓸 토크나이저 계산값
+        FAILengthDecision Length;
+        FName SessionId;                // 속도 한도를 청구한 세션
+        int32 ReservedTokens = 0;
+
+        // 응답 전에 플레이어 입력과 맞으면 실제 요청으로 넘겨받음 (취소 안 됨)
+        bool bAdopted = false;
+        FAIRequestTrace AdoptedTrace;
+    };
+
+    // 백엔드 응답 처리
+    void OnBackendResponse(const FAIChatResult& Result, int32 RequestId);
+
+    // 스트리밍 응답 조각 전달
+    void OnBackendChunk(const FString& Chunk, int32 RequestId);
+
+    // 세션과 기본 세션 호환 델리게이트로 응답 조각 브로드캐스트
+    void BroadcastChunk(UAIConversationSession* Session, const FString& Chunk);
+
+    // 경로 지표 기록, 세션 예산에 청구할 토큰 반환 (응답의 usage 우선)
+    int32 RecordRouteUsage(EAIModelRoute Route, bool bSuccess, float LatencyMs, const FAITokenUsage& Usage, int32 PromptTokens, const FString& Content);
+
+    // 백엔드 결과에서 응답 텍스트 읽기 (실패면 오류 메시지를 OutContent에 넣고 false)
+    static bool ReadChatResult(const FAIChatResult& Result, FString& OutContent, bool bReportErrors, FAITokenUsage* OutUsage = nullptr, FString* OutFinishReason = nullptr);
+
+    // 백엔드 응답 텍스트를 파싱해 세션 하나에 전달 (예측 응답용)
+    void CompleteSessionResponse(UAIConversationSession* Session, FAIRequestTrace& Trace, bool bSuccess, const FString& Content);
+
+    // 응답(또는 실패)을 요청한 세션 하나에 전달
+    void DeliverResponse(UAIConversationSession* Session, FAIRequestTrace& Trace, bool bSuccess, const FString& Content,
+        const TArray<FParsedAction>& ParsedActions, float ParseMs, float ResponseMs);
+
+    // 로컬 의도면 바로 응답하고 true (모델 요청 없음)
+    bool TryHandleLocalIntent(UAIConversationSession* Session, const FString& Message, FAIRequestTrace& Trace);
+
+    // 세션과 기본 세션 호환 델리게이트로 브로드캐스트
+    void BroadcastResponse(UAIConversationSession* Session, bool bSuccess, const FString& Response);
+
+    // 설정과 명령줄에 따라 백엔드 생성 (OpenAI, 기록, 재생)
+    void CreateBackend();
+
+    // 세션의 대화로 JSON 요청 본문 생성
+    // bPreview: 예측/검증 요청용 (최근 대화 창을 옮기지 않고 프롬프트 캐시 지표에도 넣지 않음, 프롬프트 토큰은 OutPromptTokens로)
+    FString CreateRequestBody(UAIConversationSession* Session, const FString& Message, FAILengthDecision* OutLength = nullptr,
+        bool bPreview = false, int32* OutPromptTokens = nullptr);
+
+    // 응답 길이 기록, 잘린 응답 다듬기
+    void RecordResponseLength(const FAILengthDecision& Length, const FAIChatResult& Result, const FString& FinishReason, const FAITokenUsage& Usage, FString& InOutContent);
+
+    // 응답 JSON에서 첫 번째 선택지의 content 추출 (OutUsage가 있으면 usage도)
+    static bool ExtractCompletionContent(const FString& ResponseString, FString& OutContent, FAITokenUsage* OutUsage = nullptr, FString* OutFinishReason = nullptr);
+
+    // 설정 로더 연결 (서브시스템의 로더, 없으면 직접 생성)
+    void BindConfigLoader();
+
+    // 새 설정 스냅샷 적용 후 대기 중인 메시지 전송
+    void OnConfigLoaded(const TSharedRef<const FAIDMConfig>& NewConfig);
+
+    // 현재 설정의 키와 엔드포인트를 백엔드에 반영
+    void ApplyConfigToBackend();
 
-    // JSON 요청 본문 생성
-    FString CreateRequestBody(const FString& Message);
+    // 헤지 속성으로 백엔드 설정 생성
+    FAIHedgeSettings MakeHedgeSettings() const;
 
-    // 안전한 파일 읽기 (단계별)
-    FString LoadAPIKeyFromFile();
-    bool IsEngineReady();
-    bool DoesFileExistSafely(const FString& FilePath);
-    FString ReadFileContentSafely(const FString& FilePath);
+    // 현재 설정 (로드 전이면 기본값)
+    const FAIDMConfig& GetConfig() const;
 
-    // 캐시된 API 키
-    FString APIKey;
+    // 설정이 로드되기 전에 들어온 메시지 (로드되면 전송)
+    struct FAIDeferredMessage
+    {
+        TWeakObjectPtr<UAIConversationSession> Session;
+        FString Message;
+        FAIRequestTrace Trace;
+        double QueuedTime = 0.0;
+        int32 EstimatedTokens = 0;
+    };
 
-    // API 키 로드 상태
-    bool bAPIKeyLoaded = false;
+    TSharedPtr<FAIDMConfigLoader> ConfigLoader;
+    TSharedPtr<const FAIDMConfig> Config;
+    FDelegateHandle ConfigLoadedHandle;
+    TArray<FAIDeferredMessage> DeferredMessages;
+
+    // 토큰 속도 한도로 기다리는 플레이어 턴 (세션 순서 유지)
+    TArray<FAIDeferredMessage> RateLimitedMessages;
+    FTimerHandle RateLimitTimerHandle;
+    const FAIDeferredMessage* FlushingMessage = nullptr;   // 다시 보내는 중인 턴 (한도에 또 걸리면 같은 자리로)
+    int32 RateLimitFlushIndex = 0;
+
+    void QueueRateLimitedMessage(UAIConversationSession* Session, const FString& Message, const FAIRequestTrace& Trace, int32 EstimatedTokens);
+    void FlushRateLimitedMessages();
+
+    // 응답 후 속도 한도 정산 (429면 전역 버킷을 비움)
+    void SettleTokenRate(EAIRequestPriority Priority, FName SessionId, int32 ReservedTokens, int32 UsedTokens, int32 ResponseCode);
+
+    // 응답을 받지 않을 요청의 예약 해제 (보낸 프롬프트만 쓴 것으로 봄)
+    void ReleaseTokenRate(EAIRequestPriority Priority, FName SessionId, int32 ReservedTokens, int32 PromptTokens);
+
+    // 응답을 기다리는 요약/검증 요청의 예약 (매니저가 끝날 때 아직 남아 있으면 해제)
+    struct FAIBackgroundReservation
+    {
+        FName SessionId;
+        int32 PromptTokens = 0;
+        int32 ReservedTokens = 0;
+    };
+    int32 AddBackgroundReservation(FName SessionId, int32 PromptTokens, int32 ReservedTokens);
+    void SettleBackgroundReservation(int32 ReservationId, int32 UsedTokens, int32 ResponseCode);
+
+    TMap<int32, FAIBackgroundReservation> BackgroundReservations;
+    int32 LastBackgroundReservationId = 0;
     
-    // 액션 파서 레퍼런스
+    // 액션 파서 레퍼런스 (모든 세션 공유)
     UPROPERTY()
     class UAIActionParser* ActionParser;
-};
\ No newline at end of file
+
+    // 입력 의도 라우터 (로컬 처리 여부 판단)
+    UPROPERTY()
+    UAIIntentRouter* IntentRouter;
+
+    int32 LocalIntentCount = 0;
+
+    // 세션 이름별 대화 상태
+    UPROPERTY()
+    TMap<FName, UAIConversationSession*> Sessions;
+
+    // 유휴 시간 후 세션 요약 시도 예약
+    void ScheduleSummaryFold(UAIConversationSession* Session);
+
+    // 세션의 대기열이 비어 있을 때만 요약 요청 전송
+    void TryStartSummaryFold(TWeakObjectPtr<UAIConversationSession> WeakSession);
+
+    // 요약 요청 응답 처리
+    void OnSummaryResponse(const FAIChatResult& Result, TWeakObjectPtr<UAIConversationSession> WeakSession, int32 PromptTokens, int32 ReservationId);
+
+    // 백엔드 API 키 확인 (필요 없는 백엔드면 true)
+    bool PrepareBackendAPIKey();
+
+    // 유휴 시간 후 다음 입력 예측 요청 예약
+    void ScheduleSpeculation(UAIConversationSession* Session);
+
+    // 세션의 대기열이 비어 있고 예산이 남아 있을 때만 예측 요청 전송
+    void TrySpeculate(TWeakObjectPtr<UAIConversationSession> WeakSession);
+
+    void OnSpeculationChunk(const FString& Chunk, int32 SpeculationId);
+    void OnSpeculationResponse(const FAIChatResult& Result, int32 SpeculationId);
+
+    // 플레이어 입력과 맞는 예측 응답이 있으면 그것으로 처리하고 true
+    bool TryServeSpeculation(UAIConversationSession* Session, const FString& Message, FAIRequestTrace& Trace);
+
+    // 세션의 예측 요청 중 조건에 맞는 것 취소 (넘겨받은 요청은 제외)
+    void CancelSpeculations(UAIConversationSession* Session, TFunctionRef<bool(const FString& Key)> ShouldCancel);
+
+    // 의미 캐시에 같은 장면의 비슷한 입력이 있으면 그 응답으로 처리하고 true
+    bool TryServeSemanticCache(UAIConversationSession* Session, const FString& Message, FAIRequestTrace& Trace);
+
+    // 끝난 턴 반영 (장면을 바꾸는 턴이면 장면 버전 증가, 아니면 bStore일 때 저장)
+    void UpdateSemanticCache(UAIConversationSession* Session, const FString& Input, const FString& Content, const TArray<FParsedAction>& ParsedActions, bool bStore);
+
+    // 적중한 입력을 모델에도 보내 재사용한 응답과 비교 (요약과 같은 백그라운드 우선순위)
+    void StartSemanticCacheVerification(UAIConversationSession* Session, const FString& Message, int32 EntryId);
+    void OnSemanticCacheVerified(const FAIChatResult& Result, FName SessionId, int32 EntryId, int32 PromptTokens, int32 ReservationId);
+
+    bool IsSemanticCacheIntent(const FString& Input) const;
+
+    // 세션 관찰자 주변의 등록된 대상으로 월드 상태 갱신 (바뀌면 장면 버전 증가)
+    void UpdateWorldState(UAIConversationSession* Session);
+
+    FAISemanticCache SemanticCache;
+    bool bServingSemanticCache = false;
+    int32 SemanticTemplateCounter = 0;
+
+    // 예측 요청 번호별 상태
+    TMap<int32, FAISpeculation> Speculations;
+    int32 LastSpeculationId = 0;
+
+    // 최근 한 시간 동안 보낸 예측 요청 시각
+    TArray<double> SpeculationSendTimes;
+
+    int32 SpeculationIssuedCount = 0;
+    int32 SpeculationHitCount = 0;
+
+    // 채팅 완성 백엔드
+    TSharedPtr<IAIChatBackend> Backend;
+
+    // Backend 안의 헤지 백엔드 (bEnableHedging일 때만)
+    TSharedPtr<FAIHedgedBackend> HedgedBackend;
+
+    // 진행 중인 백엔드 요청 (첫 요청 번호별)
+    TMap<int32, FAIInFlightRequest> InFlightRequests;
+
+    // 요청 본문 해시 -> 진행 중인 요청 번호 (같은 요청 합치기)
+    TMultiMap<uint32, int32> InFlightByBodyHash;
+
+    // 단계별 지연 시간 백분위
+    FAILatencyTracker LatencyTracker;
+
+    // 경로별 지표 (로컬, 서술, 요약)
+    FAIRouteTracker RouteTracker;
+
+    // 서술 요청의 max_tokens 조절
+    FAIResponseLengthController ResponseLength;
+
+    // 분당 토큰 한도 (전역, 세션별, 우선순위별)
+    FAITokenRateGovernor TokenRate;
+
+    // 로드 후 읽기 전용 (세션 프롬프트 조립기와 공유)
+    TSharedPtr<const FAITokenizer> Tokenizer;
+
+    int32 CoalescedRequestCount = 0;
+};
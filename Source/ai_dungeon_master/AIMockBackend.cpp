@@ -0,0 +1,216 @@
+#include "AIMockBackend.h"
+#include "Containers/Ticker.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+namespace AIMockBackendPrivate
+{
+    static const TCHAR* Responses[] =
+    {
+        TEXT("The corridor narrows and the air grows cold. Something shuffles in the dark ahead.\n[look around]"),
+        TEXT("The orc roars and swings its axe, missing you by inches!\n*attack the orc*"),
+        TEXT("You find a small brass key beneath the rotten floorboards.\nAction: pick up the key"),
+        TEXT("The merchant eyes your purse. \"Only the finest wares for a hero like you.\""),
+        TEXT("A hidden door creaks open, revealing a spiral staircase leading down.\nYou move to the staircase."),
+        TEXT("The spell fizzles as the runes on the wall absorb its energy.")
+    };
+
+    // OpenAI 채팅 완성 응답 형식
+    static FString MakeCompletionBody(const FString& Content)
+    {
+        FString Body;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Body);
+        Writer->WriteObjectStart();
+        Writer->WriteArrayStart(TEXT("choices"));
+        Writer->WriteObjectStart();
+        Writer->WriteObjectStart(TEXT("message"));
+        Writer->WriteValue(TEXT("role"), TEXT("assistant"));
+        Writer->WriteValue(TEXT("content"), Content);
+        Writer->WriteObjectEnd();
+        Writer->WriteValue(TEXT("finish_reason"), TEXT("stop"));
+        Writer->WriteObjectEnd();
+        Writer->WriteArrayEnd();
+        Writer->WriteObjectEnd();
+        Writer->Close();
+        return Body;
+    }
+
+    // 조각 i의 도착 시각: 전체 지연을 NumChunks + 1 구간으로 나눈 경계
+    static float ChunkOffsetMs(float LatencyMs, int32 Index, int32 NumChunks)
+    {
+        return LatencyMs * (Index + 1) / (NumChunks + 1);
+    }
+}
+
+using AIMockBackendPrivate::ChunkOffsetMs;
+
+FAIMockBackend::FAIMockBackend(const FAIMockBackendSettings& InSettings)
+    : Settings(InSettings)
+    , Random(InSettings.Seed)
+{
+    for (const TCHAR* Response : AIMockBackendPrivate::Responses)
+    {
+        CannedResponses.Add(Response);
+    }
+}
+
+void FAIMockBackend::SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete)
+{
+    FPendingRequest Pending;
+    Pending.Request = Request;
+    Pending.OnChunk = OnChunk;
+    Pending.OnComplete = OnComplete;
+    Pending.SubmitCycles = FPlatformTime::Cycles64();
+
+    if (Settings.MaxConcurrent > 0 && InFlightCount >= Settings.MaxConcurrent)
+    {
+        Queue.Add(MoveTemp(Pending));
+        return;
+    }
+
+    StartRequest(MoveTemp(Pending));
+}
+
+void FAIMockBackend::StartQueuedRequests()
+{
+    while (Queue.Num() > 0 && (Settings.MaxConcurrent <= 0 || InFlightCount < Settings.MaxConcurrent))
+    {
+        FPendingRequest Pending = MoveTemp(Queue[0]);
+        Queue.RemoveAt(0, 1, EAllowShrinking::No);
+
+        // 대기 중에 취소된 요청은 처리하지 않음
+        if (Pending.Request.Cancellation && Pending.Request.Cancellation->bCancelled)
+        {
+            CancelledCount++;
+            continue;
+        }
+        StartRequest(MoveTemp(Pending));
+    }
+}
+
+void FAIMockBackend::StartRequest(FPendingRequest&& Pending)
+{
+    InFlightCount++;
+    QueueDelays.Add(static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Pending.SubmitCycles)));
+
+    const float LatencyMs = SampleLatencyMs();
+    TWeakPtr<FAIMockBackend> WeakThis = AsShared();
+
+    const bool bError = Settings.ErrorRate > 0.0f && Random.FRand() < Settings.ErrorRate;
+    Pending.ResponseIndex = bError ? INDEX_NONE : Random.RandHelper(CannedResponses.Num());
+
+    // 스트리밍이면 응답을 조각으로 나눠 지연 시간 안에 고르게 전달
+    if (Pending.Request.bStream && Pending.ResponseIndex != INDEX_NONE && Pending.OnChunk.IsBound())
+    {
+        const FString& Content = CannedResponses[Pending.ResponseIndex];
+        const int32 NumChunks = FMath::Min(Settings.StreamChunks, Content.Len());
+        for (int32 i = 0; i < NumChunks; i++)
+        {
+            const int32 Start = Content.Len() * i / NumChunks;
+            const int32 End = Content.Len() * (i + 1) / NumChunks;
+            const FString ChunkText = Content.Mid(Start, End - Start);
+
+            FOnAIChatChunk OnChunk = Pending.OnChunk;
+            TSharedPtr<FAIChatCancellation> Cancellation = Pending.Request.Cancellation;
+            FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnChunk, ChunkText, Cancellation](float)
+            {
+                if (!Cancellation || !Cancellation->bCancelled)
+                {
+                    OnChunk.ExecuteIfBound(ChunkText);
+                }
+                return false;
+            }), ChunkOffsetMs(LatencyMs, i, NumChunks) / 1000.0f);
+        }
+    }
+
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([WeakThis, Pending = MoveTemp(Pending), LatencyMs](float)
+    {
+        if (TSharedPtr<FAIMockBackend> This = WeakThis.Pin())
+        {
+            This->FinishRequest(Pending, LatencyMs);
+        }
+        return false;
+    }), LatencyMs / 1000.0f);
+}
+
+void FAIMockBackend::FinishRequest(const FPendingRequest& Pending, float LatencyMs)
+{
+    InFlightCount--;
+
+    // 취소된 요청은 응답하지 않음 (처리 슬롯은 원래 지연 시간 동안 차지해 상류 서버가 끝까지 생성하는 경우를 흉내 냄)
+    if (Pending.Request.Cancellation && Pending.Request.Cancellation->bCancelled)
+    {
+        CancelledCount++;
+        StartQueuedRequests();
+        return;
+    }
+
+    CompletedCount++;
+
+    FAIChatResult Result;
+    Result.bSuccess = true;
+    Result.TotalMs = LatencyMs;
+
+    if (Pending.ResponseIndex == INDEX_NONE)
+    {
+        Result.ResponseCode = 500;
+    }
+    else
+    {
+        const FString& Content = CannedResponses[Pending.ResponseIndex];
+        Result.ResponseCode = 200;
+        if (Pending.Request.bStream)
+        {
+            Result.Content = Content;
+            Result.bHasContent = true;
+            Result.FinishReason = TEXT("stop");
+
+            const int32 NumChunks = FMath::Min(Settings.StreamChunks, Content.Len());
+            for (int32 i = 0; i < NumChunks; i++)
+            {
+                const int32 Start = Content.Len() * i / NumChunks;
+                const int32 End = Content.Len() * (i + 1) / NumChunks;
+                Result.Chunks.Add({ ChunkOffsetMs(LatencyMs, i, NumChunks), Content.Mid(Start, End - Start) });
+            }
+        }
+        else
+        {
+            Result.ResponseBody = AIMockBackendPrivate::MakeCompletionBody(Content);
+        }
+    }
+
+    Pending.OnComplete.ExecuteIfBound(Result);
+
+    // 슬롯이 비었으니 대기 중인 요청 시작
+    StartQueuedRequests();
+}
+
+float FAIMockBackend::SampleLatencyMs()
+{
+    switch (Settings.LatencyModel)
+    {
+    case EAIMockLatencyModel::Uniform:
+        return FMath::Max(0.0f, Random.FRandRange(Settings.MeanMs - Settings.SpreadMs, Settings.MeanMs + Settings.SpreadMs));
+
+    case EAIMockLatencyModel::LogNormal:
+    {
+        // Box-Muller 표준 정규분포
+        const float U1 = FMath::Max(Random.FRand(), UE_KINDA_SMALL_NUMBER);
+        const float U2 = Random.FRand();
+        const float Normal = FMath::Sqrt(-2.0f * FMath::Loge(U1)) * FMath::Cos(2.0f * UE_PI * U2);
+        const float Sigma = Settings.MeanMs > 0.0f ? Settings.SpreadMs / Settings.MeanMs : 0.0f;
+        return Settings.MeanMs * FMath::Exp(Sigma * Normal);
+    }
+
+    case EAIMockLatencyModel::Constant:
+    default:
+        return Settings.MeanMs;
+    }
+}
+
+void FAIMockBackend::ResetStats()
+{
+    CompletedCount = 0;
+    CancelledCount = 0;
+    QueueDelays = FAILatencyHistogram(4096);
+}
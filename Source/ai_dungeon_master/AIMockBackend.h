@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIChatBackend.h"
+#include "AIRequestTrace.h"
+
+// 모의 응답 지연 분포
+enum class EAIMockLatencyModel : uint8
+{
+    Constant,   // 항상 MeanMs
+    Uniform,    // MeanMs ± SpreadMs
+    LogNormal   // 중앙값 MeanMs, 로그 표준편차 SpreadMs / MeanMs (긴 꼬리)
+};
+
+// 모의 백엔드 설정
+struct FAIMockBackendSettings
+{
+    EAIMockLatencyModel LatencyModel = EAIMockLatencyModel::LogNormal;
+    float MeanMs = 800.0f;
+    float SpreadMs = 400.0f;
+    int32 MaxConcurrent = 0;    // 동시에 처리하는 요청 수 (0 = 무제한, 넘으면 대기열)
+    float ErrorRate = 0.0f;     // 0~1, HTTP 500 응답 비율
+    int32 StreamChunks = 4;     // 스트리밍 요청일 때 나눠 보낼 조각 수
+    int32 Seed = 1234;
+};
+
+/**
+ * 네트워크 없이 설정된 지연 분포로 응답하는 로컬 모의 LLM 백엔드
+ * 응답은 OpenAI 형식 JSON이라 매니저의 파싱 경로를 그대로 탄다.
+ * 여러 세션이 하나의 인스턴스를 공유하면 MaxConcurrent로 상류 서버의 대기열을 흉내 낸다.
+ * 취소된 요청(FAIChatRequest::Cancellation)은 조각과 완료 콜백을 보내지 않는다.
+ */
+class AI_DUNGEON_MASTER_API FAIMockBackend : public IAIChatBackend, public TSharedFromThis<FAIMockBackend>
+{
+public:
+    explicit FAIMockBackend(const FAIMockBackendSettings& InSettings);
+
+    virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) override;
+    virtual bool RequiresAPIKey() const override { return false; }
+    virtual const TCHAR* GetName() const override { return TEXT("Mock"); }
+
+    // 대기열 지연 (요청 도착 -> 처리 시작) 백분위
+    float GetQueueDelayPercentile(float Percentile) const { return QueueDelays.GetPercentile(Percentile); }
+
+    int32 GetCompletedCount() const { return CompletedCount; }
+    int32 GetCancelledCount() const { return CancelledCount; }
+    int32 GetQueuedCount() const { return Queue.Num(); }
+    int32 GetInFlightCount() const { return InFlightCount; }
+
+    // 측정 구간 초기화
+    void ResetStats();
+
+private:
+    struct FPendingRequest
+    {
+        FAIChatRequest Request;
+        FOnAIChatChunk OnChunk;
+        FOnAIChatComplete OnComplete;
+        uint64 SubmitCycles = 0;
+        int32 ResponseIndex = INDEX_NONE;   // 시작 시 결정 (INDEX_NONE = 오류 응답)
+    };
+
+    // 처리 슬롯이 있으면 대기열에서 꺼내 시작
+    void StartQueuedRequests();
+    void StartRequest(FPendingRequest&& Pending);
+    void FinishRequest(const FPendingRequest& Pending, float LatencyMs);
+
+    float SampleLatencyMs();
+
+    FAIMockBackendSettings Settings;
+    FRandomStream Random;
+    TArray<FString> CannedResponses;
+
+    TArray<FPendingRequest> Queue;
+    int32 InFlightCount = 0;
+    int32 CompletedCount = 0;
+    int32 CancelledCount = 0;
+    FAILatencyHistogram QueueDelays{ 4096 };
+};
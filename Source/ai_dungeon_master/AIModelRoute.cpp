@@ -0,0 +1,98 @@
+#include "AIModelRoute.h"
+#include "AIDMLog.h"
+
+const TCHAR* GetModelRouteName(EAIModelRoute Route)
+{
+    switch (Route)
+    {
+    case EAIModelRoute::Local:      return TEXT("local");
+    case EAIModelRoute::Narration:  return TEXT("narration");
+    case EAIModelRoute::Summary:    return TEXT("summary");
+    default:                        return TEXT("unknown");
+    }
+}
+
+void FAIRouteTracker::Record(EAIModelRoute Route, const FAIModelRoute& ModelRoute, bool bSuccess, float LatencyMs,
+    const FAITokenUsage& Usage, int32 PromptTokensIfUnknown, int32 CompletionTokensIfUnknown)
+{
+    const int32 Index = static_cast<int32>(Route);
+    FAIRouteStats& RouteStats = Stats[Index];
+
+    RouteStats.Model = ModelRoute.Model;
+    RouteStats.Requests++;
+    if (!bSuccess)
+    {
+        RouteStats.Failures++;
+    }
+
+    LatencySumMs[Index] += LatencyMs;
+    Latencies[Index].Add(LatencyMs);
+
+    // 실패한 요청도 입력 토큰은 청구될 수 있으므로 집계
+    const int32 PromptTokens = Usage.PromptTokens > 0 ? Usage.PromptTokens : PromptTokensIfUnknown;
+    const int32 CompletionTokens = Usage.CompletionTokens > 0 ? Usage.CompletionTokens : (bSuccess ? CompletionTokensIfUnknown : 0);
+    RouteStats.PromptTokens += PromptTokens;
+    RouteStats.CompletionTokens += CompletionTokens;
+    RouteStats.EstimatedCost += PromptTokens / 1000.0 * ModelRoute.InputCostPer1K + CompletionTokens / 1000.0 * ModelRoute.OutputCostPer1K;
+
+    if (bSuccess)
+    {
+        FLatencyFit& Fit = LatencyFits[Index];
+        Fit.Samples += 1.0;
+        Fit.SumX += CompletionTokens;
+        Fit.SumY += LatencyMs;
+        Fit.SumXY += static_cast<double>(CompletionTokens) * LatencyMs;
+        Fit.SumXX += static_cast<double>(CompletionTokens) * CompletionTokens;
+    }
+}
+
+FAIRequestEstimate FAIRouteTracker::Estimate(EAIModelRoute Route, const FAIModelRoute& ModelRoute, int32 PromptTokens) const
+{
+    const int32 Index = static_cast<int32>(Route);
+    const FLatencyFit& Fit = LatencyFits[Index];
+
+    FAIRequestEstimate Result;
+    Result.PromptTokens = PromptTokens;
+    Result.CompletionTokens = Fit.Samples > 0.0 ? FMath::RoundToInt(Fit.SumX / Fit.Samples) : ModelRoute.MaxTokens;
+    Result.Cost = static_cast<float>(PromptTokens / 1000.0 * ModelRoute.InputCostPer1K + Result.CompletionTokens / 1000.0 * ModelRoute.OutputCostPer1K);
+
+    // 응답 길이가 다양해야 기울기를 믿을 수 있음 (아니면 평균 지연)
+    const double Variance = Fit.Samples * Fit.SumXX - Fit.SumX * Fit.SumX;
+    if (Fit.Samples >= 2.0 && Variance > UE_KINDA_SMALL_NUMBER)
+    {
+        const double Slope = (Fit.Samples * Fit.SumXY - Fit.SumX * Fit.SumY) / Variance;
+        const double Intercept = (Fit.SumY - Slope * Fit.SumX) / Fit.Samples;
+        Result.LatencyMs = static_cast<float>(FMath::Max(0.0, Intercept + Slope * Result.CompletionTokens));
+    }
+    else if (Fit.Samples > 0.0)
+    {
+        Result.LatencyMs = static_cast<float>(Fit.SumY / Fit.Samples);
+    }
+    return Result;
+}
+
+FAIRouteStats FAIRouteTracker::GetStats(EAIModelRoute Route) const
+{
+    const int32 Index = static_cast<int32>(Route);
+    FAIRouteStats Result = Stats[Index];
+    Result.AvgLatencyMs = Result.Requests > 0 ? static_cast<float>(LatencySumMs[Index] / Result.Requests) : 0.0f;
+    Result.P95LatencyMs = Latencies[Index].GetPercentile(95.0f);
+    return Result;
+}
+
+void FAIRouteTracker::LogSummary() const
+{
+    for (int32 Index = 0; Index < static_cast<int32>(EAIModelRoute::Count); Index++)
+    {
+        const EAIModelRoute Route = static_cast<EAIModelRoute>(Index);
+        const FAIRouteStats RouteStats = GetStats(Route);
+        if (RouteStats.Requests == 0)
+        {
+            continue;
+        }
+
+        UE_LOG(LogAIDM, Log, TEXT("경로 %s (%s): 요청 %d (실패 %d), 평균 %.0f ms / p95 %.0f ms, 토큰 %lld + %lld, 비용 %.4f"),
+            GetModelRouteName(Route), RouteStats.Model.IsEmpty() ? TEXT("-") : *RouteStats.Model, RouteStats.Requests, RouteStats.Failures,
+            RouteStats.AvgLatencyMs, RouteStats.P95LatencyMs, RouteStats.PromptTokens, RouteStats.CompletionTokens, RouteStats.EstimatedCost);
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIRequestTrace.h"
+#include "AIModelRoute.generated.h"
+
+// 요청 경로 (경로마다 모델, 한도, 비용을 따로 설정하고 지표를 따로 집계)
+UENUM(BlueprintType)
+enum class EAIModelRoute : uint8
+{
+    Local       UMETA(DisplayName = "Local"),       // 모델 없이 로컬 파서/템플릿으로 처리
+    Narration   UMETA(DisplayName = "Narration"),   // 플레이어에게 보여 줄 서술 (큰 모델)
+    Summary     UMETA(DisplayName = "Summary"),     // 캠페인 요약 (작은 모델로 충분)
+    Count       UMETA(Hidden)
+};
+
+// 설정 파일/로그에서 쓰는 경로 이름 ("narration", "summary" 등)
+AI_DUNGEON_MASTER_API const TCHAR* GetModelRouteName(EAIModelRoute Route);
+
+// 경로 하나의 모델 설정
+// Model이 비어 있으면 기본 모델, MaxTokens 0 / Temperature 음수면 요청 종류의 기본값
+struct AI_DUNGEON_MASTER_API FAIModelRoute
+{
+    FString Model;
+    int32 MaxTokens = 0;
+    float Temperature = -1.0f;
+
+    // 1000 토큰당 비용 (지표용, 통화 단위는 설정에 맞춤)
+    float InputCostPer1K = 0.0f;
+    float OutputCostPer1K = 0.0f;
+};
+
+// 요청 하나의 토큰 사용량 (응답에 usage가 없으면 0, 집계할 때 토크나이저로 셈)
+struct FAITokenUsage
+{
+    int32 PromptTokens = 0;
+    int32 CompletionTokens = 0;
+
+    // 토크나이저가 없을 때: 영어 기준 대략 4글자 = 1토큰
+    static int32 EstimateTokens(const FString& Text) { return (Text.Len() + 3) / 4; }
+};
+
+// 경로별 지표
+USTRUCT(BlueprintType)
+struct FAIRouteStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    FString Model;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    int32 Requests = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    int32 Failures = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    float AvgLatencyMs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    float P95LatencyMs = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    int64 PromptTokens = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    int64 CompletionTokens = 0;
+
+    // 추정 토큰 포함 (응답에 usage가 없던 요청)
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    double EstimatedCost = 0.0;
+};
+
+// 보내기 전 요청 하나의 예상 토큰, 비용, 지연
+USTRUCT(BlueprintType)
+struct FAIRequestEstimate
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    int32 PromptTokens = 0;
+
+    // 지금까지 평균 응답 길이 (기록이 없으면 max_tokens)
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    int32 CompletionTokens = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    float Cost = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Routing")
+    float LatencyMs = 0.0f;
+};
+
+/**
+ * 경로별 요청 수, 지연, 토큰, 비용 집계 (게임 스레드 전용)
+ * 같은 본문으로 합쳐진 요청은 백엔드 요청 하나로 센다.
+ */
+class AI_DUNGEON_MASTER_API FAIRouteTracker
+{
+public:
+    // *IfUnknown: 응답에 usage가 없을 때 쓸 토크나이저 계산값
+    void Record(EAIModelRoute Route, const FAIModelRoute& ModelRoute, bool bSuccess, float LatencyMs,
+        const FAITokenUsage& Usage, int32 PromptTokensIfUnknown, int32 CompletionTokensIfUnknown);
+
+    FAIRouteStats GetStats(EAIModelRoute Route) const;
+
+    // 지금까지의 성공 요청으로 추정 (지연 = 응답 토큰 수에 대한 선형 회귀)
+    FAIRequestEstimate Estimate(EAIModelRoute Route, const FAIModelRoute& ModelRoute, int32 PromptTokens) const;
+
+    // 경로별 한 줄 요약 로그
+    void LogSummary() const;
+
+private:
+    FAIRouteStats Stats[static_cast<int32>(EAIModelRoute::Count)];
+    double LatencySumMs[static_cast<int32>(EAIModelRoute::Count)] = {};
+    FAILatencyHistogram Latencies[static_cast<int32>(EAIModelRoute::Count)];
+
+    // 성공 요청의 (응답 토큰, 지연) 회귀 합계
+    struct FLatencyFit
+    {
+        double Samples = 0.0;
+        double SumX = 0.0;
+        double SumY = 0.0;
+        double SumXY = 0.0;
+        double SumXX = 0.0;
+    };
+    FLatencyFit LatencyFits[static_cast<int32>(EAIModelRoute::Count)];
+};
@@ -0,0 +1,305 @@
+#include "AIPromptAssembler.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Misc/Crc.h"
+#include "AIDMLog.h"
+#include "AIModelRoute.h"
+
+void UAIPromptAssembler::SetStaticRules(const FString& Rules, int32 Version)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::StaticRules);
+    Segment.Messages.Reset();
+    Segment.Messages.Add({ TEXT("system"), Rules });
+    Segment.Version = Version;
+}
+
+void UAIPromptAssembler::SetWorldLore(const FString& Lore, int32 Version)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::WorldLore);
+    Segment.Messages.Reset();
+    if (!Lore.IsEmpty())
+    {
+        Segment.Messages.Add({ TEXT("system"), Lore });
+    }
+    Segment.Version = Version;
+}
+
+void UAIPromptAssembler::SetSummary(const FString& SummaryText, int32 Version)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::Summary);
+    Segment.Messages.Reset();
+    if (!SummaryText.IsEmpty())
+    {
+        Segment.Messages.Add({ TEXT("system"), FString::Printf(TEXT("Campaign so far: %s"), *SummaryText) });
+    }
+    Segment.Version = Version;
+}
+
+void UAIPromptAssembler::SetRecentTurns(const TArray<FAISessionRecord>& History, int32 StartIndex)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::RecentTurns);
+    Segment.Messages.Reset();
+    for (int32 i = FMath::Max(0, StartIndex); i < History.Num(); i++)
+    {
+        const FAISessionRecord& Turn = History[i];
+        Segment.Messages.Add({ Turn.RecordType == EAISessionRecordType::UserMessage ? TEXT("user") : TEXT("assistant"), Turn.Text });
+    }
+}
+
+void UAIPromptAssembler::SetRecalledMemories(const TArray<FAIMemoryHit>& Memories)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::Recall);
+    Segment.Messages.Reset();
+    if (Memories.Num() == 0)
+    {
+        return;
+    }
+
+    FString MemoryText = TEXT("Relevant events from earlier in the campaign:");
+    for (const FAIMemoryHit& Memory : Memories)
+    {
+        MemoryText += TEXT("\n- ") + Memory.Text.Replace(TEXT("\n"), TEXT(" / "));
+    }
+    Segment.Messages.Add({ TEXT("system"), MemoryText });
+}
+
+void UAIPromptAssembler::SetWorldState(const FString& Snapshot, int32 Version)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::WorldState);
+    Segment.Messages.Reset();
+    if (!Snapshot.IsEmpty())
+    {
+        Segment.Messages.Add({ TEXT("system"), Snapshot });
+    }
+    Segment.Version = Version;
+}
+
+void UAIPromptAssembler::SetWorldDelta(const FString& Delta)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::WorldDelta);
+    Segment.Messages.Reset();
+    if (!Delta.IsEmpty())
+    {
+        Segment.Messages.Add({ TEXT("system"), Delta });
+    }
+}
+
+void UAIPromptAssembler::SetUserInput(const FString& Message)
+{
+    FSegmentState& Segment = GetSegment(EAIPromptSegment::UserInput);
+    Segment.Messages.Reset();
+    Segment.Messages.Add({ TEXT("user"), Message });
+}
+
+uint32 UAIPromptAssembler::HashSegment(const FSegmentState& Segment)
+{
+    uint32 Hash = FCrc::MemCrc32(&Segment.Version, sizeof(Segment.Version));
+    for (const FPromptMessage& Message : Segment.Messages)
+    {
+        Hash = FCrc::StrCrc32(*Message.Role, Hash);
+        Hash = FCrc::StrCrc32(*Message.Content, Hash);
+    }
+    return Hash;
+}
+
+int32 UAIPromptAssembler::CountMessageTokens(const FString& Content) const
+{
+    return Tokenizer ? Tokenizer->CountMessageTokens(Content) : FAITokenUsage::EstimateTokens(Content) + FAITokenizer::MessageOverheadTokens;
+}
+
+FString UAIPromptAssembler::SerializeBody(const FString& Model, int32 MaxTokens, float Temperature, bool bStream) const
+{
+    FString Body;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Body);
+
+    Writer->WriteObjectStart();
+    Writer->WriteValue(TEXT("model"), Model);
+    Writer->WriteArrayStart(TEXT("messages"));
+    for (const FSegmentState& Segment : Segments)
+    {
+        for (const FPromptMessage& Message : Segment.Messages)
+        {
+            Writer->WriteObjectStart();
+            Writer->WriteValue(TEXT("role"), Message.Role);
+            Writer->WriteValue(TEXT("content"), Message.Content);
+            Writer->WriteObjectEnd();
+        }
+    }
+    Writer->WriteArrayEnd();
+
+    // 요청마다 바뀔 수 있는 매개변수는 메시지 뒤에
+    Writer->WriteValue(TEXT("max_tokens"), MaxTokens);
+    Writer->WriteValue(TEXT("temperature"), Temperature);
+    if (bStream)
+    {
+        Writer->WriteValue(TEXT("stream"), true);
+    }
+    Writer->WriteObjectEnd();
+    Writer->Close();
+    return Body;
+}
+
+FString UAIPromptAssembler::PreviewRequestBody(const FString& Model, int32 MaxTokens, float Temperature, bool bStream, int32* OutPromptTokens) const
+{
+    if (OutPromptTokens)
+    {
+        // 직전 요청과 같은 세그먼트는 저장된 토큰 수 사용
+        int32 PromptTokens = FAITokenizer::ReplyPrimingTokens;
+        for (int32 i = 0; i < NumSegments; i++)
+        {
+            if (Stats.RequestCount > 0 && HashSegment(Segments[i]) == LastSegmentHashes[i])
+            {
+                PromptTokens += SegmentTokens[i];
+                continue;
+            }
+            for (const FPromptMessage& Message : Segments[i].Messages)
+            {
+                PromptTokens += CountMessageTokens(Message.Content);
+            }
+        }
+        *OutPromptTokens = PromptTokens;
+    }
+    return SerializeBody(Model, MaxTokens, Temperature, bStream);
+}
+
+FString UAIPromptAssembler::BuildRequestBody(const FString& Model, int32 MaxTokens, float Temperature, bool bStream)
+{
+    const FString Body = SerializeBody(Model, MaxTokens, Temperature, bStream);
+
+    // 직전 요청과의 공유 앞부분 길이
+    const int32 MaxShared = FMath::Min(Body.Len(), LastBody.Len());
+    const TCHAR* NewChars = *Body;
+    const TCHAR* OldChars = *LastBody;
+    int32 SharedLength = 0;
+    while (SharedLength < MaxShared && NewChars[SharedLength] == OldChars[SharedLength])
+    {
+        SharedLength++;
+    }
+
+    // 처음 달라진 세그먼트 (달라진 세그먼트만 토큰을 다시 셈)
+    EAIPromptSegment BreakSegment = EAIPromptSegment::None;
+    int32 PromptTokens = FAITokenizer::ReplyPrimingTokens;
+    for (int32 i = 0; i < NumSegments; i++)
+    {
+        const uint32 Hash = HashSegment(Segments[i]);
+        if (Hash != LastSegmentHashes[i] || Stats.RequestCount == 0)
+        {
+            if (BreakSegment == EAIPromptSegment::None)
+            {
+                BreakSegment = static_cast<EAIPromptSegment>(i);
+            }
+
+            SegmentTokens[i] = 0;
+            for (const FPromptMessage& Message : Segments[i].Messages)
+            {
+                SegmentTokens[i] += CountMessageTokens(Message.Content);
+            }
+        }
+        LastSegmentHashes[i] = Hash;
+        PromptTokens += SegmentTokens[i];
+    }
+
+    Stats.RequestCount++;
+    Stats.LastSharedPrefixLength = SharedLength;
+    Stats.LastBodyLength = Body.Len();
+    Stats.LastBreakSegment = BreakSegment;
+    Stats.LastPromptTokens = PromptTokens;
+    TotalSharedLength += SharedLength;
+    TotalBodyLength += Body.Len();
+    Stats.AverageSharedRatio = TotalBodyLength > 0 ? static_cast<float>(static_cast<double>(TotalSharedLength) / TotalBodyLength) : 0.0f;
+
+    AIDM_EVENT(Verbose, "PromptPrefix", AIDM_FIELD("shared", SharedLength), AIDM_FIELD("length", Body.Len()),
+        AIDM_FIELD("break", UEnum::GetValueAsString(BreakSegment)));
+
+    LastBody = Body;
+    return Body;
+}
+
+int32 UAIPromptAssembler::FindRecentTurnWindowStart(const TArray<FAISessionRecord>& History) const
+{
+    for (int32 i = 0; i < History.Num(); i++)
+    {
+        if (History[i].Timestamp >= RecentWindowAnchor)
+        {
+            return i;
+        }
+    }
+    return History.Num();
+}
+
+int32 UAIPromptAssembler::SelectRecentTurnWindow(const TArray<FAISessionRecord>& History, int32 MaxTurns, int32 StepTurns, int32 MaxTokens)
+{
+    int32 StartIndex = FindRecentTurnWindowStart(History);
+
+    // 창 안의 턴 수 (플레이어 입력 기준)
+    int32 TurnCount = 0;
+    for (int32 i = StartIndex; i < History.Num(); i++)
+    {
+        if (History[i].RecordType == EAISessionRecordType::UserMessage)
+        {
+            TurnCount++;
+        }
+    }
+
+    // 창이 너무 커졌을 때만 MaxTurns로 한꺼번에 줄임
+    if (TurnCount > MaxTurns + FMath::Max(0, StepTurns))
+    {
+        int32 TurnsToDrop = TurnCount - MaxTurns;
+        while (StartIndex < History.Num() && TurnsToDrop > 0)
+        {
+            StartIndex++;
+            if (StartIndex < History.Num() && History[StartIndex].RecordType == EAISessionRecordType::UserMessage)
+            {
+                TurnsToDrop--;
+            }
+        }
+
+        if (StartIndex < History.Num())
+        {
+            RecentWindowAnchor = History[StartIndex].Timestamp;
+        }
+    }
+
+    // 턴 수는 괜찮아도 긴 턴이 많으면 토큰 한도의 절반까지 한꺼번에 줄임 (턴 단위, 창 이동 횟수를 줄이기 위해)
+    if (MaxTokens > 0)
+    {
+        TArray<int32, TInlineAllocator<32>> RecordTokens;
+        int32 WindowTokens = 0;
+        for (int32 i = StartIndex; i < History.Num(); i++)
+        {
+            WindowTokens += RecordTokens.Add_GetRef(CountMessageTokens(History[i].Text));
+        }
+
+        if (WindowTokens > MaxTokens)
+        {
+            int32 NewStart = StartIndex;
+            while (WindowTokens > MaxTokens / 2)
+            {
+                // 다음 플레이어 입력까지 (마지막 턴은 남김)
+                int32 NextTurn = NewStart + 1;
+                while (NextTurn < History.Num() && History[NextTurn].RecordType != EAISessionRecordType::UserMessage)
+                {
+                    NextTurn++;
+                }
+                if (NextTurn >= History.Num())
+                {
+                    break;
+                }
+                for (int32 i = NewStart; i < NextTurn; i++)
+                {
+                    WindowTokens -= RecordTokens[i - StartIndex];
+                }
+                NewStart = NextTurn;
+            }
+
+            if (NewStart != StartIndex)
+            {
+                AIDM_EVENT(Verbose, "WindowTokenTrim", AIDM_FIELD("dropped", NewStart - StartIndex), AIDM_FIELD("tokens", WindowTokens));
+                StartIndex = NewStart;
+                RecentWindowAnchor = History[StartIndex].Timestamp;
+            }
+        }
+    }
+
+    return StartIndex;
+}
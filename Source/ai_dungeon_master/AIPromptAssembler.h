@@ -0,0 +1,133 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AISessionLog.h"
+#include "AIRetrievalMemory.h"
+#include "AITokenizer.h"
+#include "AIPromptAssembler.generated.h"
+
+// 프롬프트 세그먼트 (이 순서대로 직렬화, 자주 바뀌는 것일수록 뒤쪽)
+UENUM(BlueprintType)
+enum class EAIPromptSegment : uint8
+{
+    StaticRules     UMETA(DisplayName = "Static Rules"),    // 고정 규칙 (시스템 프롬프트)
+    WorldLore       UMETA(DisplayName = "World Lore"),      // 세계관 설정
+    Summary         UMETA(DisplayName = "Summary"),         // 캠페인 요약
+    WorldState      UMETA(DisplayName = "World State"),     // 주변 상태 스냅샷 (가끔만 다시 만듦)
+    RecentTurns     UMETA(DisplayName = "Recent Turns"),    // 최근 대화
+    Recall          UMETA(DisplayName = "Recall"),          // 회상된 기억 (요청마다 바뀜)
+    WorldDelta      UMETA(DisplayName = "World Delta"),     // 스냅샷 이후 바뀐 주변 상태
+    UserInput       UMETA(DisplayName = "User Input"),      // 현재 플레이어 입력
+    None            UMETA(Hidden)
+};
+
+// 프롬프트 캐시 지표
+USTRUCT(BlueprintType)
+struct FAIPromptCacheStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 RequestCount = 0;                                     // 조립한 요청 수
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 LastSharedPrefixLength = 0;                           // 직전 요청과 같은 앞부분 길이 (문자)
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 LastBodyLength = 0;                                   // 마지막 요청 본문 길이 (문자)
+
+    UPROPERTY(BlueprintReadOnly)
+    EAIPromptSegment LastBreakSegment = EAIPromptSegment::None; // 직전 요청과 처음 달라진 세그먼트
+
+    UPROPERTY(BlueprintReadOnly)
+    float AverageSharedRatio = 0.0f;                            // 평균 공유 비율 (0~1)
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 LastPromptTokens = 0;                                 // 마지막 요청의 프롬프트 토큰 (메시지 구분 토큰 포함)
+};
+
+/**
+ * 순서와 버전이 고정된 세그먼트로 요청 본문을 조립하는 계층
+ * 같은 입력이면 항상 같은 바이트를 만들어 제공자 측 프롬프트 캐시가 앞부분을 재사용할 수 있게 한다.
+ * 필드 순서는 model -> messages -> 샘플링 매개변수로 고정 (요청마다 바뀌는 값은 뒤쪽).
+ */
+UCLASS()
+class AI_DUNGEON_MASTER_API UAIPromptAssembler : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    // 세그먼트 설정 (버전이 같으면 내용도 같다고 가정하지 않고 내용 해시로 비교)
+    void SetStaticRules(const FString& Rules, int32 Version);
+    void SetWorldLore(const FString& Lore, int32 Version);
+    void SetSummary(const FString& SummaryText, int32 Version);
+    void SetRecentTurns(const TArray<FAISessionRecord>& History, int32 StartIndex);
+    void SetRecalledMemories(const TArray<FAIMemoryHit>& Memories);
+    void SetWorldState(const FString& Snapshot, int32 Version);
+    void SetWorldDelta(const FString& Delta);
+    void SetUserInput(const FString& Message);
+
+    // 토큰 수 계산기 (없으면 글자 수로 추정)
+    void SetTokenizer(TSharedPtr<const FAITokenizer> InTokenizer) { Tokenizer = InTokenizer; }
+
+    // 요청 본문 직렬화 및 직전 요청과의 공유 앞부분 측정
+    FString BuildRequestBody(const FString& Model, int32 MaxTokens, float Temperature, bool bStream = false);
+
+    // 지표와 직전 요청 정보를 바꾸지 않고 직렬화 (예측, 검증처럼 플레이어 턴이 아닌 요청용)
+    FString PreviewRequestBody(const FString& Model, int32 MaxTokens, float Temperature, bool bStream = false, int32* OutPromptTokens = nullptr) const;
+
+    // 최근 대화 창 시작 위치 선택
+    // 창은 MaxTurns ~ MaxTurns + StepTurns 턴 사이에서 한 번에 StepTurns씩만 앞으로 이동하므로
+    // 매 턴마다 가장 오래된 턴이 빠져 앞부분이 깨지는 일을 막는다.
+    // MaxTokens > 0이면 창의 토큰이 넘칠 때도 한 번에 절반 아래로 줄인다 (마지막 턴은 남김).
+    int32 SelectRecentTurnWindow(const TArray<FAISessionRecord>& History, int32 MaxTurns, int32 StepTurns, int32 MaxTokens = 0);
+
+    // 현재 창 시작 위치 (창을 움직이지 않음)
+    int32 FindRecentTurnWindowStart(const TArray<FAISessionRecord>& History) const;
+
+    UFUNCTION(BlueprintPure, Category = "AI|Prompt")
+    FAIPromptCacheStats GetCacheStats() const { return Stats; }
+
+private:
+    struct FPromptMessage
+    {
+        FString Role;
+        FString Content;
+    };
+
+    struct FSegmentState
+    {
+        TArray<FPromptMessage> Messages;
+        int32 Version = 0;
+    };
+
+    static constexpr int32 NumSegments = static_cast<int32>(EAIPromptSegment::None);
+
+    FSegmentState& GetSegment(EAIPromptSegment Segment) { return Segments[static_cast<int32>(Segment)]; }
+    static uint32 HashSegment(const FSegmentState& Segment);
+
+    int32 CountMessageTokens(const FString& Content) const;
+
+    FString SerializeBody(const FString& Model, int32 MaxTokens, float Temperature, bool bStream) const;
+
+    FSegmentState Segments[NumSegments];
+
+    // 직전 요청 정보
+    FString LastBody;
+    uint32 LastSegmentHashes[NumSegments] = {};
+
+    // 세그먼트별 토큰 수 (해시가 바뀐 세그먼트만 다시 셈)
+    int32 SegmentTokens[NumSegments] = {};
+
+    TSharedPtr<const FAITokenizer> Tokenizer;
+
+    // 최근 대화 창 기준 시각
+    FDateTime RecentWindowAnchor;
+
+    // 누적 공유 길이 (평균 계산용)
+    int64 TotalSharedLength = 0;
+    int64 TotalBodyLength = 0;
+
+    FAIPromptCacheStats Stats;
+};
@@ -0,0 +1,197 @@
+#include "AIRequestTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "AIDMLog.h"
+
+UE_TRACE_CHANNEL_DEFINE(AIDMChannel)
+
+CSV_DEFINE_CATEGORY(AIDM, true);
+
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Total p50 (ms)"), STAT_AIDM_TotalP50, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Total p95 (ms)"), STAT_AIDM_TotalP95, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Total p99 (ms)"), STAT_AIDM_TotalP99, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Network p50 (ms)"), STAT_AIDM_NetworkP50, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Network p95 (ms)"), STAT_AIDM_NetworkP95, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Network p99 (ms)"), STAT_AIDM_NetworkP99, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Dispatch p95 (ms)"), STAT_AIDM_DispatchP95, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("JSON Parse p95 (ms)"), STAT_AIDM_JsonParseP95, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Action Parse p95 (ms)"), STAT_AIDM_ActionParseP95, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Deliver p95 (ms)"), STAT_AIDM_DeliverP95, STATGROUP_AIDM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Completed Requests"), STAT_AIDM_Completed, STATGROUP_AIDM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Failed Requests"), STAT_AIDM_Failed, STATGROUP_AIDM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("SLO Breaches"), STAT_AIDM_SLOBreaches, STATGROUP_AIDM);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("SLO Breach Time (s)"), STAT_AIDM_SLOBreachSeconds, STATGROUP_AIDM);
+
+// ---------------------------------------------------------------------------
+// FAIRequestTrace
+// ---------------------------------------------------------------------------
+
+FAIRequestTrace::FAIRequestTrace()
+{
+    FMemory::Memzero(StageCycles, sizeof(StageCycles));
+}
+
+void FAIRequestTrace::Mark(EAITraceStage Stage)
+{
+    StageCycles[static_cast<int32>(Stage)] = FPlatformTime::Cycles64();
+}
+
+double FAIRequestTrace::GetMs(EAITraceStage From, EAITraceStage To) const
+{
+    const uint64 FromCycles = StageCycles[static_cast<int32>(From)];
+    const uint64 ToCycles = StageCycles[static_cast<int32>(To)];
+    if (FromCycles == 0 || ToCycles == 0 || ToCycles < FromCycles)
+    {
+        return 0.0;
+    }
+    return FPlatformTime::ToMilliseconds64(ToCycles - FromCycles);
+}
+
+double FAIRequestTrace::GetTotalMs(EAITraceStage To) const
+{
+    for (int32 i = 0; i < static_cast<int32>(To); i++)
+    {
+        if (StageCycles[i] != 0)
+        {
+            return GetMs(static_cast<EAITraceStage>(i), To);
+        }
+    }
+    return 0.0;
+}
+
+// ---------------------------------------------------------------------------
+// FAILatencyHistogram
+// ---------------------------------------------------------------------------
+
+FAILatencyHistogram::FAILatencyHistogram(int32 InCapacity)
+    : Capacity(FMath::Max(1, InCapacity))
+{
+    Samples.Reserve(Capacity);
+}
+
+void FAILatencyHistogram::Add(float ValueMs)
+{
+    if (Samples.Num() < Capacity)
+    {
+        Samples.Add(ValueMs);
+    }
+    else
+    {
+        Samples[NextIndex] = ValueMs;
+    }
+    NextIndex = (NextIndex + 1) % Capacity;
+}
+
+float FAILatencyHistogram::GetPercentile(float Percentile) const
+{
+    if (Samples.Num() == 0)
+    {
+        return 0.0f;
+    }
+
+    TArray<float> Sorted = Samples;
+    Sorted.Sort();
+    const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile / 100.0f * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+    return Sorted[Index];
+}
+
+// ---------------------------------------------------------------------------
+// FAILatencyTracker
+// ---------------------------------------------------------------------------
+
+FString FAILatencyTracker::GetRegionName(int32 RequestId)
+{
+    return FString::Printf(TEXT("AIDM Request %d"), RequestId);
+}
+
+void FAILatencyTracker::BeginRequest(FAIRequestTrace& Trace)
+{
+    Trace.RequestId = ++LastRequestId;
+    if (!Trace.HasStage(EAITraceStage::Dispatch))
+    {
+        Trace.Mark(EAITraceStage::Dispatch);
+    }
+    TRACE_BEGIN_REGION(*GetRegionName(Trace.RequestId));
+}
+
+void FAILatencyTracker::CompleteRequest(const FAIRequestTrace& Trace, bool bSuccess)
+{
+    TRACE_END_REGION(*GetRegionName(Trace.RequestId));
+
+    if (!bSuccess)
+    {
+        FailedCount++;
+        SET_DWORD_STAT(STAT_AIDM_Failed, FailedCount);
+        return;
+    }
+
+    const float DispatchMs = static_cast<float>(Trace.GetTotalMs(EAITraceStage::RequestSent));
+    const float NetworkMs = static_cast<float>(Trace.GetMs(EAITraceStage::RequestSent, EAITraceStage::ResponseReceived));
+    const float JsonParseMs = static_cast<float>(Trace.GetMs(EAITraceStage::ResponseReceived, EAITraceStage::JsonParsed));
+    const float ActionParseMs = static_cast<float>(Trace.GetMs(EAITraceStage::JsonParsed, EAITraceStage::ActionsParsed));
+    const float DeliverMs = static_cast<float>(Trace.GetMs(EAITraceStage::ActionsParsed, EAITraceStage::Delivered));
+    const float TotalMs = static_cast<float>(Trace.GetTotalMs(EAITraceStage::Delivered));
+
+    Histograms[static_cast<int32>(EAILatencySpan::Dispatch)].Add(DispatchMs);
+    Histograms[static_cast<int32>(EAILatencySpan::Network)].Add(NetworkMs);
+    Histograms[static_cast<int32>(EAILatencySpan::JsonParse)].Add(JsonParseMs);
+    Histograms[static_cast<int32>(EAILatencySpan::ActionParse)].Add(ActionParseMs);
+    Histograms[static_cast<int32>(EAILatencySpan::Deliver)].Add(DeliverMs);
+    Histograms[static_cast<int32>(EAILatencySpan::Total)].Add(TotalMs);
+
+    CSV_CUSTOM_STAT(AIDM, DispatchMs, DispatchMs, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(AIDM, NetworkMs, NetworkMs, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(AIDM, JsonParseMs, JsonParseMs, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(AIDM, ActionParseMs, ActionParseMs, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(AIDM, DeliverMs, DeliverMs, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(AIDM, TotalMs, TotalMs, ECsvCustomStatOp::Set);
+
+    // SLO 확인 (p95가 목표를 넘기 시작할 때 한 번 세고, 돌아올 때까지의 시간을 누적)
+    const float TotalP95Ms = GetPercentile(EAILatencySpan::Total, 95.0f);
+    const bool bBreached = TotalSLOP95Ms > 0.0f && TotalP95Ms > TotalSLOP95Ms;
+    const double Now = FPlatformTime::Seconds();
+    if (bBreached && SLOBreachStartTime == 0.0)
+    {
+        SLOBreachCount++;
+        SLOBreachStartTime = Now;
+        UE_LOG(LogAIDM, Warning, TEXT("AI 응답 지연 SLO 초과 시작: p95 %.0f ms > %.0f ms (이번 요청 %.0f ms)"),
+            TotalP95Ms, TotalSLOP95Ms, TotalMs);
+    }
+    else if (!bBreached && SLOBreachStartTime > 0.0)
+    {
+        const double BreachSeconds = Now - SLOBreachStartTime;
+        CompletedBreachSeconds += BreachSeconds;
+        SLOBreachStartTime = 0.0;
+        UE_LOG(LogAIDM, Log, TEXT("AI 응답 지연 SLO 회복: p95 %.0f ms (초과 %.1f초 지속)"), TotalP95Ms, BreachSeconds);
+    }
+    CSV_CUSTOM_STAT(AIDM, SLOBreached, bBreached ? 1 : 0, ECsvCustomStatOp::Set);
+
+    PublishStats();
+}
+
+float FAILatencyTracker::GetPercentile(EAILatencySpan Span, float Percentile) const
+{
+    return Histograms[static_cast<int32>(Span)].GetPercentile(Percentile);
+}
+
+void FAILatencyTracker::PublishStats() const
+{
+    SET_FLOAT_STAT(STAT_AIDM_TotalP50, GetPercentile(EAILatencySpan::Total, 50.0f));
+    SET_FLOAT_STAT(STAT_AIDM_TotalP95, GetPercentile(EAILatencySpan::Total, 95.0f));
+    SET_FLOAT_STAT(STAT_AIDM_TotalP99, GetPercentile(EAILatencySpan::Total, 99.0f));
+    SET_FLOAT_STAT(STAT_AIDM_NetworkP50, GetPercentile(EAILatencySpan::Network, 50.0f));
+    SET_FLOAT_STAT(STAT_AIDM_NetworkP95, GetPercentile(EAILatencySpan::Network, 95.0f));
+    SET_FLOAT_STAT(STAT_AIDM_NetworkP99, GetPercentile(EAILatencySpan::Network, 99.0f));
+    SET_FLOAT_STAT(STAT_AIDM_DispatchP95, GetPercentile(EAILatencySpan::Dispatch, 95.0f));
+    SET_FLOAT_STAT(STAT_AIDM_JsonParseP95, GetPercentile(EAILatencySpan::JsonParse, 95.0f));
+    SET_FLOAT_STAT(STAT_AIDM_ActionParseP95, GetPercentile(EAILatencySpan::ActionParse, 95.0f));
+    SET_FLOAT_STAT(STAT_AIDM_DeliverP95, GetPercentile(EAILatencySpan::Deliver, 95.0f));
+    SET_DWORD_STAT(STAT_AIDM_Completed, Histograms[static_cast<int32>(EAILatencySpan::Total)].Num());
+    SET_DWORD_STAT(STAT_AIDM_SLOBreaches, SLOBreachCount);
+    SET_FLOAT_STAT(STAT_AIDM_SLOBreachSeconds, static_cast<float>(GetSLOBreachSeconds()));
+}
+
+double FAILatencyTracker::GetSLOBreachSeconds() const
+{
+    return CompletedBreachSeconds + (SLOBreachStartTime > 0.0 ? FPlatformTime::Seconds() - SLOBreachStartTime : 0.0);
+}
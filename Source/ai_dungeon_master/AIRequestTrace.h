@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+// 채팅 -> LLM -> 액션 파이프라인 전용 Insights 채널 (-trace=cpu,aidm)
+UE_TRACE_CHANNEL_EXTERN(AIDMChannel, AI_DUNGEON_MASTER_API)
+
+// stat aidm
+DECLARE_STATS_GROUP(TEXT("AIDM"), STATGROUP_AIDM, STATCAT_Advanced);
+
+// 파이프라인 단계 (요청 하나가 지나가는 순서)
+enum class EAITraceStage : uint8
+{
+    ChatSubmit,         // UChatWidget::SendCurrentMessage
+    Dispatch,           // AAIManager::SendMessage 진입
+    RequestSent,        // 요청 본문 생성 후 HTTP 전송
+    ResponseReceived,   // HTTP 완료
+    JsonParsed,         // 응답 JSON 파싱 완료
+    ActionsParsed,      // UAIActionParser::ParseAIResponse 완료
+    Delivered,          // 응답 브로드캐스트(AddAIMessage) 완료
+    Count
+};
+
+/**
+ * 요청 하나의 단계별 고해상도 타임스탬프
+ * 채팅 위젯에서 만들어 매니저, HTTP 콜백까지 값으로 전달된다.
+ */
+struct AI_DUNGEON_MASTER_API FAIRequestTrace
+{
+    FAIRequestTrace();
+
+    // 단계 도달 시각 기록
+    void Mark(EAITraceStage Stage);
+
+    bool HasStage(EAITraceStage Stage) const { return StageCycles[static_cast<int32>(Stage)] != 0; }
+
+    // 두 단계 사이 시간 (둘 중 하나라도 없으면 0)
+    double GetMs(EAITraceStage From, EAITraceStage To) const;
+
+    // 가장 먼저 기록된 단계부터 To까지
+    double GetTotalMs(EAITraceStage To) const;
+
+    // 고유 번호 (FAILatencyTracker::BeginRequest에서 부여, Insights 구간 이름에 사용)
+    int32 RequestId = 0;
+
+    uint64 StageCycles[static_cast<int32>(EAITraceStage::Count)];
+};
+
+/**
+ * 최근 N개 샘플의 롤링 백분위
+ */
+class AI_DUNGEON_MASTER_API FAILatencyHistogram
+{
+public:
+    explicit FAILatencyHistogram(int32 InCapacity = 512);
+
+    void Add(float ValueMs);
+
+    // 0~100 백분위 (샘플이 없으면 0)
+    float GetPercentile(float Percentile) const;
+
+    int32 Num() const { return Samples.Num(); }
+
+private:
+    TArray<float> Samples;
+    int32 Capacity;
+    int32 NextIndex = 0;
+};
+
+// 백분위 측정 구간
+enum class EAILatencySpan : uint8
+{
+    Dispatch,       // 채팅 입력 -> HTTP 전송 (프롬프트 조립 포함)
+    Network,        // HTTP 전송 -> 완료
+    JsonParse,      // 응답 JSON 파싱
+    ActionParse,    // 액션 파싱
+    Deliver,        // 브로드캐스트 및 채팅 표시
+    Total,          // 전체
+    Count
+};
+
+/**
+ * 완료된 요청 추적을 모아 p50/p95/p99를 계산하고 stat aidm, CSV 프로파일러, Insights로 내보낸다.
+ */
+class AI_DUNGEON_MASTER_API FAILatencyTracker
+{
+public:
+    // 요청 시작 (번호 부여, Insights 구간 열기)
+    void BeginRequest(FAIRequestTrace& Trace);
+
+    // 요청 완료 (성공한 요청만 백분위에 반영)
+    void CompleteRequest(const FAIRequestTrace& Trace, bool bSuccess);
+
+    float GetPercentile(EAILatencySpan Span, float Percentile) const;
+
+    // 전체 지연 SLO (p95 기준, 0이면 사용 안 함)
+    void SetTotalSLO(float InP95Ms) { TotalSLOP95Ms = InP95Ms; }
+
+    // p95가 SLO를 넘기 시작한 횟수 (초과가 이어지는 동안은 한 번)
+    int32 GetSLOBreachCount() const { return SLOBreachCount; }
+
+    // SLO를 넘은 상태로 있던 총 시간 (지금 초과 중이면 포함)
+    double GetSLOBreachSeconds() const;
+
+    int32 GetFailedCount() const { return FailedCount; }
+
+private:
+    static FString GetRegionName(int32 RequestId);
+    void PublishStats() const;
+
+    FAILatencyHistogram Histograms[static_cast<int32>(EAILatencySpan::Count)];
+    float TotalSLOP95Ms = 0.0f;
+    int32 LastRequestId = 0;
+    int32 SLOBreachCount = 0;
+    double SLOBreachStartTime = 0.0;    // 0이면 초과 중 아님
+    double CompletedBreachSeconds = 0.0;
+    int32 FailedCount = 0;
+};
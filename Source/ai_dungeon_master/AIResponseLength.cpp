@@ -0,0 +1,125 @@
+#include "AIResponseLength.h"
+
+namespace AIResponseLengthPrivate
+{
+    static constexpr float SmoothingAlpha = 0.2f;
+    static constexpr float MinScale = 0.3f;
+    static constexpr float MaxScale = 3.0f;
+
+    // 의도별 기본 배율 (묘사, 대화는 길게 / 이동, 인벤토리, 대기는 짧게)
+    static float GetDefaultScale(EActionType Intent)
+    {
+        switch (Intent)
+        {
+        case EActionType::Look:         return 1.5f;
+        case EActionType::Talk:         return 1.3f;
+        case EActionType::Cast:         return 1.1f;
+        case EActionType::Move:         return 0.8f;
+        case EActionType::UseItem:      return 0.8f;
+        case EActionType::Inventory:    return 0.6f;
+        case EActionType::Wait:         return 0.6f;
+        default:                        return 1.0f;
+        }
+    }
+
+    static void Smooth(float& Average, float Sample)
+    {
+        Average = Average > 0.0f ? FMath::Lerp(Average, Sample, SmoothingAlpha) : Sample;
+    }
+}
+
+using namespace AIResponseLengthPrivate;
+
+FAIResponseLengthController::FAIResponseLengthController()
+{
+    for (int32 Index = 0; Index < NumIntents; Index++)
+    {
+        Intents[Index].Scale = GetDefaultScale(static_cast<EActionType>(Index));
+    }
+}
+
+FAILengthDecision FAIResponseLengthController::Select(EActionType Intent, int32 BaseTokens) const
+{
+    FAILengthDecision Decision;
+    Decision.Intent = Intent;
+
+    float Tokens = BaseTokens * Intents[static_cast<int32>(Intent)].Scale;
+
+    // 목표 시간 안에 생성할 수 있는 만큼만
+    if (Settings.TargetLatencyMs > 0.0f)
+    {
+        if (StreamTokensPerSecond > 0.0f)
+        {
+            Tokens = FMath::Min(Tokens, FMath::Max(Settings.TargetLatencyMs - StreamFirstTokenMs, 0.0f) * StreamTokensPerSecond / 1000.0f);
+        }
+        else if (TotalTokensPerSecond > 0.0f)
+        {
+            Tokens = FMath::Min(Tokens, Settings.TargetLatencyMs * TotalTokensPerSecond / 1000.0f);
+        }
+    }
+
+    Decision.MaxTokens = FMath::Clamp(FMath::RoundToInt(Tokens), Settings.MinTokens, FMath::Max(Settings.MinTokens, Settings.MaxTokens));
+    return Decision;
+}
+
+void FAIResponseLengthController::Record(const FAILengthDecision& Decision, int32 CompletionTokens, const FString& FinishReason, float FirstChunkMs, float TotalMs)
+{
+    FIntentState& State = Intents[static_cast<int32>(Decision.Intent)];
+    State.Requests++;
+    Requests++;
+
+    if (Decision.MaxTokens > 0)
+    {
+        const float FillRatio = FMath::Min(static_cast<float>(CompletionTokens) / Decision.MaxTokens, 1.0f);
+        FillRatioSum += FillRatio;
+
+        // 잘렸으면 늘리고, 절반도 안 썼으면 조금씩 줄임
+        if (FinishReason == TEXT("length"))
+        {
+            State.Truncated++;
+            Truncated++;
+            State.Scale = FMath::Min(State.Scale * Settings.TruncationGrowth, MaxScale);
+        }
+        else if (FinishReason == TEXT("stop") && FillRatio < 0.5f)
+        {
+            State.Scale = FMath::Max(State.Scale * Settings.UnderfillShrink, MinScale);
+        }
+    }
+
+    // 생성 속도
+    if (CompletionTokens > 1 && FirstChunkMs >= 0.0f && TotalMs > FirstChunkMs + 1.0f)
+    {
+        Smooth(StreamTokensPerSecond, (CompletionTokens - 1) * 1000.0f / (TotalMs - FirstChunkMs));
+        Smooth(StreamFirstTokenMs, FirstChunkMs);
+    }
+    else if (CompletionTokens > 0 && TotalMs > 0.0f)
+    {
+        Smooth(TotalTokensPerSecond, CompletionTokens * 1000.0f / TotalMs);
+    }
+}
+
+FAIResponseLengthStats FAIResponseLengthController::GetStats() const
+{
+    FAIResponseLengthStats Stats;
+    Stats.Requests = Requests;
+    Stats.Truncated = Truncated;
+    Stats.TruncationRate = Requests > 0 ? static_cast<float>(Truncated) / Requests : 0.0f;
+    Stats.AverageFillRatio = Requests > 0 ? static_cast<float>(FillRatioSum / Requests) : 0.0f;
+    Stats.TokensPerSecond = StreamTokensPerSecond > 0.0f ? StreamTokensPerSecond : TotalTokensPerSecond;
+    Stats.FirstTokenMs = StreamFirstTokenMs;
+    return Stats;
+}
+
+FString FAIResponseLengthController::TrimToLastSentence(const FString& Text)
+{
+    for (int32 Index = Text.Len() - 1; Index >= Text.Len() / 2; Index--)
+    {
+        const TCHAR Char = Text[Index];
+        if (Char == TEXT('.') || Char == TEXT('!') || Char == TEXT('?') || Char == TEXT('"') || Char == TEXT(']') || Char == TEXT('*'))
+        {
+            // 문장 끝 뒤에 닫는 따옴표가 오는 경우 포함
+            return Text.Left(Index + 1);
+        }
+    }
+    return Text;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIActionParser.h"
+#include "AIResponseLength.generated.h"
+
+// 응답 길이 지표
+USTRUCT(BlueprintType)
+struct FAIResponseLengthStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Length")
+    int32 Requests = 0;
+
+    // finish_reason이 "length" (max_tokens에서 잘림)
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Length")
+    int32 Truncated = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Length")
+    float TruncationRate = 0.0f;
+
+    // 평균 응답 토큰 / max_tokens
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Length")
+    float AverageFillRatio = 0.0f;
+
+    // 스트리밍 첫 조각 이후 생성 속도 (스트리밍 기록이 없으면 전체 지연 기준)
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Length")
+    float TokensPerSecond = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Length")
+    float FirstTokenMs = 0.0f;
+};
+
+// 요청 하나에 정한 길이
+struct FAILengthDecision
+{
+    EActionType Intent = EActionType::Unknown;
+    int32 MaxTokens = 0;
+};
+
+// 길이 조절 설정
+struct FAIResponseLengthSettings
+{
+    int32 MinTokens = 32;
+    int32 MaxTokens = 400;
+    float TargetLatencyMs = 4000.0f;    // 응답 완료 목표 (0 = 속도 제한 없음)
+    float TruncationGrowth = 1.2f;      // 잘린 응답 뒤 그 의도의 배율 증가
+    float UnderfillShrink = 0.95f;      // 절반도 안 쓴 응답 뒤 배율 감소
+};
+
+/**
+ * 요청마다 max_tokens를 정하는 컨트롤러 (게임 스레드 전용)
+ * 기본 길이 x 의도별 배율을 최근 생성 속도로 응답 시간 목표 안에 끝나는 토큰 수로 제한한다.
+ * 잘린 응답(finish_reason "length")이 나온 의도는 배율을 늘리고, 한참 남긴 의도는 줄여 스스로 맞춘다.
+ */
+class AI_DUNGEON_MASTER_API FAIResponseLengthController
+{
+public:
+    FAIResponseLengthController();
+
+    void SetSettings(const FAIResponseLengthSettings& InSettings) { Settings = InSettings; }
+
+    FAILengthDecision Select(EActionType Intent, int32 BaseTokens) const;
+
+    // FirstChunkMs: 스트리밍이 아니면 음수
+    void Record(const FAILengthDecision& Decision, int32 CompletionTokens, const FString& FinishReason, float FirstChunkMs, float TotalMs);
+
+    FAIResponseLengthStats GetStats() const;
+
+    float GetIntentScale(EActionType Intent) const { return Intents[static_cast<int32>(Intent)].Scale; }
+
+    // 잘린 응답을 마지막 문장 끝까지 (절반 넘게 잘려 나가면 그대로)
+    static FString TrimToLastSentence(const FString& Text);
+
+private:
+    static constexpr int32 NumIntents = static_cast<int32>(EActionType::Wait) + 1;
+
+    struct FIntentState
+    {
+        float Scale = 1.0f;
+        int32 Requests = 0;
+        int32 Truncated = 0;
+    };
+
+    FAIResponseLengthSettings Settings;
+    FIntentState Intents[NumIntents];
+
+    int32 Requests = 0;
+    int32 Truncated = 0;
+    double FillRatioSum = 0.0;
+
+    // 최근 생성 속도 (지수 이동 평균, 0 = 기록 없음)
+    float StreamTokensPerSecond = 0.0f;
+    float StreamFirstTokenMs = 0.0f;
+    float TotalTokensPerSecond = 0.0f;  // 스트리밍이 아닐 때 (첫 토큰 지연 포함)
+};
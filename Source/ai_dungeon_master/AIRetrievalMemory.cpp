@@ -0,0 +1,192 @@
+#include "AIRetrievalMemory.h"
+#include "AISearchIndex.h"
+#include "Math/VectorRegister.h"
+#include "Misc/Crc.h"
+
+namespace AIEmbeddingFeature
+{
+    // 특징 종류별 해시 시드 (같은 문자열이라도 다른 버킷으로)
+    static constexpr uint32 WordSeed = 0x9E3779B9u;
+    static constexpr uint32 BigramSeed = 0x85EBCA6Bu;
+    static constexpr uint32 TrigramSeed = 0xC2B2AE35u;
+
+    static void Add(float* Embedding, uint32 Hash, float Weight)
+    {
+        // 하위 비트로 버킷, 최상위 비트로 부호 결정 (해시 충돌 상쇄)
+        const int32 Bucket = static_cast<int32>(Hash % FAIHashedEmbedder::Dimension);
+        Embedding[Bucket] += (Hash & 0x80000000u) ? -Weight : Weight;
+    }
+}
+
+void FAIHashedEmbedder::Embed(const FString& Text, float* OutEmbedding)
+{
+    using namespace AIEmbeddingFeature;
+
+    FMemory::Memzero(OutEmbedding, Dimension * sizeof(float));
+
+    TArray<FString> Tokens;
+    FAISearchIndexCore::Tokenize(Text, Tokens);
+
+    for (int32 i = 0; i < Tokens.Num(); i++)
+    {
+        const FString& Token = Tokens[i];
+        const TCHAR* Chars = *Token;
+        const int32 Len = Token.Len();
+
+        // 단어
+        Add(OutEmbedding, FCrc::MemCrc32(Chars, Len * sizeof(TCHAR), WordSeed), 1.0f);
+
+        // 단어 bigram
+        if (i + 1 < Tokens.Num())
+        {
+            const uint32 FirstHash = FCrc::MemCrc32(Chars, Len * sizeof(TCHAR), BigramSeed);
+            Add(OutEmbedding, FCrc::MemCrc32(*Tokens[i + 1], Tokens[i + 1].Len() * sizeof(TCHAR), FirstHash), 0.7f);
+        }
+
+        // 문자 trigram (철자 변형, 복수형 등에 강함)
+        for (int32 Start = 0; Start + 3 <= Len; Start++)
+        {
+            Add(OutEmbedding, FCrc::MemCrc32(Chars + Start, 3 * sizeof(TCHAR), TrigramSeed), 0.5f);
+        }
+    }
+
+    // L2 정규화 (내적 = 코사인 유사도)
+    const float Norm = FMath::Sqrt(Dot(OutEmbedding, OutEmbedding));
+    if (Norm > UE_SMALL_NUMBER)
+    {
+        const float InvNorm = 1.0f / Norm;
+        for (int32 i = 0; i < Dimension; i++)
+        {
+            OutEmbedding[i] *= InvNorm;
+        }
+    }
+}
+
+float FAIHashedEmbedder::Dot(const float* A, const float* B)
+{
+    static_assert(Dimension % 8 == 0, "Dimension must be a multiple of 8");
+
+    VectorRegister4Float Sum0 = VectorZeroFloat();
+    VectorRegister4Float Sum1 = VectorZeroFloat();
+    for (int32 i = 0; i < Dimension; i += 8)
+    {
+        Sum0 = VectorMultiplyAdd(VectorLoadAligned(A + i), VectorLoadAligned(B + i), Sum0);
+        Sum1 = VectorMultiplyAdd(VectorLoadAligned(A + i + 4), VectorLoadAligned(B + i + 4), Sum1);
+    }
+
+    alignas(16) float Lanes[4];
+    VectorStoreAligned(VectorAdd(Sum0, Sum1), Lanes);
+    return Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+}
+
+// ---------------------------------------------------------------------------
+// FAIRetrievalMemoryCore
+// ---------------------------------------------------------------------------
+
+void FAIRetrievalMemoryCore::AddTurn(const FString& PlayerText, const FString& DMText)
+{
+    FString Text = FString::Printf(TEXT("Player: %s\nDM: %s"), *PlayerText, *DMText);
+
+    const int32 Offset = Embeddings.AddUninitialized(FAIHashedEmbedder::Dimension);
+    FAIHashedEmbedder::Embed(Text, Embeddings.GetData() + Offset);
+    Texts.Add(MoveTemp(Text));
+}
+
+void FAIRetrievalMemoryCore::Recall(const FString& Query, int32 TopK, float MinScore, int32 ExcludeRecent, TArray<FAIMemoryHit>& OutHits) const
+{
+    OutHits.Reset();
+
+    const int32 NumCandidates = Texts.Num() - FMath::Max(0, ExcludeRecent);
+    if (NumCandidates <= 0 || TopK <= 0)
+    {
+        return;
+    }
+
+    alignas(16) float QueryEmbedding[FAIHashedEmbedder::Dimension];
+    FAIHashedEmbedder::Embed(Query, QueryEmbedding);
+
+    // 전수 내적 + 상위 TopK 최소 힙
+    typedef TPair<float, int32> FScoredTurn;
+    auto MinScoreFirst = [](const FScoredTurn& A, const FScoredTurn& B) { return A.Key < B.Key; };
+    TArray<FScoredTurn, TInlineAllocator<16>> Heap;
+
+    const float* Row = Embeddings.GetData();
+    for (int32 TurnIndex = 0; TurnIndex < NumCandidates; TurnIndex++, Row += FAIHashedEmbedder::Dimension)
+    {
+        const float Score = FAIHashedEmbedder::Dot(QueryEmbedding, Row);
+        if (Score < MinScore)
+        {
+            continue;
+        }
+
+        if (Heap.Num() < TopK)
+        {
+            Heap.HeapPush(FScoredTurn(Score, TurnIndex), MinScoreFirst);
+        }
+        else if (Score > Heap.HeapTop().Key)
+        {
+            Heap.HeapPopDiscard(MinScoreFirst, EAllowShrinking::No);
+            Heap.HeapPush(FScoredTurn(Score, TurnIndex), MinScoreFirst);
+        }
+    }
+
+    // 요청에는 시간 순서대로 넣는다
+    Heap.Sort([](const FScoredTurn& A, const FScoredTurn& B) { return A.Value < B.Value; });
+
+    for (const FScoredTurn& Scored : Heap)
+    {
+        FAIMemoryHit& Hit = OutHits.AddDefaulted_GetRef();
+        Hit.TurnIndex = Scored.Value;
+        Hit.Score = Scored.Key;
+        Hit.Text = Texts[Scored.Value];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// UAIRetrievalMemory
+// ---------------------------------------------------------------------------
+
+UAIRetrievalMemory::UAIRetrievalMemory()
+{
+    Core = MakeShared<FAIRetrievalMemoryCore>();
+}
+
+void UAIRetrievalMemory::AddTurn(const FString& PlayerText, const FString& DMText)
+{
+    if (bBuilding)
+    {
+        PendingTurns.Emplace(PlayerText, DMText);
+    }
+
+    Core->AddTurn(PlayerText, DMText);
+}
+
+TArray<FAIMemoryHit> UAIRetrievalMemory::Recall(const FString& Query, int32 TopK, float MinScore, int32 ExcludeRecent) const
+{
+    TArray<FAIMemoryHit> Hits;
+    Core->Recall(Query, TopK, MinScore, ExcludeRecent, Hits);
+    return Hits;
+}
+
+int32 UAIRetrievalMemory::GetNumTurns() const
+{
+    return Core->Num();
+}
+
+void UAIRetrievalMemory::BeginBackgroundBuild()
+{
+    bBuilding = true;
+    PendingTurns.Reset();
+}
+
+void UAIRetrievalMemory::CompleteBackgroundBuild(TSharedPtr<FAIRetrievalMemoryCore> BuiltCore)
+{
+    for (const TPair<FString, FString>& Turn : PendingTurns)
+    {
+        BuiltCore->AddTurn(Turn.Key, Turn.Value);
+    }
+
+    PendingTurns.Reset();
+    Core = BuiltCore;
+    bBuilding = false;
+}
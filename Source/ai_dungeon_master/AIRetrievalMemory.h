@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AIRetrievalMemory.generated.h"
+
+// 회상된 기억 구조체
+USTRUCT(BlueprintType)
+struct FAIMemoryHit
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 TurnIndex = INDEX_NONE;   // 턴 번호 (오래된 순)
+
+    UPROPERTY(BlueprintReadOnly)
+    float Score = 0.0f;             // 코사인 유사도
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Text;                   // "Player: ... / DM: ..." 형식의 턴 본문
+};
+
+/**
+ * 해시 n-gram 임베딩 (CPU 전용, 모델 파일 불필요)
+ * 단어, 단어 bigram, 문자 trigram을 고정 차원으로 해싱한 뒤 L2 정규화한다.
+ */
+struct AI_DUNGEON_MASTER_API FAIHashedEmbedder
+{
+    static constexpr int32 Dimension = 256;
+
+    // OutEmbedding은 Dimension개의 float (16바이트 정렬)
+    static void Embed(const FString& Text, float* OutEmbedding);
+
+    // 16바이트 정렬된 두 벡터의 내적 (SIMD)
+    static float Dot(const float* A, const float* B);
+};
+
+/**
+ * 임베딩 기억 저장소 코어 (UObject와 무관하므로 백그라운드 스레드에서 생성 가능)
+ * 턴별 임베딩을 하나의 평평한 정렬 float 배열에 저장하고 전수 SIMD 내적으로 검색한다.
+ */
+class AI_DUNGEON_MASTER_API FAIRetrievalMemoryCore
+{
+public:
+    // 턴 추가 (플레이어 입력 + DM 응답)
+    void AddTurn(const FString& PlayerText, const FString& DMText);
+
+    // 질의와 가장 비슷한 TopK개의 턴 (마지막 ExcludeRecent개 턴은 제외)
+    void Recall(const FString& Query, int32 TopK, float MinScore, int32 ExcludeRecent, TArray<FAIMemoryHit>& OutHits) const;
+
+    int32 Num() const { return Texts.Num(); }
+
+private:
+    TArray<float, TAlignedHeapAllocator<16>> Embeddings;   // Num * Dimension
+    TArray<FString> Texts;
+};
+
+/**
+ * 장기 캠페인용 검색 기억 모듈
+ * 오래된 턴을 모두 보내지 않고, 현재 입력과 관련된 턴만 골라 요청에 넣는다.
+ */
+UCLASS(BlueprintType)
+class AI_DUNGEON_MASTER_API UAIRetrievalMemory : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UAIRetrievalMemory();
+
+    // 턴 추가
+    UFUNCTION(BlueprintCallable, Category = "AI|Memory")
+    void AddTurn(const FString& PlayerText, const FString& DMText);
+
+    // 관련 기억 검색
+    UFUNCTION(BlueprintCallable, Category = "AI|Memory")
+    TArray<FAIMemoryHit> Recall(const FString& Query, int32 TopK = 3, float MinScore = 0.25f, int32 ExcludeRecent = 0) const;
+
+    // 저장된 턴 수
+    UFUNCTION(BlueprintPure, Category = "AI|Memory")
+    int32 GetNumTurns() const;
+
+    // 백그라운드 생성 시작 (이후 추가되는 턴은 완료 시 덧붙임)
+    void BeginBackgroundBuild();
+
+    // 백그라운드에서 만든 코어로 교체 (게임 스레드)
+    void CompleteBackgroundBuild(TSharedPtr<FAIRetrievalMemoryCore> BuiltCore);
+
+private:
+    TSharedPtr<FAIRetrievalMemoryCore> Core;
+
+    // 생성 중에 추가된 턴
+    TArray<TPair<FString, FString>> PendingTurns;
+
+    bool bBuilding = false;
+};
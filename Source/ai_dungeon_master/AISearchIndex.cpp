@@ -0,0 +1,259 @@
+#include "AISearchIndex.h"
+
+namespace AISearchVarint
+{
+    static void Write(TArray<uint8>& Bytes, uint32 Value)
+    {
+        while (Value >= 0x80)
+        {
+            Bytes.Add(static_cast<uint8>(Value | 0x80));
+            Value >>= 7;
+        }
+        Bytes.Add(static_cast<uint8>(Value));
+    }
+
+    static uint32 Read(const uint8*& Ptr)
+    {
+        uint32 Value = 0;
+        uint32 Shift = 0;
+        uint8 Byte;
+        do
+        {
+            Byte = *Ptr++;
+            Value |= static_cast<uint32>(Byte & 0x7F) << Shift;
+            Shift += 7;
+        } while (Byte & 0x80);
+        return Value;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// FAISearchIndexCore
+// ---------------------------------------------------------------------------
+
+void FAISearchIndexCore::Tokenize(const FString& Text, TArray<FString>& OutTokens)
+{
+    OutTokens.Reset();
+
+    FString Current;
+    auto FlushToken = [&Current, &OutTokens]()
+    {
+        // 한 글자짜리 영문/숫자 토큰은 제외 (한글 등은 유지)
+        if (Current.Len() > 1 || (Current.Len() == 1 && Current[0] > 0x7F))
+        {
+            OutTokens.Add(Current);
+        }
+        Current.Reset();
+    };
+
+    for (const TCHAR Char : Text)
+    {
+        if (FChar::IsAlnum(Char))
+        {
+            Current.AppendChar(FChar::ToLower(Char));
+        }
+        else if (!Current.IsEmpty())
+        {
+            FlushToken();
+        }
+    }
+
+    if (!Current.IsEmpty())
+    {
+        FlushToken();
+    }
+}
+
+int32 FAISearchIndexCore::AddDocument(const FString& Text, EAISessionRecordType RecordType, const FDateTime& Timestamp)
+{
+    const int32 DocId = Documents.Num();
+
+    TArray<FString> Tokens;
+    Tokenize(Text, Tokens);
+
+    // 문서 내 토큰 빈도 계산
+    TMap<FString, uint32> TermFrequencies;
+    for (const FString& Token : Tokens)
+    {
+        TermFrequencies.FindOrAdd(Token)++;
+    }
+
+    for (const TPair<FString, uint32>& Pair : TermFrequencies)
+    {
+        FPostingList& List = Postings.FindOrAdd(Pair.Key);
+        AISearchVarint::Write(List.Bytes, static_cast<uint32>(DocId - List.LastDocId));
+        AISearchVarint::Write(List.Bytes, Pair.Value);
+        List.LastDocId = DocId;
+        List.DocFrequency++;
+    }
+
+    FDocument& Document = Documents.AddDefaulted_GetRef();
+    Document.Text = Text;
+    Document.Timestamp = Timestamp;
+    Document.RecordType = RecordType;
+    Document.Length = Tokens.Num();
+    TotalLength += Tokens.Num();
+
+    return DocId;
+}
+
+void FAISearchIndexCore::Search(const FString& Query, int32 MaxResults, TArray<FAISearchHit>& OutHits) const
+{
+    OutHits.Reset();
+
+    const int32 NumDocs = Documents.Num();
+    if (NumDocs == 0 || MaxResults <= 0)
+    {
+        return;
+    }
+
+    TArray<FString> QueryTokens;
+    Tokenize(Query, QueryTokens);
+
+    // BM25 매개변수
+    const float K1 = 1.2f;
+    const float B = 0.75f;
+    const float AvgLength = FMath::Max(1.0f, static_cast<float>(TotalLength) / NumDocs);
+
+    // 점수 누적 버퍼 (건드린 문서만 초기화)
+    if (ScratchScores.Num() < NumDocs)
+    {
+        ScratchScores.SetNumZeroed(NumDocs);
+    }
+    ScratchTouched.Reset();
+
+    TSet<FString> SeenTokens;
+    for (const FString& Token : QueryTokens)
+    {
+        bool bAlreadySeen = false;
+        SeenTokens.Add(Token, &bAlreadySeen);
+        if (bAlreadySeen)
+        {
+            continue;
+        }
+
+        const FPostingList* List = Postings.Find(Token);
+        if (!List)
+        {
+            continue;
+        }
+
+        const float Idf = FMath::Loge(1.0f + (NumDocs - List->DocFrequency + 0.5f) / (List->DocFrequency + 0.5f));
+
+        // 포스팅 디코딩
+        const uint8* Ptr = List->Bytes.GetData();
+        const uint8* End = Ptr + List->Bytes.Num();
+        int32 DocId = -1;
+        while (Ptr < End)
+        {
+            DocId += static_cast<int32>(AISearchVarint::Read(Ptr));
+            const float Tf = static_cast<float>(AISearchVarint::Read(Ptr));
+            const float Norm = K1 * (1.0f - B + B * Documents[DocId].Length / AvgLength);
+
+            if (ScratchScores[DocId] == 0.0f)
+            {
+                ScratchTouched.Add(DocId);
+            }
+            ScratchScores[DocId] += Idf * (Tf * (K1 + 1.0f)) / (Tf + Norm);
+        }
+    }
+
+    // 상위 MaxResults개 선택 (최소 힙)
+    auto MinScoreFirst = [this](int32 A, int32 C) { return ScratchScores[A] < ScratchScores[C]; };
+    TArray<int32> Heap;
+    Heap.Reserve(MaxResults + 1);
+    for (const int32 DocId : ScratchTouched)
+    {
+        if (Heap.Num() < MaxResults)
+        {
+            Heap.HeapPush(DocId, MinScoreFirst);
+        }
+        else if (ScratchScores[DocId] > ScratchScores[Heap.HeapTop()])
+        {
+            int32 Removed;
+            Heap.HeapPop(Removed, MinScoreFirst, EAllowShrinking::No);
+            Heap.HeapPush(DocId, MinScoreFirst);
+        }
+    }
+
+    // 점수 높은 순 (동점이면 최신 메시지 우선)
+    Heap.Sort([this](int32 A, int32 C)
+    {
+        return ScratchScores[A] != ScratchScores[C] ? ScratchScores[A] > ScratchScores[C] : A > C;
+    });
+
+    for (const int32 DocId : Heap)
+    {
+        const FDocument& Document = Documents[DocId];
+        FAISearchHit& Hit = OutHits.AddDefaulted_GetRef();
+        Hit.MessageId = DocId;
+        Hit.Score = ScratchScores[DocId];
+        Hit.RecordType = Document.RecordType;
+        Hit.Timestamp = Document.Timestamp;
+        Hit.Text = Document.Text;
+    }
+
+    for (const int32 DocId : ScratchTouched)
+    {
+        ScratchScores[DocId] = 0.0f;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// UAISearchIndex
+// ---------------------------------------------------------------------------
+
+UAISearchIndex::UAISearchIndex()
+{
+    Core = MakeShared<FAISearchIndexCore>();
+}
+
+void UAISearchIndex::AddMessage(const FString& Text, EAISessionRecordType RecordType, const FDateTime& Timestamp)
+{
+    if (Text.IsEmpty())
+    {
+        return;
+    }
+
+    if (bBuilding)
+    {
+        // 백그라운드 색인이 끝난 뒤 순서대로 덧붙임
+        FAISessionRecord& Record = PendingRecords.AddDefaulted_GetRef();
+        Record.RecordType = RecordType;
+        Record.Timestamp = Timestamp;
+        Record.Text = Text;
+    }
+
+    Core->AddDocument(Text, RecordType, Timestamp);
+}
+
+TArray<FAISearchHit> UAISearchIndex::Search(const FString& Query, int32 MaxResults) const
+{
+    TArray<FAISearchHit> Hits;
+    Core->Search(Query, MaxResults, Hits);
+    return Hits;
+}
+
+int32 UAISearchIndex::GetNumMessages() const
+{
+    return Core->Num();
+}
+
+void UAISearchIndex::BeginBackgroundBuild()
+{
+    bBuilding = true;
+    PendingRecords.Reset();
+}
+
+void UAISearchIndex::CompleteBackgroundBuild(TSharedPtr<FAISearchIndexCore> BuiltCore)
+{
+    // 색인 중에 들어온 메시지를 이어 붙이고 교체
+    for (const FAISessionRecord& Record : PendingRecords)
+    {
+        BuiltCore->AddDocument(Record.Text, Record.RecordType, Record.Timestamp);
+    }
+
+    PendingRecords.Reset();
+    Core = BuiltCore;
+    bBuilding = false;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "AISessionLog.h"
+#include "AISearchIndex.generated.h"
+
+// 검색 결과 구조체
+USTRUCT(BlueprintType)
+struct FAISearchHit
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 MessageId = INDEX_NONE;                                           // 메시지 번호 (추가 순서)
+
+    UPROPERTY(BlueprintReadOnly)
+    float Score = 0.0f;                                                     // BM25 점수
+
+    UPROPERTY(BlueprintReadOnly)
+    EAISessionRecordType RecordType = EAISessionRecordType::UserMessage;   // 플레이어 입력 / AI 응답
+
+    UPROPERTY(BlueprintReadOnly)
+    FDateTime Timestamp;                                                    // 메시지 시각
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Text;                                                           // 메시지 본문
+};
+
+/**
+ * 역색인 코어 (UObject와 무관하므로 백그라운드 스레드에서 생성 가능)
+ * 토큰 -> 포스팅 리스트. 포스팅은 [문서 번호 차이][토큰 빈도]를 varint로 압축해 저장한다.
+ * 문서 번호는 항상 증가하므로 메시지를 추가할 때마다 리스트 끝에 덧붙이기만 하면 된다.
+ */
+class AI_DUNGEON_MASTER_API FAISearchIndexCore
+{
+public:
+    // 메시지 추가, 메시지 번호 반환
+    int32 AddDocument(const FString& Text, EAISessionRecordType RecordType, const FDateTime& Timestamp);
+
+    // BM25 순위 검색
+    void Search(const FString& Query, int32 MaxResults, TArray<FAISearchHit>& OutHits) const;
+
+    int32 Num() const { return Documents.Num(); }
+
+    // 소문자 영숫자 토큰으로 분리
+    static void Tokenize(const FString& Text, TArray<FString>& OutTokens);
+
+private:
+    struct FDocument
+    {
+        FString Text;
+        FDateTime Timestamp;
+        EAISessionRecordType RecordType;
+        int32 Length;
+    };
+
+    struct FPostingList
+    {
+        TArray<uint8> Bytes;        // varint 압축 포스팅
+        int32 LastDocId = -1;       // 마지막 문서 번호 (차이 계산용)
+        int32 DocFrequency = 0;     // 토큰이 포함된 문서 수
+    };
+
+    TArray<FDocument> Documents;
+    TMap<FString, FPostingList> Postings;
+    int64 TotalLength = 0;
+
+    // 검색용 임시 버퍼 (게임 스레드 전용)
+    mutable TArray<float> ScratchScores;
+    mutable TArray<int32> ScratchTouched;
+};
+
+/**
+ * 채팅/세션 기록 전문 검색 인덱스
+ * 메시지가 추가될 때마다 점진적으로 갱신되며, 시작 시 세션 로그 전체는 백그라운드에서 색인한 코어로 교체한다.
+ */
+UCLASS(BlueprintType)
+class AI_DUNGEON_MASTER_API UAISearchIndex : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    UAISearchIndex();
+
+    // 메시지 추가 (색인 즉시 갱신)
+    UFUNCTION(BlueprintCallable, Category = "AI|Search")
+    void AddMessage(const FString& Text, EAISessionRecordType RecordType, const FDateTime& Timestamp);
+
+    // 순위 검색 ("when did the DM mention the amulet?")
+    UFUNCTION(BlueprintCallable, Category = "AI|Search")
+    TArray<FAISearchHit> Search(const FString& Query, int32 MaxResults = 10) const;
+
+    // 색인된 메시지 수
+    UFUNCTION(BlueprintPure, Category = "AI|Search")
+    int32 GetNumMessages() const;
+
+    // 백그라운드 색인 진행 여부
+    UFUNCTION(BlueprintPure, Category = "AI|Search")
+    bool IsBuilding() const { return bBuilding; }
+
+    // 백그라운드 색인 시작 (이후 추가되는 메시지는 완료 시 덧붙임)
+    void BeginBackgroundBuild();
+
+    // 백그라운드에서 만든 코어로 교체 (게임 스레드)
+    void CompleteBackgroundBuild(TSharedPtr<FAISearchIndexCore> BuiltCore);
+
+private:
+    TSharedPtr<FAISearchIndexCore> Core;
+
+    // 색인 중에 추가된 메시지 (완료 후 덧붙임)
+    TArray<FAISessionRecord> PendingRecords;
+
+    bool bBuilding = false;
+};
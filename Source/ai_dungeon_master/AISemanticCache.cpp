@@ -0,0 +1,122 @@
+#include "AISemanticCache.h"
+
+FAISemanticCache::FAISemanticCache(int32 InCapacity)
+    : Capacity(FMath::Max(InCapacity, 1))
+{
+    Entries.SetNum(Capacity);
+    Embeddings.SetNumZeroed(Capacity * FAIHashedEmbedder::Dimension);
+}
+
+bool FAISemanticCache::Find(FName SessionId, int32 SceneVersion, const FString& Input, float MinScore, FAISemanticCacheHit& OutHit)
+{
+    Stats.Lookups++;
+
+    alignas(16) float Query[FAIHashedEmbedder::Dimension];
+    FAIHashedEmbedder::Embed(Input, Query);
+
+    int32 BestSlot = INDEX_NONE;
+    float BestScore = MinScore;
+    for (int32 Slot = 0; Slot < Capacity; Slot++)
+    {
+        const FEntry& Entry = Entries[Slot];
+        if (Entry.Id == INDEX_NONE || Entry.SceneVersion != SceneVersion || Entry.SessionId != SessionId)
+        {
+            continue;
+        }
+
+        const float Score = FAIHashedEmbedder::Dot(Query, GetEmbedding(Slot));
+        if (Score >= BestScore)
+        {
+            BestScore = Score;
+            BestSlot = Slot;
+        }
+    }
+
+    if (BestSlot == INDEX_NONE)
+    {
+        return false;
+    }
+
+    const FEntry& Best = Entries[BestSlot];
+    OutHit.EntryId = Best.Id;
+    OutHit.Score = BestScore;
+    OutHit.Input = Best.Input;
+    OutHit.Response = Best.Response;
+    Stats.Hits++;
+    return true;
+}
+
+void FAISemanticCache::Store(FName SessionId, int32 SceneVersion, const FString& Input, const FString& Response)
+{
+    int32 Slot = Entries.IndexOfByPredicate([&](const FEntry& Entry)
+    {
+        return Entry.Id != INDEX_NONE && Entry.SceneVersion == SceneVersion && Entry.SessionId == SessionId && Entry.Input == Input;
+    });
+
+    // 덮어쓸 때는 번호 유지 (진행 중인 검증이 이 항목을 계속 찾을 수 있게)
+    if (Slot == INDEX_NONE)
+    {
+        Slot = NextSlot;
+        NextSlot = (NextSlot + 1) % Capacity;
+        FAIHashedEmbedder::Embed(Input, GetEmbedding(Slot));
+        Entries[Slot].Id = ++LastEntryId;
+    }
+
+    FEntry& Entry = Entries[Slot];
+    Entry.SessionId = SessionId;
+    Entry.SceneVersion = SceneVersion;
+    Entry.Input = Input;
+    Entry.Response = Response;
+}
+
+bool FAISemanticCache::Verify(int32 EntryId, const FString& ModelResponse, float MinScore)
+{
+    const int32 Slot = EntryId != INDEX_NONE ? FindSlot(EntryId) : INDEX_NONE;
+    if (Slot == INDEX_NONE)
+    {
+        return false;
+    }
+
+    alignas(16) float Cached[FAIHashedEmbedder::Dimension];
+    alignas(16) float Fresh[FAIHashedEmbedder::Dimension];
+    FAIHashedEmbedder::Embed(Entries[Slot].Response, Cached);
+    FAIHashedEmbedder::Embed(ModelResponse, Fresh);
+
+    Stats.Verified++;
+    if (FAIHashedEmbedder::Dot(Cached, Fresh) >= MinScore)
+    {
+        return false;
+    }
+
+    Stats.FalseHits++;
+    Entries[Slot] = FEntry();
+    return true;
+}
+
+void FAISemanticCache::RemoveSession(FName SessionId)
+{
+    for (FEntry& Entry : Entries)
+    {
+        if (Entry.SessionId == SessionId)
+        {
+            Entry = FEntry();
+        }
+    }
+}
+
+int32 FAISemanticCache::FindSlot(int32 EntryId) const
+{
+    return Entries.IndexOfByPredicate([EntryId](const FEntry& Entry) { return Entry.Id == EntryId; });
+}
+
+FAISemanticCacheStats FAISemanticCache::GetStats() const
+{
+    FAISemanticCacheStats Result = Stats;
+    for (const FEntry& Entry : Entries)
+    {
+        Result.Entries += Entry.Id != INDEX_NONE ? 1 : 0;
+    }
+    Result.HitRate = Result.Lookups > 0 ? static_cast<float>(Result.Hits) / Result.Lookups : 0.0f;
+    Result.FalseHitRate = Result.Verified > 0 ? static_cast<float>(Result.FalseHits) / Result.Verified : 0.0f;
+    return Result;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIRetrievalMemory.h"
+#include "AISemanticCache.generated.h"
+
+// 의미 캐시 지표
+USTRUCT(BlueprintType)
+struct FAISemanticCacheStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Cache")
+    int32 Entries = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Cache")
+    int32 Lookups = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Cache")
+    int32 Hits = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Cache")
+    float HitRate = 0.0f;
+
+    // 적중 중 모델 응답과 비교해 본 수, 그중 모델 응답과 너무 달랐던 수
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Cache")
+    int32 Verified = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Cache")
+    int32 FalseHits = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|Cache")
+    float FalseHitRate = 0.0f;
+};
+
+// 캐시 적중 하나
+struct FAISemanticCacheHit
+{
+    int32 EntryId = INDEX_NONE;
+    float Score = 0.0f;
+    FString Input;
+    FString Response;
+};
+
+/**
+ * 비슷한 플레이어 입력에 같은 응답을 재사용하는 의미 캐시 (게임 스레드 전용)
+ * 정규화된 입력을 해시 n-gram 임베딩으로 바꿔 최근 Capacity개 항목과 전수 SIMD 내적으로 비교하고,
+ * 같은 세션, 같은 장면 버전의 항목 중 가장 비슷한 것이 MinScore 이상이면 적중으로 본다.
+ * 가득 차면 가장 오래된 항목부터 덮어쓴다.
+ */
+class AI_DUNGEON_MASTER_API FAISemanticCache
+{
+public:
+    explicit FAISemanticCache(int32 InCapacity = 256);
+
+    // Input은 정규화된 입력 (UAIIntentRouter::MakeMatchKey)
+    bool Find(FName SessionId, int32 SceneVersion, const FString& Input, float MinScore, FAISemanticCacheHit& OutHit);
+
+    // 같은 세션/장면에 같은 입력이 있으면 응답만 바꿈 (항목 번호 유지)
+    void Store(FName SessionId, int32 SceneVersion, const FString& Input, const FString& Response);
+
+    // 적중 항목의 응답을 새 모델 응답과 비교 (MinScore 미만이면 잘못된 적중으로 보고 제거, 제거하면 true)
+    bool Verify(int32 EntryId, const FString& ModelResponse, float MinScore);
+
+    void RemoveSession(FName SessionId);
+
+    FAISemanticCacheStats GetStats() const;
+
+private:
+    struct FEntry
+    {
+        int32 Id = INDEX_NONE;      // INDEX_NONE = 빈 칸
+        FName SessionId;
+        int32 SceneVersion = 0;
+        FString Input;
+        FString Response;
+    };
+
+    int32 FindSlot(int32 EntryId) const;
+    float* GetEmbedding(int32 Slot) { return Embeddings.GetData() + Slot * FAIHashedEmbedder::Dimension; }
+
+    int32 Capacity = 0;
+    TArray<FEntry> Entries;
+    TArray<float, TAlignedHeapAllocator<16>> Embeddings;   // Capacity * Dimension
+    int32 NextSlot = 0;
+    int32 LastEntryId = 0;
+
+    FAISemanticCacheStats Stats;
+};
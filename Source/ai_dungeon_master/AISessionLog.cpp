@@ -0,0 +1,402 @@
+#include "AISessionLog.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "Async/MappedFileHandle.h"
+#include "Algo/Reverse.h"
+#include "Misc/Crc.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "AIDMLog.h"
+
+namespace AISessionLogFormat
+{
+    // 파일 헤더
+    static const uint8 Magic[8] = { 'A', 'I', 'D', 'M', 'L', 'O', 'G', '1' };
+    static constexpr int64 HeaderSize = 8;
+
+    // [Size][Crc] + [Size] 트레일러
+    static constexpr int64 FrameOverhead = 12;
+
+    // [Type][Ticks][DurationMs]
+    static constexpr uint32 PayloadFixedSize = 1 + 8 + 4;
+
+    // 너무 큰 길이 값은 손상으로 간주
+    static constexpr uint32 MaxPayloadSize = 16 * 1024 * 1024;
+
+    static uint32 ReadU32(const uint8* Ptr)
+    {
+        uint32 Value;
+        FMemory::Memcpy(&Value, Ptr, sizeof(Value));
+        return Value;
+    }
+
+    // Offset에서 시작하는 프레임 검증, 성공 시 다음 프레임 오프셋 반환
+    static bool ReadFrameAt(const uint8* Data, int64 Size, int64 Offset, int64& OutNext, const uint8*& OutPayload, uint32& OutPayloadSize)
+    {
+        if (Offset + FrameOverhead > Size)
+        {
+            return false;
+        }
+
+        const uint32 PayloadSize = ReadU32(Data + Offset);
+        if (PayloadSize < PayloadFixedSize || PayloadSize > MaxPayloadSize || Offset + FrameOverhead + PayloadSize > Size)
+        {
+            return false;
+        }
+
+        const uint8* Payload = Data + Offset + 8;
+        if (ReadU32(Payload + PayloadSize) != PayloadSize || ReadU32(Data + Offset + 4) != FCrc::MemCrc32(Payload, PayloadSize))
+        {
+            return false;
+        }
+
+        OutNext = Offset + FrameOverhead + PayloadSize;
+        OutPayload = Payload;
+        OutPayloadSize = PayloadSize;
+        return true;
+    }
+
+    // EndOffset에서 끝나는 프레임 검증 (역방향 탐색용)
+    static bool ReadFrameEndingAt(const uint8* Data, int64 EndOffset, int64& OutStart, const uint8*& OutPayload, uint32& OutPayloadSize)
+    {
+        if (EndOffset - HeaderSize < FrameOverhead)
+        {
+            return false;
+        }
+
+        const uint32 PayloadSize = ReadU32(Data + EndOffset - 4);
+        if (PayloadSize < PayloadFixedSize || PayloadSize > MaxPayloadSize || EndOffset - HeaderSize < FrameOverhead + PayloadSize)
+        {
+            return false;
+        }
+
+        const int64 Start = EndOffset - FrameOverhead - PayloadSize;
+        int64 Next = 0;
+        if (!ReadFrameAt(Data, EndOffset, Start, Next, OutPayload, OutPayloadSize) || Next != EndOffset)
+        {
+            return false;
+        }
+
+        OutStart = Start;
+        return true;
+    }
+}
+
+FAISessionLog::FAISessionLog()
+    : bStopRequested(false)
+{
+}
+
+FAISessionLog::~FAISessionLog()
+{
+    Close();
+}
+
+FString FAISessionLog::GetDefaultLogPath()
+{
+    return FPaths::ProjectSavedDir() / TEXT("AIDM") / TEXT("Session.aidmlog");
+}
+
+bool FAISessionLog::Open(const FString& InFilePath)
+{
+    using namespace AISessionLogFormat;
+
+    if (IsOpen())
+    {
+        return true;
+    }
+
+    FilePath = InFilePath;
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+    // 기존 파일의 손상된 꼬리(크래시 중 기록) 확인
+    int64 ValidEnd = 0;
+    const int64 ExistingSize = PlatformFile.FileSize(*FilePath);
+    if (ExistingSize > 0)
+    {
+        TUniquePtr<IMappedFileHandle> MappedHandle(PlatformFile.OpenMapped(*FilePath));
+        TUniquePtr<IMappedFileRegion> MappedRegion(MappedHandle ? MappedHandle->MapRegion(0, ExistingSize) : nullptr);
+        if (MappedRegion)
+        {
+            ValidEnd = FindValidEnd(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+        }
+    }
+
+    FileHandle.Reset(PlatformFile.OpenWrite(*FilePath, true, true));
+    if (!FileHandle)
+    {
+        UE_LOG(LogAIDM, Error, TEXT("세션 로그 파일을 열 수 없습니다: %s"), *FilePath);
+        return false;
+    }
+
+    if (ValidEnd < HeaderSize)
+    {
+        // 새 파일 또는 헤더 손상 - 처음부터 다시 기록
+        FileHandle->Truncate(0);
+        FileHandle->Seek(0);
+        FileHandle->Write(Magic, HeaderSize);
+    }
+    else if (ValidEnd < ExistingSize)
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("세션 로그 손상된 꼬리 제거: %lld bytes"), ExistingSize - ValidEnd);
+        FileHandle->Truncate(ValidEnd);
+        FileHandle->Seek(ValidEnd);
+    }
+    else
+    {
+        FileHandle->SeekFromEnd(0);
+    }
+
+    bStopRequested = false;
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("AIDMSessionLogWriter"), 0, TPri_BelowNormal);
+    if (!Thread)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+        FileHandle.Reset();
+        return false;
+    }
+
+    UE_LOG(LogAIDM, Log, TEXT("세션 로그 열기 완료: %s"), *FilePath);
+    return true;
+}
+
+void FAISessionLog::Close()
+{
+    if (Thread)
+    {
+        bStopRequested = true;
+        WakeEvent->Trigger();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+    }
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+
+    FileHandle.Reset();
+}
+
+void FAISessionLog::Append(const FAISessionRecord& Record)
+{
+    if (!IsOpen())
+    {
+        return;
+    }
+
+    PendingRecords.Enqueue(Record);
+    WakeEvent->Trigger();
+}
+
+uint32 FAISessionLog::Run()
+{
+    while (!bStopRequested)
+    {
+        WakeEvent->Wait();
+        FlushPendingRecords();
+    }
+
+    // 종료 전에 남은 레코드 기록
+    FlushPendingRecords();
+    return 0;
+}
+
+void FAISessionLog::Stop()
+{
+    bStopRequested = true;
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+void FAISessionLog::FlushPendingRecords()
+{
+    TArray<uint8> Batch;
+    TArray<uint8> Frame;
+    FAISessionRecord Record;
+
+    while (PendingRecords.Dequeue(Record))
+    {
+        EncodeRecord(Record, Frame);
+        Batch.Append(Frame);
+    }
+
+    if (Batch.Num() > 0 && FileHandle)
+    {
+        FileHandle->Write(Batch.GetData(), Batch.Num());
+        FileHandle->Flush();
+    }
+}
+
+void FAISessionLog::EncodeRecord(const FAISessionRecord& Record, TArray<uint8>& OutFrame)
+{
+    using namespace AISessionLogFormat;
+
+    FTCHARToUTF8 Utf8Text(*Record.Text);
+    const uint32 PayloadSize = PayloadFixedSize + Utf8Text.Length();
+    const uint8 Type = static_cast<uint8>(Record.RecordType);
+    const int64 Ticks = Record.Timestamp.GetTicks();
+    const float DurationMs = Record.DurationMs;
+
+    OutFrame.SetNumUninitialized(FrameOverhead + PayloadSize);
+    uint8* Ptr = OutFrame.GetData();
+    uint8* Payload = Ptr + 8;
+
+    FMemory::Memcpy(Payload, &Type, 1);
+    FMemory::Memcpy(Payload + 1, &Ticks, 8);
+    FMemory::Memcpy(Payload + 9, &DurationMs, 4);
+    FMemory::Memcpy(Payload + PayloadFixedSize, Utf8Text.Get(), Utf8Text.Length());
+
+    const uint32 Crc = FCrc::MemCrc32(Payload, PayloadSize);
+    FMemory::Memcpy(Ptr, &PayloadSize, 4);
+    FMemory::Memcpy(Ptr + 4, &Crc, 4);
+    FMemory::Memcpy(Payload + PayloadSize, &PayloadSize, 4);
+}
+
+bool FAISessionLog::DecodePayload(const uint8* Payload, uint32 PayloadSize, FAISessionRecord& OutRecord)
+{
+    using namespace AISessionLogFormat;
+
+    const uint8 Type = Payload[0];
+    if (Type > static_cast<uint8>(EAISessionRecordType::Timing))
+    {
+        return false;
+    }
+
+    int64 Ticks = 0;
+    FMemory::Memcpy(&Ticks, Payload + 1, 8);
+    FMemory::Memcpy(&OutRecord.DurationMs, Payload + 9, 4);
+
+    OutRecord.RecordType = static_cast<EAISessionRecordType>(Type);
+    OutRecord.Timestamp = FDateTime(Ticks);
+
+    const int32 TextSize = static_cast<int32>(PayloadSize - PayloadFixedSize);
+    FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Payload + PayloadFixedSize), TextSize);
+    OutRecord.Text = FString::ConstructFromPtrSize(Converter.Get(), Converter.Length());
+    return true;
+}
+
+int64 FAISessionLog::FindValidEnd(const uint8* Data, int64 Size)
+{
+    using namespace AISessionLogFormat;
+
+    if (Size < HeaderSize || FMemory::Memcmp(Data, Magic, HeaderSize) != 0)
+    {
+        return 0;
+    }
+
+    // 일반적인 경우: 마지막 프레임이 온전함
+    int64 Start = 0;
+    const uint8* Payload = nullptr;
+    uint32 PayloadSize = 0;
+    if (Size == HeaderSize || ReadFrameEndingAt(Data, Size, Start, Payload, PayloadSize))
+    {
+        return Size;
+    }
+
+    // 손상된 경우: 앞에서부터 유효한 프레임까지 탐색
+    int64 Offset = HeaderSize;
+    int64 Next = 0;
+    while (ReadFrameAt(Data, Size, Offset, Next, Payload, PayloadSize))
+    {
+        Offset = Next;
+    }
+    return Offset;
+}
+
+bool FAISessionLog::ReadRecentTurns(const FString& InFilePath, int32 MaxTurns, TArray<FAISessionRecord>& OutRecords)
+{
+    using namespace AISessionLogFormat;
+
+    OutRecords.Reset();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const int64 FileSize = PlatformFile.FileSize(*InFilePath);
+    if (FileSize <= HeaderSize || MaxTurns <= 0)
+    {
+        return false;
+    }
+
+    TUniquePtr<IMappedFileHandle> MappedHandle(PlatformFile.OpenMapped(*InFilePath));
+    if (!MappedHandle)
+    {
+        return false;
+    }
+
+    TUniquePtr<IMappedFileRegion> MappedRegion(MappedHandle->MapRegion(0, FileSize));
+    if (!MappedRegion)
+    {
+        return false;
+    }
+
+    const uint8* Data = MappedRegion->GetMappedPtr();
+    const int64 Size = FindValidEnd(Data, MappedRegion->GetMappedSize());
+
+    // 파일 끝에서부터 역방향으로 읽어 MaxTurns개의 플레이어 입력이 나올 때까지 수집
+    int32 TurnCount = 0;
+    int64 EndOffset = Size;
+    int64 Start = 0;
+    const uint8* Payload = nullptr;
+    uint32 PayloadSize = 0;
+
+    while (TurnCount < MaxTurns && ReadFrameEndingAt(Data, EndOffset, Start, Payload, PayloadSize))
+    {
+        FAISessionRecord Record;
+        if (DecodePayload(Payload, PayloadSize, Record))
+        {
+            if (Record.RecordType == EAISessionRecordType::UserMessage)
+            {
+                TurnCount++;
+            }
+            OutRecords.Add(MoveTemp(Record));
+        }
+        EndOffset = Start;
+    }
+
+    Algo::Reverse(OutRecords);
+    return OutRecords.Num() > 0;
+}
+
+bool FAISessionLog::ReadAllRecords(const FString& InFilePath, int64 MaxBytes, TArray<FAISessionRecord>& OutRecords)
+{
+    using namespace AISessionLogFormat;
+
+    OutRecords.Reset();
+
+    // 쓰기 스레드가 파일을 열고 있어도 읽을 수 있도록 공유 읽기
+    TArray64<uint8> FileData;
+    if (!FFileHelper::LoadFileToArray(FileData, *InFilePath, FILEREAD_AllowWrite))
+    {
+        return false;
+    }
+
+    const uint8* Data = FileData.GetData();
+    const int64 Size = FMath::Min<int64>(FileData.Num(), MaxBytes);
+    if (Size < HeaderSize || FMemory::Memcmp(Data, Magic, HeaderSize) != 0)
+    {
+        return false;
+    }
+
+    int64 Offset = HeaderSize;
+    int64 Next = 0;
+    const uint8* Payload = nullptr;
+    uint32 PayloadSize = 0;
+    while (ReadFrameAt(Data, Size, Offset, Next, Payload, PayloadSize))
+    {
+        FAISessionRecord Record;
+        if (DecodePayload(Payload, PayloadSize, Record))
+        {
+            OutRecords.Add(MoveTemp(Record));
+        }
+        Offset = Next;
+    }
+
+    return OutRecords.Num() > 0;
+}
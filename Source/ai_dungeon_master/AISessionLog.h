@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include <atomic>
+#include "AISessionLog.generated.h"
+
+class FRunnableThread;
+class IFileHandle;
+
+// 세션 로그 레코드 타입
+UENUM(BlueprintType)
+enum class EAISessionRecordType : uint8
+{
+    UserMessage     UMETA(DisplayName = "User Message"),    // 플레이어 입력
+    AIResponse      UMETA(DisplayName = "AI Response"),     // AI 응답
+    ParsedAction    UMETA(DisplayName = "Parsed Action"),   // 파싱된 액션
+    Timing          UMETA(DisplayName = "Timing")           // 구간별 소요 시간
+};
+
+// 세션 로그 레코드 구조체
+USTRUCT(BlueprintType)
+struct FAISessionRecord
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    EAISessionRecordType RecordType = EAISessionRecordType::UserMessage;   // 레코드 타입
+
+    UPROPERTY(BlueprintReadOnly)
+    FDateTime Timestamp;                                                    // 기록 시각 (UTC)
+
+    UPROPERTY(BlueprintReadOnly)
+    float DurationMs = 0.0f;                                                // 소요 시간 (Timing/AIResponse)
+
+    UPROPERTY(BlueprintReadOnly)
+    FString Text;                                                           // 메시지 본문 또는 구간 이름
+};
+
+/**
+ * 추가 전용(append-only) 바이너리 세션 로그
+ *
+ * 파일 형식: "AIDMLOG1" 헤더 뒤에 레코드가 이어진다.
+ *   [uint32 PayloadSize][uint32 Crc32][Payload][uint32 PayloadSize]
+ *   Payload = [uint8 Type][int64 Ticks][float DurationMs][UTF-8 Text]
+ * 끝에 길이를 한 번 더 기록하므로 파일 끝에서부터 역방향으로 최근 레코드를 읽을 수 있다.
+ * 쓰기는 백그라운드 스레드에서 처리되며, 게임 스레드는 큐에 넣기만 한다.
+ */
+class AI_DUNGEON_MASTER_API FAISessionLog : public FRunnable
+{
+public:
+    FAISessionLog();
+    virtual ~FAISessionLog();
+
+    // 로그 파일 열기 (쓰기 스레드 시작)
+    bool Open(const FString& InFilePath);
+
+    // 대기 중인 레코드를 모두 기록하고 닫기
+    void Close();
+
+    // 레코드 추가 (게임 스레드에서 호출, 즉시 반환)
+    void Append(const FAISessionRecord& Record);
+
+    bool IsOpen() const { return Thread != nullptr; }
+    const FString& GetFilePath() const { return FilePath; }
+
+    // 메모리 매핑으로 파일 끝에서 최근 MaxTurns 턴(플레이어 입력 기준)의 레코드를 읽기
+    static bool ReadRecentTurns(const FString& InFilePath, int32 MaxTurns, TArray<FAISessionRecord>& OutRecords);
+
+    // 파일 전체(최대 MaxBytes)를 처음부터 읽기 (기록 중인 파일도 읽을 수 있음, 백그라운드 스레드용)
+    static bool ReadAllRecords(const FString& InFilePath, int64 MaxBytes, TArray<FAISessionRecord>& OutRecords);
+
+    // 기본 세션 로그 경로
+    static FString GetDefaultLogPath();
+
+protected:
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    // 레코드를 바이너리 프레임으로 직렬화
+    static void EncodeRecord(const FAISessionRecord& Record, TArray<uint8>& OutFrame);
+
+    // 페이로드를 레코드로 역직렬화
+    static bool DecodePayload(const uint8* Payload, uint32 PayloadSize, FAISessionRecord& OutRecord);
+
+    // 큐에 쌓인 레코드를 파일에 기록
+    void FlushPendingRecords();
+
+    // 유효한 마지막 레코드의 끝 오프셋 (손상된 꼬리 제거용)
+    static int64 FindValidEnd(const uint8* Data, int64 Size);
+
+    FString FilePath;
+    TUniquePtr<IFileHandle> FileHandle;
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    TQueue<FAISessionRecord, EQueueMode::Mpsc> PendingRecords;
+    std::atomic<bool> bStopRequested;
+};
@@ -0,0 +1,268 @@
+#include "AISessionRecording.h"
+#include "AIDMLog.h"
+#include "HAL/PlatformFileManager.h"
+#include "Containers/Ticker.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace AISessionRecordingFormat
+{
+    static const uint8 Magic[8] = { 'A', 'I', 'D', 'M', 'R', 'E', 'C', '1' };
+    static constexpr int64 HeaderSize = 8;
+    static constexpr uint32 MaxPayloadSize = 64 * 1024 * 1024;
+}
+
+FArchive& operator<<(FArchive& Ar, FAIRecordedExchange& Exchange)
+{
+    FAIChatResult& Result = Exchange.Result;
+    Ar << Exchange.BodyHash;
+    Ar << Exchange.RequestBody;
+    Ar << Exchange.bStream;
+    Ar << Result.bSuccess;
+    Ar << Result.ResponseCode;
+    Ar << Result.ResponseBody;
+    Ar << Result.Content;
+    Ar << Result.bHasContent;
+    Ar << Result.TotalMs;
+
+    int32 NumChunks = Result.Chunks.Num();
+    Ar << NumChunks;
+    if (Ar.IsLoading())
+    {
+        Result.Chunks.SetNum(FMath::Max(0, NumChunks));
+    }
+    for (FAIChatChunk& Chunk : Result.Chunks)
+    {
+        Ar << Chunk.OffsetMs;
+        Ar << Chunk.Text;
+    }
+    return Ar;
+}
+
+// ---------------------------------------------------------------------------
+// FAISessionRecordingWriter
+// ---------------------------------------------------------------------------
+
+FAISessionRecordingWriter::~FAISessionRecordingWriter()
+{
+    Close();
+}
+
+bool FAISessionRecordingWriter::Open(const FString& InFilePath)
+{
+    using namespace AISessionRecordingFormat;
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(InFilePath));
+
+    const bool bNewFile = PlatformFile.FileSize(*InFilePath) < HeaderSize;
+    FileHandle.Reset(PlatformFile.OpenWrite(*InFilePath, !bNewFile, true));
+    if (!FileHandle)
+    {
+        UE_LOG(LogAIDM, Error, TEXT("세션 기록 파일을 열 수 없습니다: %s"), *InFilePath);
+        return false;
+    }
+
+    if (bNewFile)
+    {
+        FileHandle->Write(Magic, HeaderSize);
+    }
+
+    UE_LOG(LogAIDM, Log, TEXT("LLM 세션 기록 시작: %s"), *InFilePath);
+    return true;
+}
+
+void FAISessionRecordingWriter::Close()
+{
+    if (FileHandle)
+    {
+        FileHandle->Flush();
+        FileHandle.Reset();
+    }
+}
+
+void FAISessionRecordingWriter::Append(const FAIRecordedExchange& Exchange)
+{
+    if (!FileHandle)
+    {
+        return;
+    }
+
+    TArray<uint8> Payload;
+    FMemoryWriter Writer(Payload);
+    Writer << const_cast<FAIRecordedExchange&>(Exchange);
+
+    const uint32 PayloadSize = Payload.Num();
+    const uint32 Crc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+
+    uint8 FrameHeader[8];
+    FMemory::Memcpy(FrameHeader, &PayloadSize, 4);
+    FMemory::Memcpy(FrameHeader + 4, &Crc, 4);
+    FileHandle->Write(FrameHeader, sizeof(FrameHeader));
+    FileHandle->Write(Payload.GetData(), Payload.Num());
+    FileHandle->Flush();
+}
+
+bool FAISessionRecordingWriter::Load(const FString& FilePath, TArray<FAIRecordedExchange>& OutExchanges)
+{
+    using namespace AISessionRecordingFormat;
+
+    OutExchanges.Reset();
+
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *FilePath, FILEREAD_Silent) || Data.Num() < HeaderSize
+        || FMemory::Memcmp(Data.GetData(), Magic, HeaderSize) != 0)
+    {
+        return false;
+    }
+
+    int64 Offset = HeaderSize;
+    while (Offset + 8 <= Data.Num())
+    {
+        uint32 PayloadSize;
+        uint32 Crc;
+        FMemory::Memcpy(&PayloadSize, Data.GetData() + Offset, 4);
+        FMemory::Memcpy(&Crc, Data.GetData() + Offset + 4, 4);
+
+        const uint8* Payload = Data.GetData() + Offset + 8;
+        if (PayloadSize > MaxPayloadSize || Offset + 8 + PayloadSize > Data.Num() || FCrc::MemCrc32(Payload, PayloadSize) != Crc)
+        {
+            // 손상된 꼬리 (기록 도중 종료)
+            break;
+        }
+
+        TArray<uint8> PayloadBytes(Payload, PayloadSize);
+        FMemoryReader Reader(PayloadBytes);
+        FAIRecordedExchange& Exchange = OutExchanges.AddDefaulted_GetRef();
+        Reader << Exchange;
+
+        Offset += 8 + PayloadSize;
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// FAIRecordingBackend
+// ---------------------------------------------------------------------------
+
+FAIRecordingBackend::FAIRecordingBackend(TSharedPtr<IAIChatBackend> InInner, const FString& RecordingPath)
+    : Inner(InInner)
+    , Writer(MakeShared<FAISessionRecordingWriter>())
+{
+    Writer->Open(RecordingPath);
+}
+
+void FAIRecordingBackend::SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete)
+{
+    TWeakPtr<FAISessionRecordingWriter> WeakWriter = Writer;
+    const FString Body = Request.Body;
+    const bool bStream = Request.bStream;
+
+    Inner->SendRequest(Request, OnChunk, FOnAIChatComplete::CreateLambda([WeakWriter, Body, bStream, OnComplete](const FAIChatResult& Result)
+    {
+        if (TSharedPtr<FAISessionRecordingWriter> PinnedWriter = WeakWriter.Pin())
+        {
+            FAIRecordedExchange Exchange;
+            Exchange.BodyHash = FCrc::StrCrc32(*Body);
+            Exchange.RequestBody = Body;
+            Exchange.bStream = bStream;
+            Exchange.Result = Result;
+            PinnedWriter->Append(Exchange);
+        }
+
+        OnComplete.ExecuteIfBound(Result);
+    }));
+}
+
+// ---------------------------------------------------------------------------
+// FAIReplayBackend
+// ---------------------------------------------------------------------------
+
+FAIReplayBackend::FAIReplayBackend(const FString& RecordingPath, float InTimeScale)
+    : TimeScale(InTimeScale)
+{
+    if (!FAISessionRecordingWriter::Load(RecordingPath, Exchanges))
+    {
+        UE_LOG(LogAIDM, Error, TEXT("세션 기록 파일을 읽을 수 없습니다: %s"), *RecordingPath);
+    }
+
+    for (int32 i = 0; i < Exchanges.Num(); i++)
+    {
+        ExchangesByHash.Add(Exchanges[i].BodyHash, i);
+    }
+    UsedExchanges.Init(false, Exchanges.Num());
+
+    UE_LOG(LogAIDM, Log, TEXT("LLM 세션 재생: %s (요청 %d개, 속도 x%.1f)"), *RecordingPath, Exchanges.Num(), TimeScale);
+}
+
+int32 FAIReplayBackend::TakeExchange(const FString& Body)
+{
+    // 같은 요청 본문 우선
+    TArray<int32> Matches;
+    ExchangesByHash.MultiFind(FCrc::StrCrc32(*Body), Matches, true);
+    for (int32 Index : Matches)
+    {
+        if (!UsedExchanges[Index] && Exchanges[Index].RequestBody == Body)
+        {
+            UsedExchanges[Index] = true;
+            return Index;
+        }
+    }
+
+    // 없으면 기록 순서대로
+    while (NextSequential < Exchanges.Num() && UsedExchanges[NextSequential])
+    {
+        NextSequential++;
+    }
+    if (NextSequential < Exchanges.Num())
+    {
+        UsedExchanges[NextSequential] = true;
+        return NextSequential++;
+    }
+
+    return INDEX_NONE;
+}
+
+float FAIReplayBackend::ScaleDelay(float Ms) const
+{
+    return TimeScale > 0.0f ? Ms / 1000.0f / TimeScale : 0.0f;
+}
+
+void FAIReplayBackend::SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete)
+{
+    const int32 Index = TakeExchange(Request.Body);
+    if (Index == INDEX_NONE)
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("재생할 기록이 남아 있지 않습니다"));
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnComplete](float)
+        {
+            OnComplete.ExecuteIfBound(FAIChatResult());
+            return false;
+        }));
+        return;
+    }
+
+    const FAIRecordedExchange& Exchange = Exchanges[Index];
+
+    // 조각은 원래 도착 시각에 맞춰 전달
+    for (const FAIChatChunk& Chunk : Exchange.Result.Chunks)
+    {
+        FString ChunkText = Chunk.Text;
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnChunk, ChunkText](float)
+        {
+            OnChunk.ExecuteIfBound(ChunkText);
+            return false;
+        }), ScaleDelay(Chunk.OffsetMs));
+    }
+
+    FAIChatResult Result = Exchange.Result;
+    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([OnComplete, Result](float)
+    {
+        OnComplete.ExecuteIfBound(Result);
+        return false;
+    }), ScaleDelay(Exchange.Result.TotalMs));
+}
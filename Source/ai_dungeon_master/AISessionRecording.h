@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIChatBackend.h"
+
+class IFileHandle;
+
+// 기록된 요청/응답 한 쌍
+struct FAIRecordedExchange
+{
+    uint32 BodyHash = 0;        // 요청 본문 CRC (재생 시 요청 매칭)
+    FString RequestBody;
+    bool bStream = false;
+    FAIChatResult Result;       // 응답 본문, 조각 도착 시각, 전체 시간 포함
+
+    friend FArchive& operator<<(FArchive& Ar, FAIRecordedExchange& Exchange);
+};
+
+/**
+ * LLM 세션 기록 파일 (.aidmrec)
+ * "AIDMREC1" 헤더 뒤에 [u32 크기][u32 CRC][직렬화된 FAIRecordedExchange] 프레임이 이어진다.
+ * 손상된 꼬리 프레임은 읽을 때 무시한다.
+ */
+class AI_DUNGEON_MASTER_API FAISessionRecordingWriter
+{
+public:
+    ~FAISessionRecordingWriter();
+
+    bool Open(const FString& InFilePath);
+    void Close();
+    void Append(const FAIRecordedExchange& Exchange);
+
+    static bool Load(const FString& FilePath, TArray<FAIRecordedExchange>& OutExchanges);
+
+private:
+    TUniquePtr<IFileHandle> FileHandle;
+};
+
+/**
+ * 다른 백엔드를 감싸 모든 요청/응답을 기록하는 백엔드
+ */
+class AI_DUNGEON_MASTER_API FAIRecordingBackend : public IAIChatBackend
+{
+public:
+    FAIRecordingBackend(TSharedPtr<IAIChatBackend> InInner, const FString& RecordingPath);
+
+    virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) override;
+    virtual bool RequiresAPIKey() const override { return Inner->RequiresAPIKey(); }
+    virtual void SetAPIKey(const FString& InAPIKey) override { Inner->SetAPIKey(InAPIKey); }
+    virtual void SetEndpoint(const FString& InURL, float InTimeoutSeconds) override { Inner->SetEndpoint(InURL, InTimeoutSeconds); }
+    virtual void WarmConnection(float KeepAliveInterval) override { Inner->WarmConnection(KeepAliveInterval); }
+    virtual FAIConnectionStats GetConnectionStats() const override { return Inner->GetConnectionStats(); }
+    virtual const TCHAR* GetName() const override { return TEXT("Recording"); }
+
+private:
+    TSharedPtr<IAIChatBackend> Inner;
+    TSharedPtr<FAISessionRecordingWriter> Writer;
+};
+
+/**
+ * 기록 파일의 응답을 원래 시간 간격(또는 가속)으로 되돌려주는 백엔드
+ * 요청 본문 해시가 같은 기록을 우선 사용하고, 없으면 기록 순서대로 사용한다.
+ */
+class AI_DUNGEON_MASTER_API FAIReplayBackend : public IAIChatBackend
+{
+public:
+    // TimeScale: 1 = 원래 속도, 10 = 10배 빠르게, 0 이하 = 지연 없음
+    FAIReplayBackend(const FString& RecordingPath, float InTimeScale);
+
+    virtual void SendRequest(const FAIChatRequest& Request, FOnAIChatChunk OnChunk, FOnAIChatComplete OnComplete) override;
+    virtual bool RequiresAPIKey() const override { return false; }
+    virtual const TCHAR* GetName() const override { return TEXT("Replay"); }
+
+    int32 GetNumExchanges() const { return Exchanges.Num(); }
+
+private:
+    // 다음에 사용할 기록 (없으면 INDEX_NONE)
+    int32 TakeExchange(const FString& Body);
+
+    float ScaleDelay(float Ms) const;
+
+    TArray<FAIRecordedExchange> Exchanges;
+    TMultiMap<uint32, int32> ExchangesByHash;
+    TBitArray<> UsedExchanges;
+    int32 NextSequential = 0;
+    float TimeScale = 1.0f;
+};
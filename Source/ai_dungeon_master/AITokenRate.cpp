@@ -0,0 +1,172 @@
+#include "AITokenRate.h"
+
+void FAITokenRateGovernor::FBucket::Configure(int32 TokensPerMinute)
+{
+    const float NewCapacity = static_cast<float>(FMath::Max(TokensPerMinute, 0));
+    if (NewCapacity != Capacity)
+    {
+        // 처음 켜거나 한도를 바꾸면 새 용량 안에서 이어 감
+        Tokens = Capacity > 0.0f ? FMath::Min(Tokens, NewCapacity) : NewCapacity;
+        Capacity = NewCapacity;
+        LastRefillTime = FPlatformTime::Seconds();
+    }
+}
+
+void FAITokenRateGovernor::FBucket::Refill(double Now)
+{
+    Tokens = GetAvailable(Now);
+    LastRefillTime = Now;
+}
+
+float FAITokenRateGovernor::FBucket::GetAvailable(double Now) const
+{
+    return FMath::Min(Capacity, Tokens + static_cast<float>((Now - LastRefillTime) * Capacity / 60.0));
+}
+
+void FAITokenRateGovernor::SetLimits(const FAITokenRateLimits& InLimits)
+{
+    Limits = InLimits;
+    GlobalBucket.Configure(Limits.GlobalTokensPerMinute);
+    for (int32 Index = 0; Index < static_cast<int32>(EAIRequestPriority::Count); Index++)
+    {
+        PriorityBuckets[Index].Configure(Limits.PriorityTokensPerMinute[Index]);
+    }
+    for (TPair<FName, FBucket>& Pair : SessionBuckets)
+    {
+        Pair.Value.Configure(Limits.SessionTokensPerMinute);
+    }
+}
+
+bool FAITokenRateGovernor::IsLimited() const
+{
+    if (Limits.GlobalTokensPerMinute > 0 || Limits.SessionTokensPerMinute > 0)
+    {
+        return true;
+    }
+    for (int32 TokensPerMinute : Limits.PriorityTokensPerMinute)
+    {
+        if (TokensPerMinute > 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FAITokenRateGovernor::GatherBuckets(EAIRequestPriority Priority, FName SessionId, TArray<FBucket*, TInlineAllocator<3>>& OutBuckets)
+{
+    if (GlobalBucket.Capacity > 0.0f)
+    {
+        OutBuckets.Add(&GlobalBucket);
+    }
+
+    FBucket& PriorityBucket = PriorityBuckets[static_cast<int32>(Priority)];
+    if (PriorityBucket.Capacity > 0.0f)
+    {
+        OutBuckets.Add(&PriorityBucket);
+    }
+
+    if (Limits.SessionTokensPerMinute > 0 && !SessionId.IsNone())
+    {
+        FBucket* SessionBucket = SessionBuckets.Find(SessionId);
+        if (!SessionBucket)
+        {
+            SessionBucket = &SessionBuckets.Add(SessionId);
+            SessionBucket->Configure(Limits.SessionTokensPerMinute);
+        }
+        OutBuckets.Add(SessionBucket);
+    }
+}
+
+float FAITokenRateGovernor::GetReserve(EAIRequestPriority Priority, const FBucket& Bucket, bool bPriorityBucket) const
+{
+    // 우선순위 버킷은 그 종류만 쓰므로 남길 필요 없음
+    if (Priority == EAIRequestPriority::Foreground || bPriorityBucket)
+    {
+        return 0.0f;
+    }
+    return Bucket.Capacity * FMath::Clamp(Limits.ForegroundReserveRatio, 0.0f, 1.0f);
+}
+
+bool FAITokenRateGovernor::TryAdmit(EAIRequestPriority Priority, FName SessionId, int32 EstimatedTokens)
+{
+    // 플레이어 턴이 한도 때문에 기다리는 동안 다른 요청은 보내지 않음
+    if (Priority != EAIRequestPriority::Foreground && bForegroundWaiting)
+    {
+        Stats.DroppedRequests++;
+        return false;
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    const FBucket* PriorityBucket = &PriorityBuckets[static_cast<int32>(Priority)];
+
+    TArray<FBucket*, TInlineAllocator<3>> Buckets;
+    GatherBuckets(Priority, SessionId, Buckets);
+    for (FBucket* Bucket : Buckets)
+    {
+        Bucket->Refill(Now);
+        if (Bucket->Tokens < Bucket->GetRequired(EstimatedTokens, GetReserve(Priority, *Bucket, Bucket == PriorityBucket)))
+        {
+            (Priority == EAIRequestPriority::Foreground ? Stats.DeferredRequests : Stats.DroppedRequests)++;
+            return false;
+        }
+    }
+
+    for (FBucket* Bucket : Buckets)
+    {
+        Bucket->Tokens -= EstimatedTokens;
+    }
+    Stats.AdmittedRequests++;
+    return true;
+}
+
+float FAITokenRateGovernor::GetWaitSeconds(EAIRequestPriority Priority, FName SessionId, int32 EstimatedTokens) const
+{
+    const double Now = FPlatformTime::Seconds();
+
+    float WaitSeconds = 0.0f;
+    auto AddBucket = [&](const FBucket& Bucket, bool bPriorityBucket)
+    {
+        if (Bucket.Capacity > 0.0f)
+        {
+            const float Deficit = Bucket.GetRequired(EstimatedTokens, GetReserve(Priority, Bucket, bPriorityBucket)) - Bucket.GetAvailable(Now);
+            WaitSeconds = FMath::Max(WaitSeconds, Deficit * 60.0f / Bucket.Capacity);
+        }
+    };
+
+    AddBucket(GlobalBucket, false);
+    AddBucket(PriorityBuckets[static_cast<int32>(Priority)], true);
+    if (const FBucket* SessionBucket = SessionBuckets.Find(SessionId))
+    {
+        AddBucket(*SessionBucket, false);
+    }
+    return WaitSeconds;
+}
+
+void FAITokenRateGovernor::Settle(EAIRequestPriority Priority, FName SessionId, int32 EstimatedTokens, int32 UsedTokens)
+{
+    // 예상보다 많이 썼으면 빚으로 남김 (다음 요청이 그만큼 늦게 나감)
+    TArray<FBucket*, TInlineAllocator<3>> Buckets;
+    GatherBuckets(Priority, SessionId, Buckets);
+    for (FBucket* Bucket : Buckets)
+    {
+        Bucket->Tokens = FMath::Min(Bucket->Tokens + EstimatedTokens - UsedTokens, Bucket->Capacity);
+    }
+}
+
+void FAITokenRateGovernor::OnRateLimited()
+{
+    Stats.RateLimitResponses++;
+    if (GlobalBucket.Capacity > 0.0f)
+    {
+        GlobalBucket.Refill(FPlatformTime::Seconds());
+        GlobalBucket.Tokens = FMath::Min(GlobalBucket.Tokens, 0.0f);
+    }
+}
+
+FAITokenRateStats FAITokenRateGovernor::GetStats() const
+{
+    FAITokenRateStats Result = Stats;
+    Result.GlobalTokensAvailable = GlobalBucket.Capacity > 0.0f ? GlobalBucket.GetAvailable(FPlatformTime::Seconds()) : 0.0f;
+    return Result;
+}
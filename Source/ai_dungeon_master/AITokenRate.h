@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AITokenRate.generated.h"
+
+// 요청 우선순위 (속도 한도를 따로 적용)
+UENUM(BlueprintType)
+enum class EAIRequestPriority : uint8
+{
+    Foreground  UMETA(DisplayName = "Foreground"),  // 플레이어가 기다리는 턴
+    Background  UMETA(DisplayName = "Background"),  // 캠페인 요약
+    Speculative UMETA(DisplayName = "Speculative"), // 다음 입력 예측
+    Count       UMETA(Hidden)
+};
+
+// 분당 토큰 한도 (0 = 제한 없음)
+struct FAITokenRateLimits
+{
+    int32 GlobalTokensPerMinute = 0;
+    int32 SessionTokensPerMinute = 0;
+    int32 PriorityTokensPerMinute[static_cast<int32>(EAIRequestPriority::Count)] = {};
+
+    // 플레이어 턴 몫으로 남겨 둘 전역/세션 버킷 비율 (백그라운드, 예측 요청은 이만큼 남아 있어야 보냄)
+    float ForegroundReserveRatio = 0.25f;
+};
+
+// 속도 한도 지표
+USTRUCT(BlueprintType)
+struct FAITokenRateStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|RateLimit")
+    int32 AdmittedRequests = 0;
+
+    // 한도 때문에 대기한 플레이어 턴
+    UPROPERTY(BlueprintReadOnly, Category = "AI|RateLimit")
+    int32 DeferredRequests = 0;
+
+    // 한도 때문에 보내지 않은 요약/예측 요청
+    UPROPERTY(BlueprintReadOnly, Category = "AI|RateLimit")
+    int32 DroppedRequests = 0;
+
+    // 서버가 429로 거절한 요청
+    UPROPERTY(BlueprintReadOnly, Category = "AI|RateLimit")
+    int32 RateLimitResponses = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|RateLimit")
+    float GlobalTokensAvailable = 0.0f;
+};
+
+/**
+ * 분당 토큰 한도를 지키는 토큰 버킷 (전역, 세션별, 우선순위별, 게임 스레드 전용)
+ * 요청은 예상 토큰(프롬프트 + max_tokens)으로 모든 해당 버킷에서 미리 빼고, 응답 후 실제 사용량으로 정산한다.
+ * 백그라운드/예측 요청은 플레이어 턴 몫(ForegroundReserveRatio)을 남길 수 있을 때만, 대기 중인 플레이어 턴이 없을 때만 보낸다.
+ * 서버가 429를 돌려주면 전역 버킷을 비워 다시 찰 때까지 보내지 않는다.
+ */
+class AI_DUNGEON_MASTER_API FAITokenRateGovernor
+{
+public:
+    void SetLimits(const FAITokenRateLimits& InLimits);
+
+    bool IsLimited() const;
+
+    // 보낼 수 있으면 예상 토큰을 빼고 true
+    bool TryAdmit(EAIRequestPriority Priority, FName SessionId, int32 EstimatedTokens);
+
+    // 보낼 수 있을 때까지 남은 시간 (초, 지금 가능하면 0)
+    float GetWaitSeconds(EAIRequestPriority Priority, FName SessionId, int32 EstimatedTokens) const;
+
+    // 응답 후 예상과 실제 사용량 차이 정산
+    void Settle(EAIRequestPriority Priority, FName SessionId, int32 EstimatedTokens, int32 UsedTokens);
+
+    // 서버 429 응답
+    void OnRateLimited();
+
+    void SetForegroundWaiting(bool bWaiting) { bForegroundWaiting = bWaiting; }
+    void RemoveSession(FName SessionId) { SessionBuckets.Remove(SessionId); }
+
+    FAITokenRateStats GetStats() const;
+
+private:
+    struct FBucket
+    {
+        float Capacity = 0.0f;      // 0 = 제한 없음
+        float Tokens = 0.0f;
+        double LastRefillTime = 0.0;
+
+        void Configure(int32 TokensPerMinute);
+        void Refill(double Now);
+        float GetAvailable(double Now) const;
+
+        // 한 번에 용량보다 큰 요청은 버킷이 가득 찼을 때 보냄
+        float GetRequired(float EstimatedTokens, float Reserve) const { return FMath::Min(EstimatedTokens + Reserve, Capacity); }
+    };
+
+    // 요청에 적용되는 버킷 (세션 버킷은 없으면 만듦)
+    void GatherBuckets(EAIRequestPriority Priority, FName SessionId, TArray<FBucket*, TInlineAllocator<3>>& OutBuckets);
+    float GetReserve(EAIRequestPriority Priority, const FBucket& Bucket, bool bPriorityBucket) const;
+
+    FAITokenRateLimits Limits;
+    FBucket GlobalBucket;
+    FBucket PriorityBuckets[static_cast<int32>(EAIRequestPriority::Count)];
+    TMap<FName, FBucket> SessionBuckets;
+    bool bForegroundWaiting = false;
+
+    FAITokenRateStats Stats;
+};
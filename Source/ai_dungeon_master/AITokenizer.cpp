@@ -0,0 +1,328 @@
+#include "AITokenizer.h"
+#include "AIDMLog.h"
+#include "AIModelRoute.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Base64.h"
+#include "Misc/Paths.h"
+
+namespace AITokenizerPrivate
+{
+    enum EByteClass : uint8
+    {
+        Other,
+        Letter,     // 비ASCII 바이트 포함
+        Digit,
+        Space,
+        Newline
+    };
+
+    struct FByteClassTable
+    {
+        uint8 Classes[256];
+
+        FByteClassTable()
+        {
+            for (int32 Byte = 0; Byte < 256; Byte++)
+            {
+                uint8 Class = Other;
+                if ((Byte >= 'a' && Byte <= 'z') || (Byte >= 'A' && Byte <= 'Z') || Byte >= 0x80)
+                {
+                    Class = Letter;
+                }
+                else if (Byte >= '0' && Byte <= '9')
+                {
+                    Class = Digit;
+                }
+                else if (Byte == '\r' || Byte == '\n')
+                {
+                    Class = Newline;
+                }
+                else if (Byte == ' ' || Byte == '\t' || Byte == '\v' || Byte == '\f')
+                {
+                    Class = Space;
+                }
+                Classes[Byte] = Class;
+            }
+        }
+    };
+
+    static const FByteClassTable ByteClasses;
+
+    static uint8 GetClass(const uint8* Data, int32 Index)
+    {
+        return ByteClasses.Classes[Data[Index]];
+    }
+
+    static bool IsWhitespace(uint8 Class)
+    {
+        return Class == Space || Class == Newline;
+    }
+
+    // 8바이트가 모두 ASCII 영문자인지 (대소문자를 통일한 뒤 'a' 이상, 'z' 이하 검사)
+    static bool IsAsciiLetterWord(uint64 Word)
+    {
+        constexpr uint64 Ones = 0x0101010101010101ull;
+        constexpr uint64 High = 0x8080808080808080ull;
+        if ((Word & High) != 0)
+        {
+            return false;
+        }
+        const uint64 Lower = Word | (0x20 * Ones);
+        const uint64 AtLeastA = Lower + (0x80 - 'a') * Ones;
+        const uint64 AtMostZ = Lower + (0x7F - 'z') * Ones;
+        return (AtLeastA & ~AtMostZ & High) == High;
+    }
+
+    // Start부터 글자가 이어지는 끝 위치
+    static int32 ScanLetters(const uint8* Data, int32 Length, int32 Start)
+    {
+        int32 Pos = Start;
+        while (Pos < Length)
+        {
+            if (Pos + 8 <= Length)
+            {
+                uint64 Word;
+                FMemory::Memcpy(&Word, Data + Pos, sizeof(Word));
+                if (IsAsciiLetterWord(Word))
+                {
+                    Pos += 8;
+                    continue;
+                }
+            }
+            if (GetClass(Data, Pos) != Letter)
+            {
+                break;
+            }
+            Pos++;
+        }
+        return Pos;
+    }
+
+    static int32 ScanClass(const uint8* Data, int32 Length, int32 Start, uint8 Class)
+    {
+        int32 Pos = Start;
+        while (Pos < Length && GetClass(Data, Pos) == Class)
+        {
+            Pos++;
+        }
+        return Pos;
+    }
+}
+
+using namespace AITokenizerPrivate;
+
+bool FAITokenizer::LoadFromFile(const FString& InPath)
+{
+    const FString Path = FPaths::IsRelative(InPath) ? FPaths::Combine(FPaths::ProjectDir(), InPath) : InPath;
+    const double StartTime = FPlatformTime::Seconds();
+
+    TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+    TUniquePtr<IMappedFileRegion> Region(MappedFile ? MappedFile->MapRegion(0, MappedFile->GetFileSize()) : nullptr);
+    if (!Region)
+    {
+        UE_LOG(LogAIDM, Warning, TEXT("토크나이저 파일을 열 수 없음: %s (글자 수로 추정)"), *Path);
+        return false;
+    }
+
+    const ANSICHAR* Data = reinterpret_cast<const ANSICHAR*>(Region->GetMappedPtr());
+    const int64 Size = Region->GetMappedSize();
+
+    // 키가 Arena를 가리키므로 디코딩 전에 최대 크기로 한 번만 할당
+    Ranks.Reset();
+    Arena.Reset();
+    Arena.SetNumUninitialized(Size * 3 / 4 + 4);
+    Ranks.Reserve(static_cast<int32>(Size / 12));
+
+    int64 ArenaSize = 0;
+    int64 LineStart = 0;
+    while (LineStart < Size)
+    {
+        int64 LineEnd = LineStart;
+        while (LineEnd < Size && Data[LineEnd] != '\n')
+        {
+            LineEnd++;
+        }
+
+        int64 Separator = LineStart;
+        while (Separator < LineEnd && Data[Separator] != ' ')
+        {
+            Separator++;
+        }
+
+        if (Separator > LineStart && Separator < LineEnd)
+        {
+            const uint32 EncodedLength = static_cast<uint32>(Separator - LineStart);
+            const uint32 DecodedLength = FBase64::GetDecodedDataSize(Data + LineStart, EncodedLength);
+            uint8* Dest = Arena.GetData() + ArenaSize;
+            if (DecodedLength > 0 && FBase64::Decode(Data + LineStart, EncodedLength, Dest))
+            {
+                int32 Rank = 0;
+                for (int64 Pos = Separator + 1; Pos < LineEnd && FChar::IsDigit(Data[Pos]); Pos++)
+                {
+                    Rank = Rank * 10 + (Data[Pos] - '0');
+                }
+                Ranks.Add(FPieceView{ Dest, static_cast<int32>(DecodedLength) }, Rank);
+                ArenaSize += DecodedLength;
+            }
+        }
+
+        LineStart = LineEnd + 1;
+    }
+
+    UE_LOG(LogAIDM, Log, TEXT("토크나이저 로드: %s (토큰 %d개, %.1f ms)"), *FPaths::GetCleanFilename(Path), Ranks.Num(),
+        (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return IsLoaded();
+}
+
+int32 FAITokenizer::CountTokens(const FString& Text) const
+{
+    if (!IsLoaded())
+    {
+        return FAITokenUsage::EstimateTokens(Text);
+    }
+
+    const FTCHARToUTF8 Converted(*Text);
+    return CountTokensUTF8(Converted.Get(), Converted.Length());
+}
+
+int32 FAITokenizer::CountTokensUTF8(const ANSICHAR* Data, int32 Length) const
+{
+    const uint8* Bytes = reinterpret_cast<const uint8*>(Data);
+    int32 Count = 0;
+    int32 Start = 0;
+    while (Start < Length)
+    {
+        const int32 PieceLength = NextPieceLength(Bytes, Length, Start);
+        Count += CountPieceTokens(Bytes + Start, PieceLength);
+        Start += PieceLength;
+    }
+    return Count;
+}
+
+int32 FAITokenizer::NextPieceLength(const uint8* Data, int32 Length, int32 Start)
+{
+    const uint8 Class = GetClass(Data, Start);
+    const int32 Remaining = Length - Start;
+
+    // 's 't 'm 'd 'll 've 're
+    if (Data[Start] == '\'' && Remaining >= 2)
+    {
+        const uint8 Next = FChar::ToLower(static_cast<ANSICHAR>(Data[Start + 1]));
+        if (Next == 's' || Next == 't' || Next == 'm' || Next == 'd')
+        {
+            return 2;
+        }
+        if (Remaining >= 3)
+        {
+            const uint8 Third = FChar::ToLower(static_cast<ANSICHAR>(Data[Start + 2]));
+            if ((Next == 'l' && Third == 'l') || (Next == 'v' && Third == 'e') || (Next == 'r' && Third == 'e'))
+            {
+                return 3;
+            }
+        }
+    }
+
+    // 글자 앞의 공백/기호 하나는 단어에 붙음
+    if (Class == Letter)
+    {
+        return ScanLetters(Data, Length, Start + 1) - Start;
+    }
+    if ((Class == Other || Class == Space) && Remaining >= 2 && GetClass(Data, Start + 1) == Letter)
+    {
+        return ScanLetters(Data, Length, Start + 2) - Start;
+    }
+
+    // 숫자는 3자리씩
+    if (Class == Digit)
+    {
+        return FMath::Min(ScanClass(Data, Length, Start, Digit) - Start, 3);
+    }
+
+    // 공백 하나 + 기호들 + 줄바꿈들
+    int32 SymbolStart = Start;
+    if (Data[Start] == ' ' && Remaining >= 2 && GetClass(Data, Start + 1) == Other)
+    {
+        SymbolStart++;
+    }
+    if (GetClass(Data, SymbolStart) == Other)
+    {
+        const int32 SymbolEnd = ScanClass(Data, Length, SymbolStart, Other);
+        return ScanClass(Data, Length, SymbolEnd, Newline) - Start;
+    }
+
+    // 공백: 마지막 줄바꿈까지, 없으면 다음 단어에 붙을 공백 하나를 남김
+    int32 End = Start;
+    int32 LastNewline = INDEX_NONE;
+    while (End < Length && IsWhitespace(GetClass(Data, End)))
+    {
+        if (GetClass(Data, End) == Newline)
+        {
+            LastNewline = End;
+        }
+        End++;
+    }
+    if (LastNewline != INDEX_NONE)
+    {
+        return LastNewline + 1 - Start;
+    }
+    if (End < Length && End - Start > 1)
+    {
+        return End - 1 - Start;
+    }
+    return FMath::Max(End - Start, 1);
+}
+
+int32 FAITokenizer::CountPieceTokens(const uint8* Piece, int32 Length) const
+{
+    // 흔한 단어는 조각 전체가 토큰 하나
+    if (Length <= 1 || GetRank(Piece, Length) != MAX_int32)
+    {
+        return 1;
+    }
+
+    // (시작 위치, 여기서 시작하는 쌍의 순위), 마지막은 끝 표시
+    TArray<TPair<int32, int32>, TInlineAllocator<64>> Parts;
+    Parts.Reserve(Length + 1);
+    for (int32 Index = 0; Index <= Length; Index++)
+    {
+        Parts.Emplace(Index, MAX_int32);
+    }
+
+    auto GetPairRank = [this, Piece, &Parts](int32 Index)
+    {
+        return Index + 2 < Parts.Num() ? GetRank(Piece + Parts[Index].Key, Parts[Index + 2].Key - Parts[Index].Key) : MAX_int32;
+    };
+
+    for (int32 Index = 0; Index + 2 < Parts.Num(); Index++)
+    {
+        Parts[Index].Value = GetPairRank(Index);
+    }
+
+    while (Parts.Num() > 2)
+    {
+        int32 MinIndex = INDEX_NONE;
+        int32 MinRank = MAX_int32;
+        for (int32 Index = 0; Index + 2 < Parts.Num(); Index++)
+        {
+            if (Parts[Index].Value < MinRank)
+            {
+                MinRank = Parts[Index].Value;
+                MinIndex = Index;
+            }
+        }
+        if (MinIndex == INDEX_NONE)
+        {
+            break;
+        }
+
+        Parts.RemoveAt(MinIndex + 1, 1, EAllowShrinking::No);
+        Parts[MinIndex].Value = GetPairRank(MinIndex);
+        if (MinIndex > 0)
+        {
+            Parts[MinIndex - 1].Value = GetPairRank(MinIndex - 1);
+        }
+    }
+
+    return Parts.Num() - 1;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Crc.h"
+
+/**
+ * 바이트 단위 BPE 토큰 수 계산기 (tiktoken 형식 순위 파일, 예: cl100k_base.tiktoken)
+ * 순위 파일은 메모리 매핑으로 읽어 한 번만 디코딩하고, 로드 후에는 읽기 전용이라 여러 스레드에서 써도 된다.
+ * 사전 분할은 cl100k 정규식 규칙을 바이트 분류표로 흉내 내며 (비ASCII 바이트는 글자로 취급),
+ * 소문자/대문자 영문 구간은 8바이트씩 한 번에 검사한다.
+ * 로드하지 않았으면 글자 수로 추정한다 (FAITokenUsage::EstimateTokens).
+ */
+class AI_DUNGEON_MASTER_API FAITokenizer
+{
+public:
+    // "base64 토큰 순위" 줄로 된 파일 로드 (상대 경로면 프로젝트 폴더 기준)
+    bool LoadFromFile(const FString& Path);
+
+    bool IsLoaded() const { return Ranks.Num() > 0; }
+    int32 GetVocabSize() const { return Ranks.Num(); }
+
+    int32 CountTokens(const FString& Text) const;
+    int32 CountTokensUTF8(const ANSICHAR* Data, int32 Length) const;
+
+    // 채팅 메시지 하나 (역할과 구분 토큰 포함)
+    int32 CountMessageTokens(const FString& Content) const { return CountTokens(Content) + MessageOverheadTokens; }
+
+    // 메시지마다 붙는 토큰, 응답 시작 토큰 (OpenAI 채팅 형식 기준)
+    static constexpr int32 MessageOverheadTokens = 4;
+    static constexpr int32 ReplyPrimingTokens = 3;
+
+    // Data[Start]부터 사전 분할 조각 하나의 길이
+    static int32 NextPieceLength(const uint8* Data, int32 Length, int32 Start);
+
+private:
+    // 순위 표 키 (Arena 안의 바이트 구간)
+    struct FPieceView
+    {
+        const uint8* Data = nullptr;
+        int32 Length = 0;
+    };
+
+    struct FPieceKeyFuncs : BaseKeyFuncs<TPair<FPieceView, int32>, FPieceView, false>
+    {
+        static const FPieceView& GetSetKey(const TPair<FPieceView, int32>& Element) { return Element.Key; }
+        static bool Matches(const FPieceView& A, const FPieceView& B)
+        {
+            return A.Length == B.Length && FMemory::Memcmp(A.Data, B.Data, A.Length) == 0;
+        }
+        static uint32 GetKeyHash(const FPieceView& Key) { return FCrc::MemCrc32(Key.Data, Key.Length); }
+    };
+
+    int32 GetRank(const uint8* Data, int32 Length) const
+    {
+        const int32* Rank = Ranks.Find(FPieceView{ Data, Length });
+        return Rank ? *Rank : MAX_int32;
+    }
+
+    // 조각 하나를 순위가 낮은 쌍부터 병합했을 때 토큰 수
+    int32 CountPieceTokens(const uint8* Piece, int32 Length) const;
+
+    // 디코딩한 토큰 바이트 (로드 후 크기가 바뀌지 않음)
+    TArray<uint8> Arena;
+    TMap<FPieceView, int32, FDefaultSetAllocator, FPieceKeyFuncs> Ranks;
+};
@@ -0,0 +1,41 @@
+#include "AIWorldEntityComponent.h"
+#include "AIDMSubsystem.h"
+#include "GameFramework/Actor.h"
+
+UAIWorldEntityComponent::UAIWorldEntityComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+}
+
+FString UAIWorldEntityComponent::GetEntityName() const
+{
+    if (!DisplayName.IsEmpty() || !GetOwner())
+    {
+        return DisplayName;
+    }
+
+    FString Name = GetOwner()->GetClass()->GetName();
+    Name.RemoveFromStart(TEXT("BP_"));
+    Name.RemoveFromEnd(TEXT("_C"));
+    return Name;
+}
+
+void UAIWorldEntityComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this))
+    {
+        Subsystem->RegisterWorldEntity(this);
+    }
+}
+
+void UAIWorldEntityComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UAIDMSubsystem* Subsystem = UAIDMSubsystem::Get(this))
+    {
+        Subsystem->UnregisterWorldEntity(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
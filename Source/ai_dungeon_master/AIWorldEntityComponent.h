@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "AIWorldEntityComponent.generated.h"
+
+/**
+ * 이 액터를 AI 프롬프트의 주변 상태에 포함 (서버/단독 실행에서 BeginPlay 때 서브시스템에 등록)
+ * 매니저는 레벨을 훑지 않고 등록된 컴포넌트만 보며, 종류/이름/상태는 요청마다 다시 읽는다.
+ * 실행 중에 컴포넌트를 붙이거나 떼면 그때 등록/해제된다.
+ */
+UCLASS(ClassGroup = (AI), meta = (BlueprintSpawnableComponent))
+class AI_DUNGEON_MASTER_API UAIWorldEntityComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UAIWorldEntityComponent();
+
+    // "enemy", "npc", "door", "item" 등 (적, NPC, 문 순으로 스냅샷에 먼저 들어감)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|World")
+    FString Kind = TEXT("object");
+
+    // 비어 있으면 액터 클래스 이름 (블루프린트 접두/접미사 제외)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|World")
+    FString DisplayName;
+
+    // "open", "locked, hostile" 등 (비어 있으면 생략)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI|World")
+    FString State;
+
+    UFUNCTION(BlueprintCallable, Category = "AI|World")
+    void SetState(const FString& InState) { State = InState; }
+
+    // 프롬프트에 표시할 이름
+    FString GetEntityName() const;
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+};
@@ -0,0 +1,262 @@
+#include "AIWorldState.h"
+#include "AIModelRoute.h"
+#include "Misc/Crc.h"
+
+namespace AIWorldStatePrivate
+{
+    // 거리 구간 (cm) 과 표시
+    static constexpr float DistanceBins[] = { 200.0f, 500.0f, 1000.0f, 2000.0f };
+    static const TCHAR* const DistanceLabels[] = { TEXT("2m"), TEXT("5m"), TEXT("10m"), TEXT("20m"), TEXT("far") };
+
+    static int32 GetDistanceBin(float Distance)
+    {
+        int32 Bin = 0;
+        while (Bin < static_cast<int32>(UE_ARRAY_COUNT(DistanceBins)) && Distance > DistanceBins[Bin])
+        {
+            Bin++;
+        }
+        return Bin;
+    }
+
+    static int32 GetBearingBin(float BearingDegrees)
+    {
+        const float Bearing = FRotator::NormalizeAxis(BearingDegrees);
+        if (FMath::Abs(Bearing) <= 45.0f)
+        {
+            return 0;
+        }
+        if (FMath::Abs(Bearing) >= 135.0f)
+        {
+            return 2;
+        }
+        return Bearing > 0.0f ? 1 : 3;
+    }
+
+    static const TCHAR* const BearingLabels[] = { TEXT("ahead"), TEXT("right"), TEXT("behind"), TEXT("left") };
+
+    static constexpr int32 LinePrefixTokens = 1;    // "\n- "
+}
+
+using namespace AIWorldStatePrivate;
+
+void FAIWorldStateEncoder::SetBudget(int32 InSnapshotTokens, int32 InDeltaTokens)
+{
+    SnapshotBudget = FMath::Max(InSnapshotTokens, 0);
+    DeltaBudget = FMath::Max(InDeltaTokens, 0);
+}
+
+FString FAIWorldStateEncoder::EncodeLine(const FAIWorldEntity& Entity)
+{
+    FString Line = Entity.Name.IsEmpty() ? Entity.Kind : Entity.Name;
+
+    // 이름에 종류가 드러나지 않을 때만 종류 표시
+    const bool bShowKind = !Entity.Name.IsEmpty() && !Entity.Name.Contains(Entity.Kind);
+    if (bShowKind || !Entity.State.IsEmpty())
+    {
+        Line += TEXT(" (");
+        Line += bShowKind ? Entity.Kind : FString();
+        Line += bShowKind && !Entity.State.IsEmpty() ? TEXT(", ") : TEXT("");
+        Line += Entity.State;
+        Line += TEXT(")");
+    }
+
+    if (Entity.Distance >= 0.0f)
+    {
+        Line += TEXT(" ");
+        Line += DistanceLabels[GetDistanceBin(Entity.Distance)];
+        Line += TEXT(" ");
+        Line += BearingLabels[GetBearingBin(Entity.BearingDegrees)];
+    }
+    return Line;
+}
+
+uint32 FAIWorldStateEncoder::MakeKey(const FAIWorldEntity& Entity)
+{
+    uint32 Key = FCrc::StrCrc32(*Entity.Kind);
+    Key = FCrc::StrCrc32(*Entity.Name, Key);
+    Key = FCrc::StrCrc32(*Entity.State, Key);
+    if (Entity.Distance >= 0.0f)
+    {
+        const int32 Bins[] = { GetDistanceBin(Entity.Distance), GetBearingBin(Entity.BearingDegrees) };
+        Key = FCrc::MemCrc32(Bins, sizeof(Bins), Key);
+    }
+    return Key;
+}
+
+int32 FAIWorldStateEncoder::GetPriority(const FAIWorldEntity& Entity)
+{
+    // 플레이어 자신, 적, NPC, 문, 나머지 순
+    static const TCHAR* const KindOrder[] = { TEXT("player"), TEXT("enemy"), TEXT("npc"), TEXT("door") };
+    for (int32 Index = 0; Index < static_cast<int32>(UE_ARRAY_COUNT(KindOrder)); Index++)
+    {
+        if (Entity.Kind.Equals(KindOrder[Index], ESearchCase::IgnoreCase))
+        {
+            return Index;
+        }
+    }
+    return static_cast<int32>(UE_ARRAY_COUNT(KindOrder));
+}
+
+int32 FAIWorldStateEncoder::CountTokens(const FString& Text) const
+{
+    return (Tokenizer ? Tokenizer->CountTokens(Text) : FAITokenUsage::EstimateTokens(Text)) + LinePrefixTokens;
+}
+
+int32 FAIWorldStateEncoder::Update(const TArray<FAIWorldEntity>& Entities)
+{
+    TMap<FName, FLine> NewLines;
+    NewLines.Reserve(Entities.Num());
+
+    int32 Changed = 0;
+    for (const FAIWorldEntity& Entity : Entities)
+    {
+        FLine& Line = NewLines.Add(Entity.Id);
+        Line.Key = MakeKey(Entity);
+        Line.Priority = GetPriority(Entity);
+        Line.Distance = FMath::Max(Entity.Distance, 0.0f);
+
+        // 양자화된 값이 같으면 직전 줄과 토큰 수 재사용
+        const FLine* Previous = Current.Find(Entity.Id);
+        if (Previous && Previous->Key == Line.Key)
+        {
+            Line.Text = Previous->Text;
+            Line.Label = Previous->Label;
+            Line.Tokens = Previous->Tokens;
+            continue;
+        }
+
+        Line.Text = EncodeLine(Entity);
+        Line.Label = Entity.Name.IsEmpty() ? Entity.Kind : Entity.Name;
+        Line.Tokens = CountTokens(Line.Text);
+        Changed++;
+    }
+
+    for (const TPair<FName, FLine>& Pair : Current)
+    {
+        if (!NewLines.Contains(Pair.Key))
+        {
+            Changed++;
+        }
+    }
+
+    Current = MoveTemp(NewLines);
+    Stats.Entities = Current.Num();
+    Stats.ChangedLastTurn = Changed;
+
+    if (Changed > 0 || !bHasKeyframe)
+    {
+        RebuildDelta();
+    }
+    return Changed;
+}
+
+TArray<FName> FAIWorldStateEncoder::GetSortedIds() const
+{
+    TArray<FName> Ids;
+    Current.GetKeys(Ids);
+    Ids.Sort([this](const FName& A, const FName& B)
+    {
+        const FLine& LineA = Current[A];
+        const FLine& LineB = Current[B];
+        if (LineA.Priority != LineB.Priority)
+        {
+            return LineA.Priority < LineB.Priority;
+        }
+        if (LineA.Distance != LineB.Distance)
+        {
+            return LineA.Distance < LineB.Distance;
+        }
+        return A.LexicalLess(B);
+    });
+    return Ids;
+}
+
+void FAIWorldStateEncoder::RebuildDelta()
+{
+    if (!bHasKeyframe)
+    {
+        RebuildKeyframe();
+        return;
+    }
+
+    // 키프레임 이후 바뀐 대상 (대상마다 최신 줄 하나)
+    TArray<const FString*> Lines;
+    TArray<FString> RemovedLines;
+    int32 Tokens = 0;
+    for (const FName& Id : GetSortedIds())
+    {
+        const FLine& Line = Current[Id];
+        const TPair<uint32, FString>* Known = Keyframe.Find(Id);
+        if (!Known || Known->Key != Line.Key)
+        {
+            Lines.Add(&Line.Text);
+            Tokens += Line.Tokens;
+        }
+    }
+    for (const TPair<FName, TPair<uint32, FString>>& Pair : Keyframe)
+    {
+        if (!Current.Contains(Pair.Key))
+        {
+            FString& Removed = RemovedLines.Add_GetRef(Pair.Value.Value + TEXT(": gone"));
+            Tokens += CountTokens(Removed);
+        }
+    }
+
+    // 변경분이 커지면 전체를 다시 (다음 턴부터 변경분은 다시 작게)
+    if (Tokens > DeltaBudget)
+    {
+        RebuildKeyframe();
+        return;
+    }
+
+    Delta.Reset();
+    if (Lines.Num() > 0 || RemovedLines.Num() > 0)
+    {
+        Delta = TEXT("Changes since then:");
+        for (const FString* Line : Lines)
+        {
+            Delta += TEXT("\n- ");
+            Delta += *Line;
+        }
+        for (const FString& Line : RemovedLines)
+        {
+            Delta += TEXT("\n- ");
+            Delta += Line;
+        }
+    }
+    Stats.DeltaTokens = Tokens;
+}
+
+void FAIWorldStateEncoder::RebuildKeyframe()
+{
+    Keyframe.Reset();
+    Snapshot.Reset();
+    Delta.Reset();
+
+    int32 Tokens = 0;
+    for (const FName& Id : GetSortedIds())
+    {
+        const FLine& Line = Current[Id];
+
+        // 예산을 넘는 대상은 빠지지만 키프레임에는 기록 (바뀌기 전까지는 변경분에도 나오지 않음)
+        Keyframe.Add(Id, TPair<uint32, FString>(Line.Key, Line.Label));
+        if (Tokens + Line.Tokens > SnapshotBudget)
+        {
+            continue;
+        }
+
+        if (Snapshot.IsEmpty())
+        {
+            Snapshot = TEXT("Surroundings:");
+        }
+        Snapshot += TEXT("\n- ");
+        Snapshot += Line.Text;
+        Tokens += Line.Tokens;
+    }
+
+    bHasKeyframe = true;
+    SnapshotVersion++;
+    Stats.Keyframes++;
+    Stats.SnapshotTokens = Tokens;
+    Stats.DeltaTokens = 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AITokenizer.h"
+#include "AIWorldState.generated.h"
+
+// 프롬프트에 넣을 주변 대상 하나 (게임 스레드에서 액터로 채움)
+struct FAIWorldEntity
+{
+    FName Id;                       // 턴 사이에 같은 대상인지 판별 (액터 이름)
+    FString Kind;                   // "player", "enemy", "npc", "door", "item" 등
+    FString Name;                   // 비어 있으면 Kind
+    FString State;                  // "open", "locked" 등 (쉼표로 구분, 비어 있으면 생략)
+    float Distance = -1.0f;         // 관찰자까지 거리 (cm, 음수면 위치 생략)
+    float BearingDegrees = 0.0f;    // 관찰자 정면 기준 방향 (-180~180, 오른쪽이 양수)
+};
+
+// 월드 상태 인코더 지표
+USTRUCT(BlueprintType)
+struct FAIWorldStateStats
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|World")
+    int32 Entities = 0;
+
+    // 직전 턴 이후 바뀐(추가, 제거 포함) 대상 수
+    UPROPERTY(BlueprintReadOnly, Category = "AI|World")
+    int32 ChangedLastTurn = 0;
+
+    // 전체 스냅샷을 다시 만든 횟수 (프롬프트 앞부분 캐시가 깨지는 횟수)
+    UPROPERTY(BlueprintReadOnly, Category = "AI|World")
+    int32 Keyframes = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|World")
+    int32 SnapshotTokens = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "AI|World")
+    int32 DeltaTokens = 0;
+};
+
+/**
+ * 주변 대상을 프롬프트용 짧은 텍스트로 유지하는 인코더 (게임 스레드 전용)
+ * 대상마다 한 줄("Goblin (enemy, hostile) 5m ahead")로 만들고, 거리와 방향은 구간으로 양자화해 조금 움직여도 바뀌지 않게 한다.
+ * 턴마다 직전 턴과 양자화된 값이 달라진 대상만 다시 인코딩하고 토큰을 센다.
+ * 프롬프트에는 가끔만 바뀌는 전체 스냅샷(키프레임)과, 키프레임 이후 바뀐 대상만 담은 변경분이 들어간다.
+ * 변경분이 토큰 예산을 넘으면 키프레임을 새로 만든다 (스냅샷 예산 안에서 가까운 적부터).
+ */
+class AI_DUNGEON_MASTER_API FAIWorldStateEncoder
+{
+public:
+    void SetBudget(int32 InSnapshotTokens, int32 InDeltaTokens);
+    void SetTokenizer(TSharedPtr<const FAITokenizer> InTokenizer) { Tokenizer = InTokenizer; }
+
+    // 이번 턴의 주변 대상으로 갱신 (바뀐 대상 수)
+    int32 Update(const TArray<FAIWorldEntity>& Entities);
+
+    const FString& GetSnapshot() const { return Snapshot; }
+    int32 GetSnapshotVersion() const { return SnapshotVersion; }
+    const FString& GetDelta() const { return Delta; }
+
+    FAIWorldStateStats GetStats() const { return Stats; }
+
+    static FString EncodeLine(const FAIWorldEntity& Entity);
+
+private:
+    struct FLine
+    {
+        uint32 Key = 0;         // 양자화된 입력 해시 (같으면 다시 인코딩하지 않음)
+        FString Text;
+        FString Label;          // 사라졌을 때 표시할 이름
+        int32 Tokens = 0;
+        int32 Priority = 0;     // 작을수록 먼저
+        float Distance = 0.0f;
+    };
+
+    static uint32 MakeKey(const FAIWorldEntity& Entity);
+    static int32 GetPriority(const FAIWorldEntity& Entity);
+    int32 CountTokens(const FString& Text) const;
+
+    // 우선순위(종류, 거리) 순서의 대상 목록
+    TArray<FName> GetSortedIds() const;
+
+    void RebuildDelta();
+    void RebuildKeyframe();
+
+    int32 SnapshotBudget = 150;
+    int32 DeltaBudget = 60;
+    TSharedPtr<const FAITokenizer> Tokenizer;
+
+    // 직전 턴 대상별 줄
+    TMap<FName, FLine> Current;
+
+    // 키프레임을 만들 때의 대상별 줄 키와 이름 (예산 때문에 빠진 대상 포함)
+    TMap<FName, TPair<uint32, FString>> Keyframe;
+    bool bHasKeyframe = false;
+
+    FString Snapshot;
+    int32 SnapshotVersion = 0;
+    FString Delta;
+
+    FAIWorldStateStats Stats;
+};
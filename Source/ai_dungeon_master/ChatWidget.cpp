@@ -7,6 +7,7 @@
 #include "Components/TextBlock.h"
 #include "Blueprint/UserWidget.h"
 #include "Engine/Engine.h"
+#include "AIDMLog.h"
 
 UChatWidget::UChatWidget(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -28,6 +29,7 @@ void UChatWidget::NativeConstruct()
 	if (MessageInputBox)
 	{
 		MessageInputBox->OnTextCommitted.AddDynamic(this, &UChatWidget::OnMessageInputCommitted);
+		MessageInputBox->OnTextChanged.AddDynamic(this, &UChatWidget::OnMessageInputChanged);
 	}
 
 	// Focus input box
@@ -48,6 +50,7 @@ void UChatWidget::NativeDestruct()
 	if (MessageInputBox)
 	{
 		MessageInputBox->OnTextCommitted.RemoveAll(this);
+		MessageInputBox->OnTextChanged.RemoveAll(this);
 	}
 
 	Super::NativeDestruct();
@@ -66,6 +69,11 @@ void UChatWidget::OnMessageInputCommitted(const FText& Text, ETextCommit::Type C
 	}
 }
 
+void UChatWidget::OnMessageInputChanged(const FText& Text)
+{
+	OnMessageTyping.Broadcast(Text.ToString());
+}
+
 void UChatWidget::SendCurrentMessage()
 {
 	if (!MessageInputBox)
@@ -73,6 +81,10 @@ void UChatWidget::SendCurrentMessage()
 		return;
 	}
 
+	// Start the latency trace at submit time
+	PendingTrace = FAIRequestTrace();
+	PendingTrace.Mark(EAITraceStage::ChatSubmit);
+
 	FString Message = MessageInputBox->GetText().ToString().TrimStartAndEnd();
 
 	if (Message.IsEmpty())
@@ -93,6 +105,13 @@ void UChatWidget::SendCurrentMessage()
 	FocusInputBox();
 }
 
+FAIRequestTrace UChatWidget::ConsumePendingTrace()
+{
+	FAIRequestTrace Trace = PendingTrace;
+	PendingTrace = FAIRequestTrace();
+	return Trace;
+}
+
 void UChatWidget::AddUserMessage(const FString& Message)
 {
 	AddChatMessage(Message, TEXT("You"), FLinearColor::Blue);
@@ -118,7 +137,7 @@ void UChatWidget::AddChatMessage(const FString& Message, const FString& SenderNa
 {
 	if (!ChatScrollBox)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("ChatScrollBox is null"));
+		UE_LOG(LogAIDM, Warning, TEXT("ChatScrollBox is null"));
 		return;
 	}
 
@@ -171,8 +190,8 @@ void UChatWidget::AddChatMessage(const FString& Message, const FString& SenderNa
 	// Scroll to bottom
 	ScrollToBottom();
 
-	// Debug output
-	UE_LOG(LogTemp, Log, TEXT("Chat: [%s] %s"), *SenderName, *Message);
+	// Debug output (formatted off the game thread, compiled out when Verbose is stripped)
+	AIDM_EVENT(Verbose, "ChatMessage", AIDM_FIELD("sender", SenderName), AIDM_FIELD("text", Message));
 }
 
 void UChatWidget::ClearChat()
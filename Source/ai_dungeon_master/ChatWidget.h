@@ -8,9 +8,11 @@
 #include "Components/EditableTextBox.h"
 #include "Components/TextBlock.h"
 #include "Components/Button.h"
+#include "AIRequestTrace.h"
 #include "ChatWidget.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMessageSent, const FString&, Message);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMessageTyping, const FString&, PartialText);
 
 /**
  * Chat UI Widget for AI Dungeon Master
@@ -44,6 +46,10 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Chat")
 	FOnMessageSent OnMessageSent;
 
+	// Fired as the player edits the input box (before the message is sent)
+	UPROPERTY(BlueprintAssignable, Category = "Chat")
+	FOnMessageTyping OnMessageTyping;
+
 	// Public functions
 	UFUNCTION(BlueprintCallable, Category = "Chat")
 	void AddUserMessage(const FString& Message);
@@ -60,6 +66,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Chat")
 	void FocusInputBox();
 
+	// Latency trace started by the last submitted message (consumed by the listener that sends it)
+	FAIRequestTrace ConsumePendingTrace();
+
 protected:
 	virtual void NativeConstruct() override;
 	virtual void NativeDestruct() override;
@@ -71,6 +80,9 @@ protected:
 	UFUNCTION()
 	void OnMessageInputCommitted(const FText& Text, ETextCommit::Type CommitMethod);
 
+	UFUNCTION()
+	void OnMessageInputChanged(const FText& Text);
+
 	// Helper functions
 	void SendCurrentMessage();
 	void AddChatMessage(const FString& Message, const FString& SenderName, const FLinearColor& Color);
@@ -80,4 +92,7 @@ private:
 	// Chat history
 	TArray<FString> ChatHistory;
 	static const int32 MaxChatHistory = 100;
+
+	// Trace for the message currently being broadcast
+	FAIRequestTrace PendingTrace;
 };
\ No newline at end of file
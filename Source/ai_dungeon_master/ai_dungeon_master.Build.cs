@@ -1,4 +1,5 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
+using System.IO;
 using UnrealBuildTool;
 
 public class ai_dungeon_master : ModuleRules
@@ -44,5 +45,22 @@ public class ai_dungeon_master : ModuleRules
 
         // JSON  Ȱȭ  
         PublicDefinitions.Add("WITH_JSON=1");
+
+        //  CPU ߷ (ThirdParty/llama llama.cpp  ̺귯  )
+        string LlamaPath = Path.Combine(ModuleDirectory, "..", "..", "ThirdParty", "llama");
+        string LlamaLibPath = Path.Combine(LlamaPath, "lib", Target.Platform.ToString());
+        if (File.Exists(Path.Combine(LlamaPath, "include", "llama.h")) && Directory.Exists(LlamaLibPath))
+        {
+            PublicSystemIncludePaths.Add(Path.Combine(LlamaPath, "include"));
+            foreach (string Library in Directory.GetFiles(LlamaLibPath, Target.Platform == UnrealTargetPlatform.Win64 ? "*.lib" : "*.a"))
+            {
+                PublicAdditionalLibraries.Add(Library);
+            }
+            PublicDefinitions.Add("WITH_LLAMA_CPP=1");
+        }
+        else
+        {
+            PublicDefinitions.Add("WITH_LLAMA_CPP=0");
+        }
     }
 }
\ No newline at end of file
@@ -1,7 +1,21 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ai_dungeon_master.h"
+#include "AIDMLog.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ai_dungeon_master, "ai_dungeon_master" );
- 
\ No newline at end of file
+class FAIDungeonMasterModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		FAIDMLogSink::Get().Start();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FAIDMLogSink::Get().Stop();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FAIDungeonMasterModule, ai_dungeon_master, "ai_dungeon_master" );
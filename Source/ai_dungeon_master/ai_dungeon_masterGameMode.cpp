@@ -1,29 +1,17 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ai_dungeon_masterGameMode.h"
+#include "AIManager.h"
+#include "AIDMSubsystem.h"
 
 Aai_dungeon_masterGameMode::Aai_dungeon_masterGameMode()
 {
-	AIManager = nullptr;
-}
-
-void Aai_dungeon_masterGameMode::BeginPlay()
-{
-	Super::BeginPlay();
-	
-	// AI Manager 생성
-	if (!AIManager)
-	{
-		AIManager = GetWorld()->SpawnActor<AAIManager>();
-		if (AIManager)
-		{
-			UE_LOG(LogTemp, Log, TEXT("GameMode에서 AI Manager 생성 완료"));
-		}
-	}
 }
 
 void Aai_dungeon_masterGameMode::TestActionParser(const FString& Input)
 {
+	// AI Manager는 UAIDMSubsystem이 월드 로딩 중에 생성
+	AAIManager* AIManager = UAIDMSubsystem::GetAIManager(this);
 	if (AIManager)
 	{
 		UE_LOG(LogTemp, Log, TEXT("GameMode 테스트 명령어 실행: %s"), *Input);
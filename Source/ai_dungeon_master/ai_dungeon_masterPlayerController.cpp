@@ -6,7 +6,7 @@
 #include "Engine/LocalPlayer.h"
 #include "InputMappingContext.h"
 #include "Engine/World.h"
-#include "EngineUtils.h"
+#include "AIDMSubsystem.h"
 
 void Aai_dungeon_masterPlayerController::SetupInputComponent()
 {
@@ -41,13 +41,5 @@ void Aai_dungeon_masterPlayerController::TestParser(const FString& Input)
 
 AAIManager* Aai_dungeon_masterPlayerController::GetAIManager()
 {
-	if (UWorld* World = GetWorld())
-	{
-		// 월드에서 AI Manager 찾기
-		for (TActorIterator<AAIManager> ActorItr(World); ActorItr; ++ActorItr)
-		{
-			return *ActorItr;
-		}
-	}
-	return nullptr;
+	return UAIDMSubsystem::GetAIManager(this);
 }